@@ -3,6 +3,7 @@
 
 #include "GameObject.h"
 #include "BehaviourTree/BehaviourTree.h"
+#include "Pathfinding/FlowField/FlowField.h"
 
 struct WorldState
 {
@@ -22,6 +23,10 @@ class AIEntity : public GameObject
 	int pathIndex{ -1 };
 	std::vector<MathGeom::Vector3> path;
 
+	// flow field (followed instead of the path while set)
+	std::shared_ptr<const FlowField> flowField;
+	MathGeom::Vector3 flowFieldGoal;
+
 public:
 
 	// Constructor
@@ -50,6 +55,15 @@ public:
 	{
 		path = newPath;
 		pathIndex = path.size() > 0 ? 0 : -1;
+		flowField = nullptr;
+	}
+
+	// Set flow field (steer from the field until the goal is reached)
+	void SetFlowField(std::shared_ptr<const FlowField> newFlowField, const MathGeom::Vector3& goal)
+	{
+		flowField = newFlowField;
+		flowFieldGoal = goal;
+		pathIndex = -1;
 	}
 
 
@@ -58,6 +72,12 @@ private:
 	// Follow path
 	void FollowPath()
 	{
+		if (flowField)
+		{
+			FollowFlowField();
+			return;
+		}
+
 		if (pathIndex == -1)
 		{
 			// no path
@@ -94,6 +114,35 @@ private:
 		MathGeom::Vector3 steering = desiredVelocity - Velocity();
 		AddForce(steering);
 	}
+
+	// Follow flow field
+	void FollowFlowField()
+	{
+		auto& currentPos = transform.position;
+
+		// check if we reach the goal (or the goal can not be reached from here)
+		const float DISTANCE_TO_TARGET = 5.0f;
+		MathGeom::Vector3 direction = flowField->GetDirection(currentPos);
+		if (MathGeom::Distance(currentPos, flowFieldGoal) < DISTANCE_TO_TARGET || MathGeom::Dot(direction, direction) == 0.0f)
+		{
+			flowField = nullptr;
+			SetStationary(true);
+			return;
+		}
+
+		// make sure the object is not stationary
+		SetStationary(false);
+
+		// calculate and add steering force along the field (straight to the goal once in its cell)
+		if (flowField->GetNode(currentPos) == flowField->GetGoal())
+		{
+			direction = MathGeom::Normalise(flowFieldGoal - currentPos);
+		}
+
+		MathGeom::Vector3 desiredVelocity = direction * 12.0f;
+		MathGeom::Vector3 steering = desiredVelocity - Velocity();
+		AddForce(steering);
+	}
 	
 };
 
@@ -0,0 +1,116 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+#include "../PathNode.h"
+
+// integration of a cell that can not reach the goal
+static const float FLOW_FIELD_UNREACHABLE = std::numeric_limits<float>::infinity();
+
+// direction of the goal cell and of the cells that can not reach the goal
+static const uint8_t FLOW_FIELD_NO_DIRECTION = 0xFF;
+
+// Flow field towards a goal over a grid.
+// It keeps, per cell, the cost to reach the goal (integration field) and the PathNodeAdjacency of the
+// next cell on a shortest path (direction field, one byte per cell), so any number of agents can be steered
+// to the goal by sampling it at their position. It is read only once built and can be shared between agents.
+class FlowField
+{
+	friend class FlowFieldBuilder;
+
+	// grid layout
+	MathGeom::Vector3 anchorPosition;
+	float cellSize{ 1.0f };
+	int width{ 0 };
+	int height{ 0 };
+
+	// goal
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+	MathGeom::Vector3 goalPosition;
+
+	// integration field (cost to the goal of each cell, z * width + x)
+	std::vector<float> integration;
+
+	// direction field (PathNodeAdjacency of the next cell of each cell, z * width + x)
+	std::vector<uint8_t> directions;
+
+public:
+
+	// Get goal
+	PathNodeId GetGoal() const { return goal; }
+
+	// Get goal position
+	const MathGeom::Vector3& GetGoalPosition() const { return goalPosition; }
+
+	// Get size
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+
+	// Get node (INVALID_PATH_NODE_ID if the position is outside the grid)
+	PathNodeId GetNode(const MathGeom::Vector3& position) const
+	{
+		MathGeom::Vector3 anchorToPos = (position - anchorPosition) / cellSize;
+		int x = int(anchorToPos.x);
+		int z = int(anchorToPos.z);
+
+		if (anchorToPos.x < 0 || anchorToPos.z < 0 || x >= width || z >= height)
+		{
+			return INVALID_PATH_NODE_ID;
+		}
+
+		return PathNodeId(z * width + x);
+	}
+
+	// Get integration (FLOW_FIELD_UNREACHABLE outside the grid)
+	float GetIntegration(PathNodeId node) const { return node != INVALID_PATH_NODE_ID ? integration[node] : FLOW_FIELD_UNREACHABLE; }
+	float GetIntegration(const MathGeom::Vector3& position) const { return GetIntegration(GetNode(position)); }
+
+	// Is reachable (the goal can be reached from the position)
+	bool IsReachable(const MathGeom::Vector3& position) const { return GetIntegration(position) != FLOW_FIELD_UNREACHABLE; }
+
+	// Get next node (INVALID_PATH_NODE_ID at the goal and where the goal can not be reached)
+	PathNodeId GetNextNode(PathNodeId node) const
+	{
+		if (node == INVALID_PATH_NODE_ID || directions[node] == FLOW_FIELD_NO_DIRECTION)
+		{
+			return INVALID_PATH_NODE_ID;
+		}
+
+		int direction = directions[node];
+		return PathNodeId(node + GRID_ADJACENCY_OFFSET_Z[direction] * width + GRID_ADJACENCY_OFFSET_X[direction]);
+	}
+
+	// Get direction (unit vector from the position to the centre of the next cell, or to the goal position
+	// from the goal cell, zero where the goal can not be reached)
+	MathGeom::Vector3 GetDirection(const MathGeom::Vector3& position) const
+	{
+		PathNodeId node = GetNode(position);
+		if (GetIntegration(node) == FLOW_FIELD_UNREACHABLE)
+		{
+			return MathGeom::Vector3(0.0f);
+		}
+
+		PathNodeId next = GetNextNode(node);
+		MathGeom::Vector3 target = next != INVALID_PATH_NODE_ID ? GetNodePosition(next) : goalPosition;
+		MathGeom::Vector3 toTarget = target - position;
+		toTarget.y = 0.0f;
+
+		float distance = glm::length(toTarget);
+		return distance > 0.0f ? toTarget / distance : MathGeom::Vector3(0.0f);
+	}
+
+	// Get node position (centre of the cell)
+	MathGeom::Vector3 GetNodePosition(PathNodeId node) const
+	{
+		float halfCellSize = cellSize * 0.5f;
+		return MathGeom::Vector3(anchorPosition.x + (node % width) * cellSize + halfCellSize, anchorPosition.y, anchorPosition.z + (node / width) * cellSize + halfCellSize);
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return sizeof(FlowField) + integration.size() * sizeof(float) + directions.size() * sizeof(uint8_t); }
+};
+
+#endif // !FLOW_FIELD_H
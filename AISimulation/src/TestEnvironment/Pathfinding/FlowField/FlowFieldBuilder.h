@@ -0,0 +1,254 @@
+#ifndef FLOW_FIELD_BUILDER_H
+#define FLOW_FIELD_BUILDER_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include "FlowField.h"
+#include "../SearchSpace/GridSearchSpace.h"
+
+// Flow field builder.
+// The integration field is computed with a wavefront of raster sweeps over a padded copy of the grid: each sweep
+// relaxes a whole row from the row before it (straight and diagonal moves, no branches, so the compiler can vectorise it)
+// and then along the row itself, going down the grid and then back up. Sweeps are repeated until no cost changes,
+// which leaves the octile shortest distance to the goal in every cell (obstacles only add sweeps).
+// With cell costs, each move is scaled by the mean multiplier of both cells (see CellCostTable), read from a padded
+// copy of the multipliers; grids without costs keep the sweeps that never read it.
+// The direction of each cell is then the neighbour that continues its shortest path.
+class FlowFieldBuilder
+{
+	// padded grid (one blocked cell around the grid, so neighbours never need bounds checks)
+	size_t paddedWidth{ 0 };
+	size_t paddedHeight{ 0 };
+
+	// walkable cells and costs of the padded grid
+	std::vector<uint8_t> walkable;
+	std::vector<float> costs;
+
+	// half the cell multiplier of the padded grid (only with cell costs, a move costs its length times the sum of both halves)
+	std::vector<float> halfMultipliers;
+
+	// sweeps run by the last build
+	size_t sweeps{ 0 };
+
+public:
+
+	// Build (goal must be a walkable cell of the grid)
+	void Build(const GridSearchSpace& grid, PathNodeId goal, FlowField& flowField)
+	{
+		assert(grid.IsWalkable(goal));
+
+		int width = int(grid.GetTotalCellsX());
+		int height = int(grid.GetTotalCellsZ());
+		float straightCost = grid.GetCellSize();
+		float diagonalCost = grid.GetCellSize() * std::sqrt(2.0f);
+
+		// padded grid
+		paddedWidth = width + 2;
+		paddedHeight = height + 2;
+		walkable.assign(paddedWidth * paddedHeight, 0);
+		costs.assign(paddedWidth * paddedHeight, FLOW_FIELD_UNREACHABLE);
+
+		const GridBitmap& walkableRows = grid.GetWalkableRows();
+		for (int z = 0; z < height; z++)
+		{
+			uint8_t* row = &walkable[(z + 1) * paddedWidth + 1];
+			for (int x = 0; x < width; x++)
+			{
+				row[x] = walkableRows.Get(x, z) ? 1 : 0;
+			}
+		}
+
+		costs[GetPaddedIndex(grid.GetCellX(goal), grid.GetCellZ(goal))] = 0.0f;
+
+		const CellCostTable* cellCosts = grid.GetCellCosts();
+		bool withCellCosts = cellCosts->HasCosts();
+		if (withCellCosts)
+		{
+			halfMultipliers.assign(paddedWidth * paddedHeight, 0.5f);
+			for (int z = 0; z < height; z++)
+			{
+				float* row = &halfMultipliers[GetPaddedIndex(0, z)];
+				for (int x = 0; x < width; x++)
+				{
+					row[x] = 0.5f * cellCosts->GetCellMultiplier(grid.GetNodeId(x, z));
+				}
+			}
+		}
+
+		// sweep down and up until the costs settle
+		sweeps = withCellCosts ? Sweep<true>(height, straightCost, diagonalCost) : Sweep<false>(height, straightCost, diagonalCost);
+
+		// flow field
+		flowField.anchorPosition = grid.GetAnchorPosition();
+		flowField.cellSize = grid.GetCellSize();
+		flowField.width = width;
+		flowField.height = height;
+		flowField.goal = goal;
+		flowField.goalPosition = grid.GetNodePosition(goal);
+
+		flowField.integration.resize(size_t(width) * height);
+		flowField.directions.resize(size_t(width) * height);
+
+		for (int z = 0; z < height; z++)
+		{
+			std::copy_n(&costs[GetPaddedIndex(0, z)], width, &flowField.integration[size_t(z) * width]);
+
+			for (int x = 0; x < width; x++)
+			{
+				size_t index = GetPaddedIndex(x, z);
+				flowField.directions[size_t(z) * width + x] = withCellCosts ? GetDirection<true>(index, straightCost, diagonalCost) : GetDirection<false>(index, straightCost, diagonalCost);
+			}
+		}
+	}
+
+	// Get sweeps (row sweeps of the last build)
+	size_t GetSweeps() const { return sweeps; }
+
+private:
+
+	// Get padded index
+	size_t GetPaddedIndex(size_t x, size_t z) const { return (z + 1) * paddedWidth + x + 1; }
+
+	// Sweep down and up until the costs settle (returns the row sweeps run)
+	template<bool WithCellCosts>
+	size_t Sweep(int height, float straightCost, float diagonalCost)
+	{
+		size_t rowSweeps = 0;
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+
+			for (size_t row = 1; row <= size_t(height); row++)
+			{
+				changed |= RelaxRow<WithCellCosts>(row, row - 1, straightCost, diagonalCost);
+			}
+
+			for (size_t row = size_t(height); row >= 1; row--)
+			{
+				changed |= RelaxRow<WithCellCosts>(row, row + 1, straightCost, diagonalCost);
+			}
+
+			rowSweeps += 2;
+		}
+
+		return rowSweeps;
+	}
+
+	// Get move scale (of the move between two padded cells, 1 without cell costs)
+	template<bool WithCellCosts>
+	float GetMoveScale(size_t indexA, size_t indexB) const
+	{
+		return WithCellCosts ? halfMultipliers[indexA] + halfMultipliers[indexB] : 1.0f;
+	}
+
+	// Relax row (from the previous row of the sweep and then along the row, true if any cost decreased)
+	template<bool WithCellCosts>
+	bool RelaxRow(size_t row, size_t previousRow, float straightCost, float diagonalCost)
+	{
+		const int width = int(paddedWidth) - 2;
+
+		float* __restrict cost = &costs[row * paddedWidth + 1];
+		const float* __restrict previousCost = &costs[previousRow * paddedWidth + 1];
+		const uint8_t* __restrict walk = &walkable[row * paddedWidth + 1];
+		const uint8_t* __restrict previousWalk = &walkable[previousRow * paddedWidth + 1];
+
+		// cell multipliers (not read without cell costs)
+		const float* __restrict half = WithCellCosts ? &halfMultipliers[row * paddedWidth + 1] : nullptr;
+		const float* __restrict previousHalf = WithCellCosts ? &halfMultipliers[previousRow * paddedWidth + 1] : nullptr;
+
+		// from the previous row (a diagonal move is only blocked when both straight cells next to it are blocked).
+		// Blocked moves add an infinite penalty instead of branching, so the loop can be vectorised
+		int changed = 0;
+		for (int x = 0; x < width; x++)
+		{
+			float straightScale = WithCellCosts ? half[x] + previousHalf[x] : 1.0f;
+			float diagonalLeftScale = WithCellCosts ? half[x] + previousHalf[x - 1] : 1.0f;
+			float diagonalRightScale = WithCellCosts ? half[x] + previousHalf[x + 1] : 1.0f;
+
+			float straight = previousCost[x] + straightCost * straightScale;
+			float diagonalLeft = previousCost[x - 1] + diagonalCost * diagonalLeftScale + ((walk[x - 1] | previousWalk[x]) ? 0.0f : FLOW_FIELD_UNREACHABLE);
+			float diagonalRight = previousCost[x + 1] + diagonalCost * diagonalRightScale + ((walk[x + 1] | previousWalk[x]) ? 0.0f : FLOW_FIELD_UNREACHABLE);
+
+			float best = std::min(straight, std::min(diagonalLeft, diagonalRight)) + (walk[x] ? 0.0f : FLOW_FIELD_UNREACHABLE);
+
+			float current = cost[x];
+			changed |= best < current;
+			cost[x] = std::min(current, best);
+		}
+
+		// along the row, both ways
+		for (int x = 0; x < width; x++)
+		{
+			float fromLeft = cost[x - 1] + straightCost * (WithCellCosts ? half[x - 1] + half[x] : 1.0f);
+			if (walk[x] && fromLeft < cost[x])
+			{
+				cost[x] = fromLeft;
+				changed = 1;
+			}
+		}
+
+		for (int x = width - 1; x >= 0; x--)
+		{
+			float fromRight = cost[x + 1] + straightCost * (WithCellCosts ? half[x + 1] + half[x] : 1.0f);
+			if (walk[x] && fromRight < cost[x])
+			{
+				cost[x] = fromRight;
+				changed = 1;
+			}
+		}
+
+		return changed != 0;
+	}
+
+	// Get direction (neighbour that continues the shortest path of the cell)
+	template<bool WithCellCosts>
+	uint8_t GetDirection(size_t index, float straightCost, float diagonalCost) const
+	{
+		float cost = costs[index];
+		if (cost == 0.0f || cost == FLOW_FIELD_UNREACHABLE)
+		{
+			// goal or unreachable
+			return FLOW_FIELD_NO_DIRECTION;
+		}
+
+		uint8_t direction = FLOW_FIELD_NO_DIRECTION;
+		float bestCost = cost;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			int dx = GRID_ADJACENCY_OFFSET_X[adjacency];
+			int dz = GRID_ADJACENCY_OFFSET_Z[adjacency];
+			size_t neighbour = index + dz * int(paddedWidth) + dx;
+
+			float neighbourCost;
+			if (dx != 0 && dz != 0)
+			{
+				// a diagonal move is only blocked when both straight cells next to it are blocked
+				if (!walkable[index + dx] && !walkable[index + dz * int(paddedWidth)])
+				{
+					continue;
+				}
+
+				neighbourCost = costs[neighbour] + diagonalCost * GetMoveScale<WithCellCosts>(index, neighbour);
+			}
+			else
+			{
+				neighbourCost = costs[neighbour] + straightCost * GetMoveScale<WithCellCosts>(index, neighbour);
+			}
+
+			// the neighbour has to be closer to the goal, so following directions always ends at the goal
+			if (costs[neighbour] < cost && (direction == FLOW_FIELD_NO_DIRECTION || neighbourCost < bestCost))
+			{
+				direction = uint8_t(adjacency);
+				bestCost = neighbourCost;
+			}
+		}
+
+		return direction;
+	}
+};
+
+#endif // !FLOW_FIELD_BUILDER_H
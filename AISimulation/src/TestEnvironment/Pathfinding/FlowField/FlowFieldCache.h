@@ -0,0 +1,150 @@
+#ifndef FLOW_FIELD_CACHE_H
+#define FLOW_FIELD_CACHE_H
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "FlowField.h"
+#include "FlowFieldBuilder.h"
+
+// default memory the cached flow fields can take (bytes)
+static const size_t DEFAULT_FLOW_FIELD_CACHE_MEMORY_CAP = 4 << 20;
+
+// Flow field cache stats
+struct FlowFieldCacheStats
+{
+	size_t hits{ 0 };
+	size_t misses{ 0 };
+
+	// fields evicted to stay under the memory cap
+	size_t evictions{ 0 };
+
+	// times the cache was emptied because the search space changed
+	size_t invalidations{ 0 };
+
+	// Get hit rate
+	float GetHitRate() const { return hits + misses > 0 ? float(hits) / float(hits + misses) : 0.0f; }
+};
+
+// Cache of flow fields keyed by their goal node.
+// Fields are built on a miss, least recently used ones are evicted to stay under the memory cap and all of them
+// are dropped as soon as the search space version changes. Evicted fields stay alive while agents still hold them.
+class FlowFieldCache
+{
+	// Entry
+	struct Entry
+	{
+		PathNodeId goal;
+		std::shared_ptr<const FlowField> flowField;
+	};
+
+	// entries (most recently used first)
+	std::list<Entry> entries;
+
+	// index to find an entry in O(1)
+	std::unordered_map<PathNodeId, std::list<Entry>::iterator> index;
+
+	// search space version of the entries
+	size_t version{ 0 };
+
+	// memory
+	size_t memoryUsage{ 0 };
+	size_t memoryCap{ DEFAULT_FLOW_FIELD_CACHE_MEMORY_CAP };
+
+	// builder
+	FlowFieldBuilder builder;
+
+	// stats
+	FlowFieldCacheStats stats;
+
+public:
+
+	// Get (the cached field of the goal, built if there is none for the grid version)
+	std::shared_ptr<const FlowField> Get(const GridSearchSpace& grid, PathNodeId goal)
+	{
+		SetVersion(grid.GetVersion());
+
+		auto entryIt = index.find(goal);
+		if (entryIt != index.end())
+		{
+			// most recently used
+			entries.splice(entries.begin(), entries, entryIt->second);
+
+			stats.hits++;
+			return entryIt->second->flowField;
+		}
+
+		stats.misses++;
+
+		auto flowField = std::make_shared<FlowField>();
+		builder.Build(grid, goal, *flowField);
+
+		if (flowField->GetMemoryUsage() <= memoryCap)
+		{
+			entries.push_front({ goal, flowField });
+			index[goal] = entries.begin();
+			memoryUsage += flowField->GetMemoryUsage();
+
+			Evict();
+		}
+
+		return flowField;
+	}
+
+	// Clear
+	void Clear()
+	{
+		entries.clear();
+		index.clear();
+		memoryUsage = 0;
+	}
+
+	// Set memory cap (bytes, 0 disables the cache)
+	void SetMemoryCap(size_t cap)
+	{
+		memoryCap = cap;
+		Evict();
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return memoryUsage; }
+
+	// Get size
+	size_t Size() const { return entries.size(); }
+
+	// Get stats
+	const FlowFieldCacheStats& GetStats() const { return stats; }
+
+private:
+
+	// Set version (entries of another version are dropped)
+	void SetVersion(size_t searchSpaceVersion)
+	{
+		if (searchSpaceVersion != version)
+		{
+			if (!entries.empty())
+			{
+				stats.invalidations++;
+			}
+
+			Clear();
+			version = searchSpaceVersion;
+		}
+	}
+
+	// Evict (least recently used entries until the memory cap is met)
+	void Evict()
+	{
+		while (memoryUsage > memoryCap && !entries.empty())
+		{
+			Entry& entry = entries.back();
+			memoryUsage -= entry.flowField->GetMemoryUsage();
+			index.erase(entry.goal);
+			entries.pop_back();
+			stats.evictions++;
+		}
+	}
+};
+
+#endif // !FLOW_FIELD_CACHE_H
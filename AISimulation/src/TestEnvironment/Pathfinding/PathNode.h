@@ -2,8 +2,15 @@
 #define PATH_NODE_H
 
 #include <array>
+#include <cstdint>
 
-#include "../Render/Renderable.h"
+#include "../MathGeom.h"
+
+// PathNodeId (index of a node in its search space)
+using PathNodeId = uint32_t;
+
+// id of a node that does not exist (outside the search space)
+static const PathNodeId INVALID_PATH_NODE_ID = UINT32_MAX;
 
 // PathNodeType
 enum class PathNodeType
@@ -27,7 +34,17 @@ enum class PathNodeAdjacency
 	MAX_ADJACENCY
 };
 
-// PathNode
+// cell offsets of each PathNodeAdjacency on grids (TOP is -z)
+static const int GRID_ADJACENCY_OFFSET_X[(int)PathNodeAdjacency::MAX_ADJACENCY] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+static const int GRID_ADJACENCY_OFFSET_Z[(int)PathNodeAdjacency::MAX_ADJACENCY] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+
+// links of a node to nodes that are not adjacent to it (e.g. stairs to another layer)
+static const int MAX_PATH_NODE_LINKS = 2;
+
+// neighbours of a node (one per PathNodeAdjacency, then its links)
+using PathNodeNeighbours = std::array<PathNodeId, (int)PathNodeAdjacency::MAX_ADJACENCY + MAX_PATH_NODE_LINKS>;
+
+// PathNode (node storage of the search spaces that keep explicit nodes)
 struct PathNode
 {
 	// Constructors
@@ -50,17 +67,6 @@ struct PathNode
 	// type
 	PathNodeType type { PathNodeType::UNBLOCKED };
 
-	// costs
-	float hCost{ 0.0f };
-	float gCost{ 0.0f };
-	float fCost{ 0.0f };
-
-	// parent node
-	PathNode* parent{ nullptr };
-
-	// for JPS
-	bool isForced { false };
-
 private:
 
 	void Init()
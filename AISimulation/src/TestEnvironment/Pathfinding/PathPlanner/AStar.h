@@ -1,36 +1,50 @@
 #ifndef A_STAR_H
 #define A_STAR_H
 
+#include <type_traits>
+
 #include "OpenClosePathPlanner.h"
 
-class AStar : public OpenClosePathPlanner
+// A* with its heuristic and edge cost policies (see PathPlannerPolicies.h)
+template<class Heuristic = OctileHeuristic, class EdgeCost = OctileEdgeCost>
+class AStarPlanner : public OpenClosePathPlanner
 {
+	// policies
+	Heuristic heuristic;
+	EdgeCost edgeCost;
+
 public:
 
 	// Constructors
-	AStar(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace) 
+	AStarPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic_ = Heuristic(), const EdgeCost& edgeCost_ = EdgeCost())
 		: OpenClosePathPlanner(data, searchSpace)
+		, heuristic(heuristic_)
+		, edgeCost(edgeCost_)
 	{
 	}
 
+	// Finds shortest paths (with an admissible heuristic and octile edge costs)
+	bool FindsShortestPaths() const final { return Heuristic::ADMISSIBLE && std::is_same<EdgeCost, OctileEdgeCost>::value; }
+
 private:
 
 	// Expand
-	void Expand(PathNode* current) final
+	void Expand(PathNodeId current) final
 	{
 		// Update cost for each valid neighbour
-		for (auto neighbour : current->neighbours)
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
 		{
-			if (!searchSpace->IsValidAdjacency(current, neighbour))
-				continue;
-
-			UpdateCost(current, neighbour);
+			UpdateCost(current, neighbours[i], heuristic, edgeCost);
 		}
 
 		// push current in close
-		close.push_back(current);
+		Close(current);
 	}
 };
 
-#endif // !A_STAR_H
+// A* (octile heuristic and edge costs, shortest paths on grids)
+using AStar = AStarPlanner<>;
 
+#endif // !A_STAR_H
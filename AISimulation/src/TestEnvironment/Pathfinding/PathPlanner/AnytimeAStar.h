@@ -0,0 +1,349 @@
+#ifndef ANYTIME_A_STAR_H
+#define ANYTIME_A_STAR_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+
+// Anytime A* (ARA*).
+// The first search runs with a high heuristic weight, so a path (at most weight times longer than the shortest one)
+// is found after few expansions. Then the weight is lowered step by step and each search reuses the costs of the
+// previous ones: only the nodes whose cost decreased after they were closed (inconsistent nodes) are opened again.
+// Every search that ends with a path makes it available through GetImprovedPath, and the search is completed once
+// the weight is 1, which leaves the shortest path (the octile heuristic is consistent).
+class AnytimeAStar : public PathPlanner
+{
+	// open list (ordered by gCost + weight * hCost)
+	PathNodeHeap open;
+
+	// per-search node states (costs are kept between the searches of the same request)
+	PathNodeSearchStates nodeStates;
+
+	// closed by the current search (opened again by the next one if their cost decreases)
+	std::vector<PathNodeId> closedNodes;
+
+	// closed nodes whose cost decreased (inconsistent, opened by the next search)
+	std::vector<PathNodeId> inconsistentNodes;
+
+	// start/goal nodes
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+	MathGeom::Vector3 goalPosition;
+
+	// weights
+	float initialWeight{ DEFAULT_ANYTIME_INITIAL_WEIGHT };
+	float weightStep{ DEFAULT_ANYTIME_WEIGHT_STEP };
+	float weight{ 1.0f };
+
+	// a search ended with a path not taken by GetImprovedPath yet
+	bool improvedPath{ false };
+
+	// the current search ended and the next one has not started
+	bool searchEnded{ false };
+
+	// policies
+	OctileHeuristic heuristic;
+	OctileEdgeCost edgeCost;
+
+public:
+
+	// Constructor
+	AnytimeAStar(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
+		: PathPlanner(data, searchSpace)
+		, initialWeight(std::max(data.anytimeInitialWeight, 1.0f))
+		, weightStep(std::max(data.anytimeWeightStep, 0.01f))
+		, edgeCost(searchSpace->GetCellCosts())
+	{
+		// size node states up front (pages are allocated as the searches reach them)
+		nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Start search
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
+	{
+		// reset
+		Reset();
+
+		// set start/goal
+		this->start = start;
+		this->goal = goal;
+		goalPosition = searchSpace->GetNodePosition(goal);
+
+		weight = initialWeight;
+
+		// init open list
+		PathNodeSearchState& startState = GetState(start);
+		startState.gCost = 0.0f;
+		Open(start, startState);
+
+		// search
+		return Search();
+	}
+
+	// Resume search
+	bool ResumeSearch() final
+	{
+		// keep searching
+		return Search();
+	}
+
+	// Get path
+	void GetPath(Path& path) final
+	{
+		if (GetState(goal).gCost == GetInfinity())
+		{
+			return;
+		}
+
+		// go backwards to get the path (costs only decrease towards the start, so parents never loop)
+		PathNodeId current = goal;
+		PathNodeId parent = GetState(goal).parent;
+
+		plannerPath.clear();
+		plannerPath.push_back(current);
+
+		path.push_back(searchSpace->GetNodePosition(current));
+
+		while (parent != INVALID_PATH_NODE_ID)
+		{
+			plannerPath.push_back(parent);
+
+			// make sure that adjacency between current node and parent node is valid
+			PathNodeId node = searchSpace->GetValidatedPathNode(current, parent);
+			path.push_back(searchSpace->GetNodePosition(node));
+
+			current = parent;
+			parent = GetState(parent).parent;
+		}
+
+		// reverse the path
+		std::reverse(path.begin(), path.end());
+		std::reverse(plannerPath.begin(), plannerPath.end());
+	}
+
+	// Get improved path (the path of the last search if it has not been taken yet)
+	bool GetImprovedPath(Path& path) final
+	{
+		if (!improvedPath)
+		{
+			return false;
+		}
+
+		improvedPath = false;
+		GetPath(path);
+		return true;
+	}
+
+	// Get weight (of the current search, the path found by it costs at most weight times the shortest one)
+	float GetWeight() const { return weight; }
+
+	// Reset
+	void Reset() final
+	{
+		searchCompleted = false;
+		pathFound = false;
+
+		revolutions = 0;
+		expansions = 0;
+
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
+
+		// clear lists
+		open.Clear();
+		closedNodes.clear();
+		inconsistentNodes.clear();
+
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
+
+		improvedPath = false;
+		searchEnded = false;
+	}
+
+	// Debug Render
+	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
+	{
+		if (start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID && (render.pathPlannerPath || render.finalPath))
+		{
+			Path path;
+			GetPath(path);
+
+			if (render.pathPlannerPath)
+			{
+				for (auto& node : plannerPath)
+				{
+					Transform transform;
+					transform.position = searchSpace->GetNodePosition(node);
+					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
+				}
+			}
+
+			if (render.finalPath)
+			{
+				for (auto& p : path)
+				{
+					Transform transform;
+					transform.position = p;
+					RenderUtils::RenderCube(viewProjection, transform, 0x00FF00);
+				}
+			}
+		}
+	}
+
+private:
+
+	// Search (a slice ends early when a search ends with a path, so it can be used right away)
+	bool Search()
+	{
+		if (searchEnded)
+		{
+			StartNextSearch();
+		}
+
+		int revolution = 0;
+		while (!open.IsEmpty() && GetState(goal).gCost > open.GetTopFCost())
+		{
+			revolutions++;
+
+			// get cheapest from open
+			PathNodeId current = open.Pop();
+			PathNodeSearchState& currentState = GetState(current);
+			currentState.list = PathNodeList::CLOSED;
+			closedNodes.push_back(current);
+
+			// Expand
+			Expand(current, currentState);
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				return false;
+			}
+		}
+
+		// the search ended
+		pathFound = GetState(goal).gCost != GetInfinity();
+		searchCompleted = !pathFound || weight <= 1.0f;
+		improvedPath = pathFound && !searchCompleted;
+		searchEnded = true;
+
+		return searchCompleted;
+	}
+
+	// Start next search (lower weight, inconsistent nodes are opened again and every key is updated)
+	void StartNextSearch()
+	{
+		weight = std::max(weight - weightStep, 1.0f);
+
+		std::vector<PathNodeId> openNodes;
+		while (!open.IsEmpty())
+		{
+			openNodes.push_back(open.Pop());
+		}
+
+		for (PathNodeId node : closedNodes)
+		{
+			GetState(node).list = PathNodeList::NONE;
+		}
+
+		openNodes.insert(openNodes.end(), inconsistentNodes.begin(), inconsistentNodes.end());
+		closedNodes.clear();
+		inconsistentNodes.clear();
+
+		for (PathNodeId node : openNodes)
+		{
+			// inconsistent nodes can be listed more than once
+			PathNodeSearchState& state = GetState(node);
+			if (state.heapPosition == INVALID_HEAP_POSITION)
+			{
+				Open(node, state);
+			}
+		}
+
+		searchEnded = false;
+	}
+
+	// Expand
+	void Expand(PathNodeId current, const PathNodeSearchState& currentState)
+	{
+		MathGeom::Vector3 currentPosition = searchSpace->GetNodePosition(current);
+		float currentCost = currentState.gCost;
+
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			PathNodeId neighbour = neighbours[i];
+			PathNodeSearchState& neighbourState = GetState(neighbour);
+
+			float gCost = currentCost + edgeCost.Cost(current, currentPosition, neighbour, searchSpace->GetNodePosition(neighbour));
+			if (gCost >= neighbourState.gCost)
+			{
+				continue;
+			}
+
+			neighbourState.parent = current;
+			neighbourState.gCost = gCost;
+
+			if (neighbourState.list == PathNodeList::CLOSED)
+			{
+				// closed by this search, the next one opens it again (duplicates are skipped then)
+				inconsistentNodes.push_back(neighbour);
+			}
+			else if (neighbourState.list == PathNodeList::OPEN)
+			{
+				// move it up in open
+				neighbourState.fCost = gCost + weight * neighbourState.hCost;
+				open.DecreaseKey(neighbourState);
+			}
+			else
+			{
+				// push in open
+				Open(neighbour, neighbourState);
+			}
+		}
+	}
+
+	// Open (key of the current weight)
+	void Open(PathNodeId node, PathNodeSearchState& state)
+	{
+		state.list = PathNodeList::OPEN;
+		state.hCost = heuristic.Estimate(node, searchSpace->GetNodePosition(node), goal, goalPosition);
+		state.fCost = state.gCost + weight * state.hCost;
+		open.Push(node, state);
+	}
+
+	// Get state (nodes not reached yet have an infinite cost)
+	PathNodeSearchState& GetState(PathNodeId node)
+	{
+		bool isVisited = nodeStates.IsVisited(node);
+
+		PathNodeSearchState& state = nodeStates.Get(node);
+		if (!isVisited)
+		{
+			state.gCost = GetInfinity();
+		}
+
+		return state;
+	}
+
+	// Get infinity
+	static float GetInfinity() { return std::numeric_limits<float>::infinity(); }
+};
+
+#endif // !ANYTIME_A_STAR_H
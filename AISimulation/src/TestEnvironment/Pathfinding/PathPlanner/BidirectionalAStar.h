@@ -0,0 +1,305 @@
+#ifndef BIDIRECTIONAL_A_STAR_H
+#define BIDIRECTIONAL_A_STAR_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+
+// Bidirectional A*.
+// A forward search from the start and a backward search from the goal run at the same time, each one with its own
+// open list and node states, and the side with the smaller open list is expanded next. Every node reached by both
+// sides is a candidate meeting node, and the cheapest path through one of them is kept. The search stops once the
+// cheapest key of either open list is not lower than that path, which is then the shortest one (the octile heuristic
+// is consistent in both directions). Moves are assumed to be symmetric (true on grids).
+class BidirectionalAStar : public PathPlanner
+{
+	// Search direction
+	struct SearchDirection
+	{
+		// open list and per-search node states
+		PathNodeHeap open;
+		PathNodeSearchStates nodeStates;
+
+		// node the direction searches towards (goal forward, start backward)
+		PathNodeId target{ INVALID_PATH_NODE_ID };
+		MathGeom::Vector3 targetPosition;
+	};
+
+	// forward (from the start) and backward (from the goal) searches
+	SearchDirection forward;
+	SearchDirection backward;
+
+	// start/goal nodes
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+
+	// cheapest path found through a node reached by both directions
+	PathNodeId meetingNode{ INVALID_PATH_NODE_ID };
+	float meetingCost{ std::numeric_limits<float>::infinity() };
+
+	// policies
+	OctileHeuristic heuristic;
+	OctileEdgeCost edgeCost;
+
+public:
+
+	// Constructor
+	BidirectionalAStar(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
+		: PathPlanner(data, searchSpace)
+		, edgeCost(searchSpace->GetCellCosts())
+	{
+		// size node states up front (pages are allocated as the searches reach them)
+		forward.nodeStates.Init(searchSpace->GetNodeCount());
+		backward.nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Finds shortest paths
+	bool FindsShortestPaths() const final { return true; }
+
+	// Start search
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
+	{
+		// reset
+		Reset();
+
+		// set start/goal
+		this->start = start;
+		this->goal = goal;
+		forward.target = goal;
+		forward.targetPosition = searchSpace->GetNodePosition(goal);
+		backward.target = start;
+		backward.targetPosition = searchSpace->GetNodePosition(start);
+
+		// init open lists
+		Open(forward, start, 0.0f);
+		Open(backward, goal, 0.0f);
+
+		if (start == goal)
+		{
+			meetingNode = start;
+			meetingCost = 0.0f;
+		}
+
+		// search
+		return Search();
+	}
+
+	// Resume search
+	bool ResumeSearch() final
+	{
+		// keep searching
+		return Search();
+	}
+
+	// Get path
+	void GetPath(Path& path) final
+	{
+		if (pathFound)
+		{
+			// forward parents from the meeting node back to the start
+			plannerPath.clear();
+			for (PathNodeId node = meetingNode; node != INVALID_PATH_NODE_ID; node = forward.nodeStates.Get(node).parent)
+			{
+				plannerPath.push_back(node);
+			}
+
+			std::reverse(plannerPath.begin(), plannerPath.end());
+
+			// backward parents from the meeting node to the goal
+			for (PathNodeId node = backward.nodeStates.Get(meetingNode).parent; node != INVALID_PATH_NODE_ID; node = backward.nodeStates.Get(node).parent)
+			{
+				plannerPath.push_back(node);
+			}
+
+			// go backwards (as the other planners do) so corner cuts are validated the same way
+			path.push_back(searchSpace->GetNodePosition(plannerPath.back()));
+			for (size_t i = plannerPath.size() - 1; i > 0; i--)
+			{
+				// make sure that adjacency between current node and parent node is valid
+				PathNodeId node = searchSpace->GetValidatedPathNode(plannerPath[i], plannerPath[i - 1]);
+				path.push_back(searchSpace->GetNodePosition(node));
+			}
+
+			// reverse the path
+			std::reverse(path.begin(), path.end());
+		}
+	}
+
+	// Reset
+	void Reset() final
+	{
+		searchCompleted = false;
+		pathFound = false;
+
+		revolutions = 0;
+		expansions = 0;
+
+		// reset node states and open lists
+		for (SearchDirection* direction : { &forward, &backward })
+		{
+			size_t nodeCount = searchSpace->GetNodeCount();
+			if (direction->nodeStates.Size() != nodeCount)
+			{
+				direction->nodeStates.Init(nodeCount);
+			}
+			else
+			{
+				// states from previous searches become stale
+				direction->nodeStates.Reset();
+			}
+
+			direction->open.Clear();
+		}
+
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
+
+		meetingNode = INVALID_PATH_NODE_ID;
+		meetingCost = std::numeric_limits<float>::infinity();
+	}
+
+	// Debug Render
+	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
+	{
+		if (start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID && (render.pathPlannerPath || render.finalPath))
+		{
+			Path path;
+			GetPath(path);
+
+			if (render.pathPlannerPath)
+			{
+				for (auto& node : plannerPath)
+				{
+					Transform transform;
+					transform.position = searchSpace->GetNodePosition(node);
+					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
+				}
+			}
+
+			if (render.finalPath)
+			{
+				for (auto& p : path)
+				{
+					Transform transform;
+					transform.position = p;
+					RenderUtils::RenderCube(viewProjection, transform, 0x00FF00);
+				}
+			}
+		}
+	}
+
+private:
+
+	// Search
+	bool Search()
+	{
+		int revolution = 0;
+		while (!forward.open.IsEmpty() && !backward.open.IsEmpty())
+		{
+			// no path left in either open list can be cheaper than the one through the meeting node
+			if (meetingCost <= std::max(forward.open.GetTopFCost(), backward.open.GetTopFCost()))
+			{
+				break;
+			}
+
+			revolutions++;
+
+			// expand the smaller frontier
+			bool isForward = forward.open.Size() <= backward.open.Size();
+			SearchDirection& direction = isForward ? forward : backward;
+			SearchDirection& otherDirection = isForward ? backward : forward;
+
+			// get cheapest from open
+			PathNodeId current = direction.open.Pop();
+			direction.nodeStates.Get(current).list = PathNodeList::CLOSED;
+
+			// Expand
+			Expand(direction, otherDirection, current);
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				break;
+			}
+		}
+
+		// a meeting node found when an open list runs out is the cheapest one, since the other side can not reach any other
+		bool isMeetingCostFinal = forward.open.IsEmpty() || backward.open.IsEmpty() || meetingCost <= std::max(forward.open.GetTopFCost(), backward.open.GetTopFCost());
+
+		searchCompleted = isMeetingCostFinal;
+		pathFound = isMeetingCostFinal && meetingNode != INVALID_PATH_NODE_ID;
+
+		return searchCompleted;
+	}
+
+	// Expand
+	void Expand(SearchDirection& direction, SearchDirection& otherDirection, PathNodeId current)
+	{
+		MathGeom::Vector3 currentPosition = searchSpace->GetNodePosition(current);
+		float currentCost = direction.nodeStates.Get(current).gCost;
+
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			PathNodeId neighbour = neighbours[i];
+			PathNodeSearchState& neighbourState = direction.nodeStates.Get(neighbour);
+
+			if (neighbourState.list == PathNodeList::CLOSED)
+			{
+				// ignore if it is in close
+				continue;
+			}
+
+			float gCost = currentCost + edgeCost.Cost(current, currentPosition, neighbour, searchSpace->GetNodePosition(neighbour));
+			if (neighbourState.list == PathNodeList::OPEN)
+			{
+				if (gCost >= neighbourState.gCost)
+				{
+					continue;
+				}
+
+				// update neighbour and move it up in open
+				neighbourState.parent = current;
+				neighbourState.gCost = gCost;
+				neighbourState.fCost = neighbourState.hCost + gCost;
+				direction.open.DecreaseKey(neighbourState);
+			}
+			else
+			{
+				// update neighbour and push in open
+				neighbourState.parent = current;
+				Open(direction, neighbour, gCost);
+			}
+
+			// path through the neighbour if the other direction reached it too
+			if (otherDirection.nodeStates.IsVisited(neighbour))
+			{
+				float cost = gCost + otherDirection.nodeStates.Get(neighbour).gCost;
+				if (cost < meetingCost)
+				{
+					meetingNode = neighbour;
+					meetingCost = cost;
+				}
+			}
+		}
+	}
+
+	// Open
+	void Open(SearchDirection& direction, PathNodeId node, float gCost)
+	{
+		PathNodeSearchState& state = direction.nodeStates.Get(node);
+		state.list = PathNodeList::OPEN;
+		state.gCost = gCost;
+		state.hCost = heuristic.Estimate(node, searchSpace->GetNodePosition(node), direction.target, direction.targetPosition);
+		state.fCost = state.hCost + gCost;
+		direction.open.Push(node, state);
+	}
+};
+
+#endif // !BIDIRECTIONAL_A_STAR_H
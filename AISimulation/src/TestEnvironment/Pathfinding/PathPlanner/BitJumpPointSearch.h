@@ -0,0 +1,189 @@
+#ifndef BIT_JUMP_POINT_SEARCH_H
+#define BIT_JUMP_POINT_SEARCH_H
+
+#include <climits>
+
+#include "JumpPointSearch.h"
+#include "../SearchSpace/GridSearchSpace.h"
+
+// Jump Point Search over the walkable bitmaps of a grid.
+// Straight jumps read 64 cells at a time from the walkable rows (horizontal moves) or columns (vertical moves)
+// and find the first blocked cell, forced neighbour or goal with a single bit scan.
+// Diagonal jumps still step one cell at a time, running both straight scans from every cell.
+// It finds the same jump points as JumpPointSearch, so both return the same paths.
+template<class Heuristic = OctileHeuristic>
+class BitJumpPointSearchPlanner : public JumpPointSearchPlanner<Heuristic>
+{
+	// cell used when the goal is not in the scanned row/column
+	static const int NO_GOAL_CELL = INT_MIN;
+
+	// grid
+	std::shared_ptr<GridSearchSpace> grid;
+
+public:
+
+	// Constructor
+	BitJumpPointSearchPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic_ = Heuristic())
+		: JumpPointSearchPlanner<Heuristic>(data, searchSpace, heuristic_)
+		, grid(std::dynamic_pointer_cast<GridSearchSpace>(searchSpace))
+	{
+		// the walkable bitmaps are only available on grids
+		assert(grid);
+	}
+
+protected:
+
+	// Jump
+	PathNodeId Jump(PathNodeId current, PathNodeAdjacency direction) override
+	{
+		int x = int(grid->GetCellX(current));
+		int z = int(grid->GetCellZ(current));
+		int goalX = int(grid->GetCellX(this->goal));
+		int goalZ = int(grid->GetCellZ(this->goal));
+
+		switch (direction)
+		{
+		case PathNodeAdjacency::RIGHT:
+		case PathNodeAdjacency::LEFT:
+		{
+			int jumpX = JumpStraight(x, z, direction, goalX, goalZ);
+			return jumpX >= 0 ? grid->GetNodeId(jumpX, z) : INVALID_PATH_NODE_ID;
+		}
+		case PathNodeAdjacency::TOP:
+		case PathNodeAdjacency::BOTTOM:
+		{
+			int jumpZ = JumpStraight(x, z, direction, goalX, goalZ);
+			return jumpZ >= 0 ? grid->GetNodeId(x, jumpZ) : INVALID_PATH_NODE_ID;
+		}
+		case PathNodeAdjacency::TOP_LEFT:
+		case PathNodeAdjacency::TOP_RIGHT:
+		case PathNodeAdjacency::BOTTOM_RIGHT:
+		case PathNodeAdjacency::BOTTOM_LEFT:
+			return JumpDiagonal(x, z, GRID_ADJACENCY_OFFSET_X[(int)direction], GRID_ADJACENCY_OFFSET_Z[(int)direction], goalX, goalZ);
+		default:
+			assert(false);
+			break;
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+private:
+
+	// Jump diagonal
+	PathNodeId JumpDiagonal(int x, int z, int dx, int dz, int goalX, int goalZ)
+	{
+		const GridBitmap& rows = grid->GetWalkableRows();
+
+		PathNodeAdjacency vertical = dz < 0 ? PathNodeAdjacency::TOP : PathNodeAdjacency::BOTTOM;
+		PathNodeAdjacency horizontal = dx > 0 ? PathNodeAdjacency::RIGHT : PathNodeAdjacency::LEFT;
+
+		while (true)
+		{
+			if (!rows.Get(x + dx, z) && !rows.Get(x, z + dz))
+			{
+				// No way to jump between two blocked straight cells
+				return INVALID_PATH_NODE_ID;
+			}
+
+			x += dx;
+			z += dz;
+
+			if (!rows.Get(x, z))
+			{
+				// No way to jump outside the grid or to a blocked node
+				return INVALID_PATH_NODE_ID;
+			}
+
+			if ((x == goalX && z == goalZ)
+				// forced neighbours
+				|| (rows.Get(x, z + dz) && rows.Get(x - dx, z + dz) && !rows.Get(x - dx, z))
+				|| (rows.Get(x + dx, z) && rows.Get(x + dx, z - dz) && !rows.Get(x, z - dz))
+				// straight jump points
+				|| JumpStraight(x, z, vertical, goalX, goalZ) >= 0
+				|| JumpStraight(x, z, horizontal, goalX, goalZ) >= 0)
+			{
+				return grid->GetNodeId(x, z);
+			}
+		}
+	}
+
+	// Jump straight (column of the jump point for horizontal moves, row for vertical moves, -1 if there is none)
+	int JumpStraight(int x, int z, PathNodeAdjacency direction, int goalX, int goalZ)
+	{
+		switch (direction)
+		{
+		case PathNodeAdjacency::RIGHT:
+			return ScanForward(grid->GetWalkableRows(), x, z, z == goalZ ? goalX : NO_GOAL_CELL);
+		case PathNodeAdjacency::LEFT:
+			return ScanBackward(grid->GetWalkableRows(), x, z, z == goalZ ? goalX : NO_GOAL_CELL);
+		case PathNodeAdjacency::BOTTOM:
+			return ScanForward(grid->GetWalkableColumns(), z, x, x == goalX ? goalZ : NO_GOAL_CELL);
+		case PathNodeAdjacency::TOP:
+			return ScanBackward(grid->GetWalkableColumns(), z, x, x == goalX ? goalZ : NO_GOAL_CELL);
+		default:
+			assert(false);
+			break;
+		}
+
+		return -1;
+	}
+
+	// Scan forward from cell x of bitmap row y.
+	// A cell stops the scan if it is blocked (no jump point), it is the goal or it has a forced neighbour:
+	// the next cell is walkable and so is a cell next to it whose neighbour in the previous/next row is blocked.
+	static int ScanForward(const GridBitmap& bitmap, int x, int y, int goalCell)
+	{
+		for (int first = x + 1; ; first += 64)
+		{
+			// bit i is the cell first + i
+			uint64_t cells = bitmap.GetBits(first, y);
+			uint64_t forced = bitmap.GetBits(first + 1, y)
+				& ((bitmap.GetBits(first + 1, y - 1) & ~bitmap.GetBits(first, y - 1))
+				|  (bitmap.GetBits(first + 1, y + 1) & ~bitmap.GetBits(first, y + 1)));
+
+			uint64_t stop = ~cells | forced;
+			if (goalCell >= first && goalCell < first + 64)
+			{
+				stop |= uint64_t(1) << (goalCell - first);
+			}
+
+			if (stop)
+			{
+				int bit = CountTrailingZeros(stop);
+				return ((cells >> bit) & 1) ? first + bit : -1;
+			}
+		}
+	}
+
+	// Scan backward from cell x of bitmap row y (same as ScanForward, mirrored)
+	static int ScanBackward(const GridBitmap& bitmap, int x, int y, int goalCell)
+	{
+		for (int last = x - 1; ; last -= 64)
+		{
+			// bit i is the cell first + i, so the closest cell is the highest bit
+			int first = last - 63;
+			uint64_t cells = bitmap.GetBits(first, y);
+			uint64_t forced = bitmap.GetBits(first - 1, y)
+				& ((bitmap.GetBits(first - 1, y - 1) & ~bitmap.GetBits(first, y - 1))
+				|  (bitmap.GetBits(first - 1, y + 1) & ~bitmap.GetBits(first, y + 1)));
+
+			uint64_t stop = ~cells | forced;
+			if (goalCell >= first && goalCell <= last)
+			{
+				stop |= uint64_t(1) << (goalCell - first);
+			}
+
+			if (stop)
+			{
+				int bit = 63 - CountLeadingZeros(stop);
+				return ((cells >> bit) & 1) ? first + bit : -1;
+			}
+		}
+	}
+};
+
+// Bit JPS (octile heuristic)
+using BitJumpPointSearch = BitJumpPointSearchPlanner<>;
+
+#endif // !BIT_JUMP_POINT_SEARCH_H
@@ -0,0 +1,423 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+
+// D* Lite.
+// It searches from the goal towards the start and keeps its search tree (g and rhs costs of every node reached)
+// after the search is completed. When cells change only the nodes around them are made inconsistent again,
+// so the next search repairs the affected region instead of searching from scratch. The start can move along
+// the path without losing the tree (key modifier km). Moves are assumed to be symmetric (true on grids).
+class DStarLite : public PathPlanner
+{
+	// open list (ordered by key: fCost is the first component and hCost the second one)
+	PathNodeHeap open;
+
+	// node states (gCost, rhsCost and the key while in open), kept between searches of the same goal
+	PathNodeSearchStates nodeStates;
+
+	// start/goal nodes
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+
+	// key modifier (heuristic distance the start has moved since the search started)
+	float km{ 0.0f };
+
+	// policies
+	OctileHeuristic heuristic;
+	OctileEdgeCost edgeCost;
+
+public:
+
+	// Constructor
+	DStarLite(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
+		: PathPlanner(data, searchSpace)
+		, edgeCost(searchSpace->GetCellCosts())
+	{
+		nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Start search
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
+	{
+		// reset
+		Reset();
+
+		// set start/goal
+		this->start = start;
+		this->goal = goal;
+
+		// init open list with the goal
+		PathNodeSearchState& goalState = GetState(goal);
+		goalState.rhsCost = 0.0f;
+		UpdateVertex(goal);
+
+		// search
+		return Search();
+	}
+
+	// Resume search
+	bool ResumeSearch() final
+	{
+		return Search();
+	}
+
+	// Move start (the search tree is kept, costs of the new start are ready once the search is resumed)
+	void MoveStart(PathNodeId newStart)
+	{
+		assert(newStart != INVALID_PATH_NODE_ID);
+
+		if (newStart == start || goal == INVALID_PATH_NODE_ID)
+		{
+			return;
+		}
+
+		km += Heuristic(start, newStart);
+		start = newStart;
+
+		searchCompleted = false;
+		pathFound = false;
+	}
+
+	// On cells changed (walkability of the nodes changed, the search has to be resumed to repair the tree)
+	void OnCellsChanged(const std::vector<PathNodeId>& nodes)
+	{
+		if (goal == INVALID_PATH_NODE_ID)
+		{
+			return;
+		}
+
+		// edges of the node and diagonals cutting its corners end in the node or one of its neighbours
+		PathNodeNeighbours neighbours;
+		for (PathNodeId node : nodes)
+		{
+			UpdateRhs(node);
+			for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+			{
+				PathNodeId neighbour = searchSpace->GetNeighbour(node, PathNodeAdjacency(adjacency));
+				if (neighbour != INVALID_PATH_NODE_ID)
+				{
+					UpdateRhs(neighbour);
+				}
+			}
+
+			// and the nodes linked to it (e.g. on other layers), which are valid neighbours without being adjacent
+			size_t neighbourCount = searchSpace->GetValidNeighbours(node, neighbours);
+			for (size_t i = 0; i < neighbourCount; i++)
+			{
+				UpdateRhs(neighbours[i]);
+			}
+		}
+
+		searchCompleted = false;
+		pathFound = false;
+	}
+
+	// Get start/goal
+	PathNodeId GetStart() const { return start; }
+	PathNodeId GetGoal() const { return goal; }
+
+	// Get path
+	void GetPath(Path& path) final
+	{
+		if (!pathFound)
+		{
+			return;
+		}
+
+		// go down the costs from the start
+		PathNodeId current = start;
+
+		plannerPath.clear();
+		plannerPath.push_back(current);
+
+		path.push_back(searchSpace->GetNodePosition(current));
+
+		while (current != goal && plannerPath.size() <= searchSpace->GetNodeCount())
+		{
+			PathNodeId next = GetNextNode(current);
+			if (next == INVALID_PATH_NODE_ID)
+			{
+				// the tree is being repaired
+				path.clear();
+				plannerPath.clear();
+				return;
+			}
+
+			plannerPath.push_back(next);
+
+			// make sure that adjacency between current node and next node is valid
+			PathNodeId node = searchSpace->GetValidatedPathNode(current, next);
+			path.push_back(searchSpace->GetNodePosition(node));
+
+			current = next;
+		}
+	}
+
+	// Reset
+	void Reset() final
+	{
+		searchCompleted = false;
+		pathFound = false;
+
+		revolutions = 0;
+		expansions = 0;
+
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
+
+		// clear open list
+		open.Clear();
+
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
+		km = 0.0f;
+	}
+
+	// Debug Render
+	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
+	{
+		if (start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID && (render.pathPlannerPath || render.finalPath))
+		{
+			Path path;
+			GetPath(path);
+
+			if (render.pathPlannerPath)
+			{
+				for (auto& node : plannerPath)
+				{
+					Transform transform;
+					transform.position = searchSpace->GetNodePosition(node);
+					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
+				}
+			}
+
+			if (render.finalPath)
+			{
+				for (auto& p : path)
+				{
+					Transform transform;
+					transform.position = p;
+					RenderUtils::RenderCube(viewProjection, transform, 0x00FF00);
+				}
+			}
+		}
+	}
+
+private:
+
+	// Search (make the start consistent, at most maxRevolutions nodes per call)
+	bool Search()
+	{
+		int revolution = 0;
+		while (!IsStartConsistent())
+		{
+			revolutions++;
+
+			PathNodeId current = open.Top();
+			PathNodeSearchState& state = GetState(current);
+
+			float oldKey = open.GetTopFCost();
+			float newKey = GetKey(current, state);
+
+			if (oldKey < newKey)
+			{
+				// the key is out of date because the start moved
+				SetKey(current, state);
+				open.Update(state);
+			}
+			else if (state.gCost > state.rhsCost)
+			{
+				// overconsistent: the node gets its lookahead cost and lowers the costs of its neighbours
+				state.gCost = state.rhsCost;
+				open.Remove(state);
+
+				PathNodeNeighbours neighbours;
+				size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+				for (size_t i = 0; i < neighbourCount; i++)
+				{
+					PathNodeId neighbour = neighbours[i];
+					if (neighbour != goal)
+					{
+						PathNodeSearchState& neighbourState = GetState(neighbour);
+						neighbourState.rhsCost = std::min(neighbourState.rhsCost, state.gCost + Cost(current, neighbour));
+						UpdateVertex(neighbour);
+					}
+				}
+			}
+			else
+			{
+				// underconsistent: the node is raised and so are the neighbours that went through it
+				state.gCost = GetInfinity();
+				UpdateRhs(current);
+
+				PathNodeNeighbours neighbours;
+				size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+				for (size_t i = 0; i < neighbourCount; i++)
+				{
+					UpdateRhs(neighbours[i]);
+				}
+			}
+
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				break;
+			}
+		}
+
+		searchCompleted = IsStartConsistent();
+		pathFound = searchCompleted && GetState(start).gCost != GetInfinity();
+
+		return searchCompleted;
+	}
+
+	// Is start consistent (nothing left in open can lower the cost of the start)
+	bool IsStartConsistent()
+	{
+		if (open.IsEmpty())
+		{
+			return true;
+		}
+
+		PathNodeSearchState& startState = GetState(start);
+		float startKey = GetKey(start, startState);
+		float startSecondKey = std::min(startState.gCost, startState.rhsCost);
+
+		bool isTopLess = open.GetTopFCost() < startKey || (open.GetTopFCost() == startKey && open.GetTopHCost() < startSecondKey);
+		return !isTopLess && startState.rhsCost == startState.gCost;
+	}
+
+	// Update rhs (lookahead cost from the neighbours) and the node in open
+	void UpdateRhs(PathNodeId node)
+	{
+		PathNodeSearchState& state = GetState(node);
+		if (node == goal)
+		{
+			state.rhsCost = searchSpace->IsWalkable(goal) ? 0.0f : GetInfinity();
+		}
+		else
+		{
+			state.rhsCost = GetInfinity();
+			if (searchSpace->IsWalkable(node))
+			{
+				PathNodeNeighbours neighbours;
+				size_t neighbourCount = searchSpace->GetValidNeighbours(node, neighbours);
+				for (size_t i = 0; i < neighbourCount; i++)
+				{
+					state.rhsCost = std::min(state.rhsCost, GetState(neighbours[i]).gCost + Cost(node, neighbours[i]));
+				}
+			}
+		}
+
+		UpdateVertex(node);
+	}
+
+	// Update vertex (inconsistent nodes are in open with an up to date key, consistent ones are not)
+	void UpdateVertex(PathNodeId node)
+	{
+		PathNodeSearchState& state = GetState(node);
+		bool isOpen = state.heapPosition != INVALID_HEAP_POSITION;
+
+		if (state.gCost != state.rhsCost)
+		{
+			SetKey(node, state);
+			if (isOpen)
+			{
+				open.Update(state);
+			}
+			else
+			{
+				open.Push(node, state);
+			}
+		}
+		else if (isOpen)
+		{
+			open.Remove(state);
+		}
+	}
+
+	// Get next node (neighbour of the node with the cheapest cost to the goal through it)
+	PathNodeId GetNextNode(PathNodeId node)
+	{
+		PathNodeId next = INVALID_PATH_NODE_ID;
+		float nextCost = GetInfinity();
+
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(node, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			float cost = GetState(neighbours[i]).gCost + Cost(node, neighbours[i]);
+			if (cost < nextCost)
+			{
+				next = neighbours[i];
+				nextCost = cost;
+			}
+		}
+
+		return next;
+	}
+
+	// Get state (nodes not reached yet have infinite costs)
+	PathNodeSearchState& GetState(PathNodeId node)
+	{
+		bool isVisited = nodeStates.IsVisited(node);
+
+		PathNodeSearchState& state = nodeStates.Get(node);
+		if (!isVisited)
+		{
+			state.gCost = GetInfinity();
+			state.rhsCost = GetInfinity();
+		}
+
+		return state;
+	}
+
+	// Get key (first component, the second one is min(g, rhs))
+	float GetKey(PathNodeId node, const PathNodeSearchState& state) const
+	{
+		return std::min(state.gCost, state.rhsCost) + Heuristic(start, node) + km;
+	}
+
+	// Set key
+	void SetKey(PathNodeId node, PathNodeSearchState& state) const
+	{
+		state.fCost = GetKey(node, state);
+		state.hCost = std::min(state.gCost, state.rhsCost);
+	}
+
+	// Cost (of the move between two adjacent nodes)
+	float Cost(PathNodeId nodeA, PathNodeId nodeB) const
+	{
+		return edgeCost.Cost(nodeA, searchSpace->GetNodePosition(nodeA), nodeB, searchSpace->GetNodePosition(nodeB));
+	}
+
+	// Heuristic (between two nodes)
+	float Heuristic(PathNodeId nodeA, PathNodeId nodeB) const
+	{
+		return heuristic.Estimate(nodeA, searchSpace->GetNodePosition(nodeA), nodeB, searchSpace->GetNodePosition(nodeB));
+	}
+
+	// Get infinity
+	static float GetInfinity() { return std::numeric_limits<float>::infinity(); }
+};
+
+#endif // !D_STAR_LITE_H
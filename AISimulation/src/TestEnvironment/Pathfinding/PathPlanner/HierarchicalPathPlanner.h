@@ -0,0 +1,439 @@
+#ifndef HIERARCHICAL_PATH_PLANNER_H
+#define HIERARCHICAL_PATH_PLANNER_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+#include "../SearchSpace/HierarchicalNavGrid.h"
+
+// Hierarchical path planner (HPA*).
+// It connects the start and goal to the portals of their clusters, runs A* on the graph of portals
+// and then refines the abstract path one segment at a time with searches that never leave a cluster.
+// The abstract search is bound by the number of clusters and the refinement by the length of the path,
+// so long requests no longer pay for the size of the grid. Paths are near optimal: they cross clusters through portals.
+class HierarchicalPathPlanner : public PathPlanner
+{
+	// Search phase
+	enum class SearchPhase
+	{
+		ABSTRACT_SEARCH,
+		REFINE,
+		DONE
+	};
+
+	// grid
+	std::shared_ptr<HierarchicalNavGrid> grid;
+
+	// search inside clusters (start/goal connection and refinement)
+	GridRegionSearch regionSearch;
+
+	// abstract search (portal cells, start and goal)
+	PathNodeHeap open;
+	PathNodeSearchStates nodeStates;
+
+	// start/goal nodes and their clusters
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+	size_t startCluster{ 0 };
+	size_t goalCluster{ 0 };
+
+	// edges from the start (portals of its cluster, and the goal when it can be reached without leaving the cluster)
+	std::vector<std::pair<PathNodeId, float>> startEdges;
+
+	// cost from each portal of the goal cluster to the goal
+	std::vector<float> goalCosts;
+
+	// refined path (cells), built from the abstract path kept in plannerPath
+	std::vector<PathNodeId> refinedPath;
+	size_t refinedSegments{ 0 };
+
+	// search phase
+	SearchPhase phase{ SearchPhase::DONE };
+
+public:
+
+	// Constructor
+	HierarchicalPathPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
+		: PathPlanner(data, searchSpace)
+		, grid(std::dynamic_pointer_cast<HierarchicalNavGrid>(searchSpace))
+	{
+		// clusters and portals are only available on hierarchical grids
+		assert(grid);
+
+		nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Start search
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
+	{
+		// reset
+		Reset();
+
+		// set start/goal
+		this->start = start;
+		this->goal = goal;
+		startCluster = grid->GetClusterIndex(start);
+		goalCluster = grid->GetClusterIndex(goal);
+
+		// connect the goal to the portals of its cluster
+		auto& goalPortals = grid->GetCluster(goalCluster).portals;
+		regionSearch.SearchCosts(*grid, goal, grid->GetCluster(goalCluster).region);
+		revolutions += regionSearch.GetRevolutions();
+		expansions += regionSearch.GetRevolutions();
+
+		goalCosts.resize(goalPortals.size());
+		for (size_t portal = 0; portal < goalPortals.size(); portal++)
+		{
+			goalCosts[portal] = regionSearch.GetCost(goalPortals[portal].cell);
+		}
+
+		float startGoalCost = startCluster == goalCluster ? regionSearch.GetCost(start) : INFINITY;
+
+		// connect the start to the portals of its cluster
+		auto& startPortals = grid->GetCluster(startCluster).portals;
+		regionSearch.SearchCosts(*grid, start, grid->GetCluster(startCluster).region);
+		revolutions += regionSearch.GetRevolutions();
+		expansions += regionSearch.GetRevolutions();
+
+		for (auto& portal : startPortals)
+		{
+			float cost = regionSearch.GetCost(portal.cell);
+			if (cost != INFINITY)
+			{
+				startEdges.emplace_back(portal.cell, cost);
+			}
+		}
+
+		if (startGoalCost != INFINITY)
+		{
+			startEdges.emplace_back(goal, startGoalCost);
+		}
+
+		// init open list
+		PathNodeSearchState& startState = nodeStates.Get(start);
+		startState.hCost = GetHeuristic(start);
+		startState.fCost = startState.hCost;
+		startState.list = PathNodeList::OPEN;
+		open.Push(start, startState);
+
+		phase = SearchPhase::ABSTRACT_SEARCH;
+
+		// search
+		return Search();
+	}
+
+	// Resume search
+	bool ResumeSearch() final
+	{
+		// keep searching
+		return Search();
+	}
+
+	// Get path
+	void GetPath(Path& path) final
+	{
+		if (pathFound)
+		{
+			// go backwards (as the other planners do) so corner cuts are validated the same way
+			path.push_back(searchSpace->GetNodePosition(refinedPath.back()));
+			for (size_t i = refinedPath.size() - 1; i > 0; i--)
+			{
+				// make sure that adjacency between current node and parent node is valid
+				PathNodeId node = searchSpace->GetValidatedPathNode(refinedPath[i], refinedPath[i - 1]);
+				path.push_back(searchSpace->GetNodePosition(node));
+			}
+
+			// reverse the path
+			std::reverse(path.begin(), path.end());
+		}
+	}
+
+	// Debug Render
+	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
+	{
+		if (start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID && (render.pathPlannerPath || render.finalPath))
+		{
+			if (render.pathPlannerPath)
+			{
+				for (auto& node : plannerPath)
+				{
+					Transform transform;
+					transform.position = searchSpace->GetNodePosition(node);
+					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
+				}
+			}
+
+			if (render.finalPath)
+			{
+				Path path;
+				GetPath(path);
+
+				for (auto& p : path)
+				{
+					Transform transform;
+					transform.position = p;
+					RenderUtils::RenderCube(viewProjection, transform, 0x00FF00);
+				}
+			}
+		}
+	}
+
+	// Reset
+	void Reset() override
+	{
+		searchCompleted = false;
+		pathFound = false;
+
+		revolutions = 0;
+		expansions = 0;
+
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
+
+		// clear open list
+		open.Clear();
+
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
+
+		startEdges.clear();
+		goalCosts.clear();
+
+		plannerPath.clear();
+		refinedPath.clear();
+		refinedSegments = 0;
+
+		phase = SearchPhase::DONE;
+	}
+
+private:
+
+	// Search
+	bool Search()
+	{
+		int revolution = 0;
+
+		// abstract search
+		while (phase == SearchPhase::ABSTRACT_SEARCH)
+		{
+			if (open.IsEmpty())
+			{
+				// no path
+				phase = SearchPhase::DONE;
+				break;
+			}
+
+			revolutions++;
+
+			// get cheapest from open
+			auto current = open.Pop();
+			nodeStates.Get(current).list = PathNodeList::CLOSED;
+
+			if (current == goal)
+			{
+				// abstract path found, refine it
+				BuildAbstractPath();
+				phase = SearchPhase::REFINE;
+				break;
+			}
+
+			// Expand
+			Expand(current);
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				return false;
+			}
+		}
+
+		// refinement (one segment at a time)
+		while (phase == SearchPhase::REFINE)
+		{
+			if (refinedSegments + 1 >= plannerPath.size())
+			{
+				// path found!
+				pathFound = true;
+				phase = SearchPhase::DONE;
+				break;
+			}
+
+			// check search allowance
+			if (revolution >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				return false;
+			}
+
+			if (!RefineSegment(refinedSegments++))
+			{
+				phase = SearchPhase::DONE;
+				break;
+			}
+
+			revolution += int(regionSearch.GetRevolutions());
+			revolutions += regionSearch.GetRevolutions();
+			expansions += regionSearch.GetRevolutions();
+		}
+
+		searchCompleted = true;
+
+		return searchCompleted;
+	}
+
+	// Expand
+	void Expand(PathNodeId current)
+	{
+		if (current == start)
+		{
+			for (auto& edge : startEdges)
+			{
+				UpdateCost(current, edge.first, edge.second);
+			}
+		}
+
+		size_t clusterIndex = grid->GetClusterIndex(current);
+		int portalIndex = grid->GetPortalIndex(clusterIndex, current);
+		if (portalIndex < 0)
+		{
+			return;
+		}
+
+		auto& cluster = grid->GetCluster(clusterIndex);
+		auto& portal = cluster.portals[portalIndex];
+
+		// portals of the same cluster
+		for (size_t other = 0; other < cluster.portals.size(); other++)
+		{
+			float cost = cluster.GetCost(portalIndex, other);
+			if (int(other) != portalIndex && cost != INFINITY)
+			{
+				UpdateCost(current, cluster.portals[other].cell, cost);
+			}
+		}
+
+		// portals of the neighbour clusters (one straight move, scaled by the cell costs)
+		const CellCostTable* cellCosts = grid->GetCellCosts();
+		for (auto& link : portal.links)
+		{
+			float cost = grid->GetCellSize();
+			if (cellCosts->HasCosts())
+			{
+				cost *= cellCosts->GetMoveMultiplier(current, link);
+			}
+
+			UpdateCost(current, link, cost);
+		}
+
+		// goal
+		if (clusterIndex == goalCluster && goalCosts[portalIndex] != INFINITY)
+		{
+			UpdateCost(current, goal, goalCosts[portalIndex]);
+		}
+	}
+
+	// Update cost
+	void UpdateCost(PathNodeId current, PathNodeId neighbour, float cost)
+	{
+		PathNodeSearchState& currentState = nodeStates.Get(current);
+		PathNodeSearchState& neighbourState = nodeStates.Get(neighbour);
+
+		if (neighbourState.list == PathNodeList::CLOSED)
+		{
+			// ignore if it is in close
+			return;
+		}
+
+		float gCost = currentState.gCost + cost;
+		if (neighbourState.list == PathNodeList::OPEN)
+		{
+			// check if this path is better
+			if (gCost < neighbourState.gCost)
+			{
+				// update neighbour
+				neighbourState.parent = current;
+				neighbourState.gCost = gCost;
+				neighbourState.fCost = neighbourState.hCost + gCost;
+
+				// move it up in open
+				open.DecreaseKey(neighbourState);
+			}
+		}
+		else
+		{
+			// update neighbour
+			neighbourState.parent = current;
+			neighbourState.hCost = GetHeuristic(neighbour);
+			neighbourState.gCost = gCost;
+			neighbourState.fCost = neighbourState.hCost + gCost;
+
+			// push in open
+			neighbourState.list = PathNodeList::OPEN;
+			open.Push(neighbour, neighbourState);
+		}
+	}
+
+	// Get heuristic (octile distance to the goal, like the other planners)
+	float GetHeuristic(PathNodeId node) const
+	{
+		return OctileHeuristic().Estimate(node, grid->GetNodePosition(node), goal, grid->GetNodePosition(goal));
+	}
+
+	// Build abstract path (start, portals and goal)
+	void BuildAbstractPath()
+	{
+		plannerPath.clear();
+		for (PathNodeId node = goal; node != INVALID_PATH_NODE_ID; node = nodeStates.Get(node).parent)
+		{
+			plannerPath.push_back(node);
+		}
+
+		std::reverse(plannerPath.begin(), plannerPath.end());
+
+		refinedPath.clear();
+		refinedPath.push_back(start);
+		refinedSegments = 0;
+	}
+
+	// Refine segment (cells between two consecutive nodes of the abstract path)
+	bool RefineSegment(size_t segment)
+	{
+		PathNodeId from = plannerPath[segment];
+		PathNodeId to = plannerPath[segment + 1];
+
+		size_t cluster = grid->GetClusterIndex(from);
+		if (cluster != grid->GetClusterIndex(to))
+		{
+			// portals linked across a border are next to each other
+			refinedPath.push_back(to);
+			return true;
+		}
+
+		// the search adds the first cell again
+		refinedPath.pop_back();
+		if (!regionSearch.FindPath(*grid, from, to, grid->GetCluster(cluster).region, refinedPath))
+		{
+			// the abstract graph is out of date
+			assert(false);
+			return false;
+		}
+
+		return true;
+	}
+};
+
+#endif // !HIERARCHICAL_PATH_PLANNER_H
@@ -3,53 +3,75 @@
 
 #include "OpenClosePathPlanner.h"
 
-class JumpPointSearch : public OpenClosePathPlanner
+// Jump Point Search with its heuristic policy (see PathPlannerPolicies.h, moves always have octile edge costs)
+template<class Heuristic = OctileHeuristic>
+class JumpPointSearchPlanner : public OpenClosePathPlanner
 {
   // Jump direction is a direct map to PathNodeAdjacency
   using JumpDirection = PathNodeAdjacency;
 
+  // policies
+  Heuristic heuristic;
+  OctileEdgeCost edgeCost;
+
 public:
 
 	// Constructor
-	JumpPointSearch(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace) 
+	JumpPointSearchPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic_ = Heuristic())
 		: OpenClosePathPlanner(data, searchSpace)
+		, heuristic(heuristic_)
+		, edgeCost(searchSpace->GetCellCosts())
 	{
 	}
 
+	// Finds shortest paths (with an admissible heuristic, jump points do not lose any)
+	bool FindsShortestPaths() const final { return Heuristic::ADMISSIBLE; }
+
 private:
 
-  // Expand
-  void Expand(PathNode* current) final
+  // Expand (like A* on grids with cell costs: moves no longer cost their length, so a jump could skip a cheaper
+  // way around the costly cells)
+  void Expand(PathNodeId current) final
   {
-    std::vector<PathNode*> successors;
+    std::vector<PathNodeId> successors;
 
-    // Identify successors
-    IdentifySuccessors(current, successors);
+    if (cellCosts && cellCosts->HasCosts())
+    {
+      PathNodeNeighbours neighbours;
+      size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+      successors.assign(neighbours.begin(), neighbours.begin() + neighbourCount);
+    }
+    else
+    {
+      // Identify successors
+      IdentifySuccessors(current, successors);
+    }
 
     // update cost for each successor
 	for (auto successor : successors)
 	{
-		UpdateCost(current, successor);
+		UpdateCost(current, successor, heuristic, edgeCost);
 	}
 
     // push current in close
-    close.push_back(current);
+    Close(current);
   }
 
   // Identify successors
-  void IdentifySuccessors(PathNode* current, std::vector<PathNode*>& successors)
+  void IdentifySuccessors(PathNodeId current, std::vector<PathNodeId>& successors)
   {
     // clear current successors
     successors.clear();
 
     // prune neighbours
-    std::vector<PathNode*> neighbours;
+    std::vector<PathNodeId> neighbours;
     Prune(current, neighbours);
 
     // jump
     for (auto neighbour : neighbours)
     {
-      if (auto jumpPoint = Jump(current, GetJumpDirection(current, neighbour)))
+      PathNodeId jumpPoint = Jump(current, GetJumpDirection(current, neighbour));
+      if (jumpPoint != INVALID_PATH_NODE_ID)
       {
         successors.push_back(jumpPoint);
       }
@@ -57,18 +79,20 @@ private:
   }
 
   // Prune
-  void Prune(PathNode* current, std::vector<PathNode*>& neighbours)
+  void Prune(PathNodeId current, std::vector<PathNodeId>& neighbours)
   {
-    if (current->parent)
+    PathNodeId parent = GetSearchState(current).parent;
+    if (parent != INVALID_PATH_NODE_ID)
     {
 		bool flagForcedNodes = false;
-		Prune(current, neighbours, GetJumpDirection(current->parent, current), flagForcedNodes);
+		Prune(current, neighbours, GetJumpDirection(parent, current), flagForcedNodes);
     }
 	else
 	{
 		// current node is the start node, so consider all walkable neighbours
-		for (auto neighbour : current->neighbours)
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
 		{
+			PathNodeId neighbour = searchSpace->GetNeighbour(current, PathNodeAdjacency(adjacency));
 			if (searchSpace->IsValidAdjacency(current, neighbour))
 			{
 				neighbours.push_back(neighbour);
@@ -78,7 +102,7 @@ private:
   }
 
   // Prune
-  void Prune(PathNode* current, std::vector<PathNode*>& neighbours, JumpDirection direction, bool flagForcedNodes)
+  void Prune(PathNodeId current, std::vector<PathNodeId>& neighbours, JumpDirection direction, bool flagForcedNodes)
   {
 	  switch (direction)
 	  {
@@ -130,8 +154,8 @@ private:
 
   // Prune straight move
   void PruneStraightMove(
-	  PathNode* current, 
-	  std::vector<PathNode*>& neighbours, 
+	  PathNodeId current, 
+	  std::vector<PathNodeId>& neighbours, 
 	  JumpDirection right, 
 	  JumpDirection topRight, 
 	  JumpDirection bottomRight, 
@@ -139,26 +163,26 @@ private:
 	  JumpDirection bottom,
 	  bool flagForcedNodes)
   {
-	  PathNode* rightNode = current->GetNeighbour((int)right);
+	  PathNodeId rightNode = searchSpace->GetNeighbour(current, right);
 	  if (IsWalkable(rightNode))
 	  {
 		  neighbours.push_back(rightNode);
 
-		  PathNode* topRightNode = current->GetNeighbour((int)topRight);
-		  PathNode* bottomRightNode = current->GetNeighbour((int)bottomRight);
+		  PathNodeId topRightNode = searchSpace->GetNeighbour(current, topRight);
+		  PathNodeId bottomRightNode = searchSpace->GetNeighbour(current, bottomRight);
 
-		  PathNode* topNode = current->GetNeighbour((int)top);
-		  PathNode* bottomNode = current->GetNeighbour((int)bottom);
+		  PathNodeId topNode = searchSpace->GetNeighbour(current, top);
+		  PathNodeId bottomNode = searchSpace->GetNeighbour(current, bottom);
 
 		  if (IsWalkable(topRightNode) && !IsWalkable(topNode))
 		  {
-			  topRightNode->isForced = flagForcedNodes;
+			  GetSearchState(topRightNode).isForced = flagForcedNodes;
 			  neighbours.push_back(topRightNode); 
 		  }
 
 		  if (IsWalkable(bottomRightNode) && !IsWalkable(bottomNode))
 		  {
-			  bottomRightNode->isForced = flagForcedNodes;
+			  GetSearchState(bottomRightNode).isForced = flagForcedNodes;
 			  neighbours.push_back(bottomRightNode);
 		  }
 	  }
@@ -166,8 +190,8 @@ private:
 
   // Prune diagonal move
   void PruneDiagonalMove(
-	  PathNode* current, 
-	  std::vector<PathNode*>& neighbours,
+	  PathNodeId current, 
+	  std::vector<PathNodeId>& neighbours,
 	  JumpDirection top,
 	  JumpDirection right, 
 	  JumpDirection topRight, 
@@ -177,20 +201,20 @@ private:
 	  JumpDirection bottom,
 	  bool flagForcedNodes)
   {
-	  PathNode* topNode = current->GetNeighbour(int(top));
-	  PathNode* rightNode = current->GetNeighbour(int(right));
-	  PathNode* topRightNode = current->GetNeighbour(int(topRight));
+	  PathNodeId topNode = searchSpace->GetNeighbour(current, top);
+	  PathNodeId rightNode = searchSpace->GetNeighbour(current, right);
+	  PathNodeId topRightNode = searchSpace->GetNeighbour(current, topRight);
 
 	  if (IsWalkable(topNode))
 	  {
 		  neighbours.push_back(topNode);
 
-		  PathNode* topLeftNode = current->GetNeighbour(int(topLeft));
-		  PathNode* leftNode = current->GetNeighbour(int(left));
+		  PathNodeId topLeftNode = searchSpace->GetNeighbour(current, topLeft);
+		  PathNodeId leftNode = searchSpace->GetNeighbour(current, left);
 
 		  if (IsWalkable(topLeftNode) && !IsWalkable(leftNode))
 		  {
-			  topLeftNode->isForced = flagForcedNodes;
+			  GetSearchState(topLeftNode).isForced = flagForcedNodes;
 			  neighbours.push_back(topLeftNode); 
 		  }
 	  }
@@ -199,12 +223,12 @@ private:
 	  {
 		  neighbours.push_back(rightNode);
 
-		  PathNode* bottomRightNode = current->GetNeighbour(int(bottomRight));
-		  PathNode* bottomNode = current->GetNeighbour(int(bottom));
+		  PathNodeId bottomRightNode = searchSpace->GetNeighbour(current, bottomRight);
+		  PathNodeId bottomNode = searchSpace->GetNeighbour(current, bottom);
 
 		  if (IsWalkable(bottomRightNode) && !IsWalkable(bottomNode))
 		  {
-			  bottomRightNode->isForced = flagForcedNodes;
+			  GetSearchState(bottomRightNode).isForced = flagForcedNodes;
 			  neighbours.push_back(bottomRightNode);
 		  }
 	  }
@@ -216,7 +240,7 @@ private:
   }
 
   // Get jump direction
-  JumpDirection GetJumpDirection(PathNode* fromNode, PathNode* toNode)
+  JumpDirection GetJumpDirection(PathNodeId fromNode, PathNodeId toNode)
   {
 	  // work out jump direction from normalised move
 	  // Straight moves: [1,0] [-1,0] [0,1] [0,-1]
@@ -260,23 +284,26 @@ private:
   }
 
   // Get normalised move
-  MathGeom::Vector2 GetNormalisedMove(PathNode* fromNode, PathNode* toNode)
+  MathGeom::Vector2 GetNormalisedMove(PathNodeId fromNode, PathNodeId toNode)
   {
+	  MathGeom::Vector3 fromPosition = searchSpace->GetNodePosition(fromNode);
+	  MathGeom::Vector3 toPosition = searchSpace->GetNodePosition(toNode);
+
 	  MathGeom::Vector2 dir;
-	  if (fromNode->position.x < toNode->position.x)
+	  if (fromPosition.x < toPosition.x)
 	  {
 		  dir.x = 1;
 	  }
-	  else if (fromNode->position.x > toNode->position.x)
+	  else if (fromPosition.x > toPosition.x)
 	  {
 		  dir.x = -1;
 	  }
 
-	  if (fromNode->position.z < toNode->position.z)
+	  if (fromPosition.z < toPosition.z)
 	  {
 		  dir.y = -1;
 	  }
-	  else if (fromNode->position.z > toNode->position.z)
+	  else if (fromPosition.z > toPosition.z)
 	  {
 		  dir.y = 1;
 	  }
@@ -285,17 +312,25 @@ private:
   }
 
   // Is walkable
-  bool IsWalkable(PathNode* node) { return node && node->type != PathNodeType::BLOCKED; }
+  bool IsWalkable(PathNodeId node) { return searchSpace->IsWalkable(node); }
 
-  // Jump
-  PathNode* Jump(PathNode* current, JumpDirection direction)
+protected:
+
+  // Jump (next jump point from current in the given direction, INVALID_PATH_NODE_ID if there is none)
+  virtual PathNodeId Jump(PathNodeId current, JumpDirection direction)
   {
-    PathNode* jumpPoint = current->neighbours[(int)direction];
+    PathNodeId jumpPoint = searchSpace->GetNeighbour(current, direction);
    
     if (!IsWalkable(jumpPoint))
     {
       // No way to jump outside the grid or to a blocked node
-      return nullptr;
+      return INVALID_PATH_NODE_ID;
+    }
+
+    if (IsDiagonalDirection(direction) && !searchSpace->IsValidAdjacency(current, jumpPoint))
+    {
+      // No way to jump between two blocked straight nodes
+      return INVALID_PATH_NODE_ID;
     }
 
     if (jumpPoint == goal)
@@ -315,7 +350,7 @@ private:
     {
       // find straight jump point
       std::array<JumpDirection, 2> straightDirections = GetStraightJumpDirections(direction);
-      if (Jump(jumpPoint, straightDirections[0]) || Jump(jumpPoint, straightDirections[1]))
+      if (Jump(jumpPoint, straightDirections[0]) != INVALID_PATH_NODE_ID || Jump(jumpPoint, straightDirections[1]) != INVALID_PATH_NODE_ID)
       {
         return jumpPoint;
       }
@@ -325,25 +360,27 @@ private:
     return Jump(jumpPoint, direction);
   }
 
+private:
+
   // Has forced neighbours
-  bool HasForcedNeighbours(PathNode* current, JumpDirection direction)
+  bool HasForcedNeighbours(PathNodeId current, JumpDirection direction)
   {
 	  bool hasForcedNeighbours = false;
 	  bool flagForcedNodes = true;
 
 	  // prune neighbours
-	  std::vector<PathNode*> neighbours;
+	  std::vector<PathNodeId> neighbours;
 	  Prune(current, neighbours, direction, flagForcedNodes);
 	  for (auto n : neighbours)
 	  {
-		  if (n->isForced)
+		  if (GetSearchState(n).isForced)
 		  {
 			  hasForcedNeighbours = true;
 
 			  // make sure we clear is forced flag
 			  for (auto nf : neighbours)
 			  {
-				  nf->isForced = false;
+				  GetSearchState(nf).isForced = false;
 			  }
 			  break;
 		  }
@@ -403,5 +440,8 @@ private:
   }
 };
 
+// Jump Point Search (octile heuristic)
+using JumpPointSearch = JumpPointSearchPlanner<>;
+
 #endif // !JUMP_POINT_SEARCH_H
 
@@ -0,0 +1,111 @@
+#ifndef JUMP_POINT_SEARCH_PLUS_H
+#define JUMP_POINT_SEARCH_PLUS_H
+
+#include <climits>
+
+#include "JumpPointSearch.h"
+#include "../SearchSpace/GridSearchSpace.h"
+
+// JPS+: Jump Point Search answering jumps from the grid jump distance table.
+// The table ignores the goal, so a jump only checks whether the goal is reached before the tabled stop:
+// along the move for straight moves, and from the (at most two) cells of a diagonal move that share
+// a row or a column with the goal for diagonal moves.
+// It finds the same jump points as JumpPointSearch, so both return the same paths.
+template<class Heuristic = OctileHeuristic>
+class JumpPointSearchPlusPlanner : public JumpPointSearchPlanner<Heuristic>
+{
+	// grid
+	std::shared_ptr<GridSearchSpace> grid;
+
+public:
+
+	// Constructor
+	JumpPointSearchPlusPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic_ = Heuristic())
+		: JumpPointSearchPlanner<Heuristic>(data, searchSpace, heuristic_)
+		, grid(std::dynamic_pointer_cast<GridSearchSpace>(searchSpace))
+	{
+		// jump distances are only available on grids built with SearchSpaceData::precomputeJumpDistances
+		assert(grid && grid->GetJumpDistances().IsBuilt());
+	}
+
+protected:
+
+	// Jump
+	PathNodeId Jump(PathNodeId current, PathNodeAdjacency direction) override
+	{
+		const JumpDistanceTable& jumpDistances = grid->GetJumpDistances();
+
+		int x = int(grid->GetCellX(current));
+		int z = int(grid->GetCellZ(current));
+		int goalX = int(grid->GetCellX(this->goal));
+		int goalZ = int(grid->GetCellZ(this->goal));
+		int dx = GRID_ADJACENCY_OFFSET_X[(int)direction];
+		int dz = GRID_ADJACENCY_OFFSET_Z[(int)direction];
+
+		JumpDistance distance = jumpDistances.Get(x, z, direction);
+
+		if (dx == 0 || dz == 0)
+		{
+			// straight move
+			if (IsGoalBefore(x, z, dx, dz, goalX, goalZ, distance))
+			{
+				return this->goal;
+			}
+
+			return distance > 0 ? grid->GetNodeId(x + dx * distance, z + dz * distance) : INVALID_PATH_NODE_ID;
+		}
+
+		// diagonal move, only the cells sharing a row or a column with the goal can reach it before the tabled stop
+		int steps = distance > 0 ? distance : INT_MAX;
+		int stepsToStop = distance > 0 ? distance : -distance;
+
+		int candidates[2] = { (goalZ - z) * dz, (goalX - x) * dx };
+		for (int candidate : candidates)
+		{
+			if (candidate >= 1 && candidate < stepsToStop && candidate < steps)
+			{
+				int cellX = x + dx * candidate;
+				int cellZ = z + dz * candidate;
+
+				if ((cellX == goalX && cellZ == goalZ)
+					|| IsGoalBefore(cellX, cellZ, dx, 0, goalX, goalZ, jumpDistances.Get(cellX, cellZ, dx > 0 ? PathNodeAdjacency::RIGHT : PathNodeAdjacency::LEFT))
+					|| IsGoalBefore(cellX, cellZ, 0, dz, goalX, goalZ, jumpDistances.Get(cellX, cellZ, dz > 0 ? PathNodeAdjacency::BOTTOM : PathNodeAdjacency::TOP)))
+				{
+					steps = candidate;
+				}
+			}
+		}
+
+		return steps != INT_MAX ? grid->GetNodeId(x + dx * steps, z + dz * steps) : INVALID_PATH_NODE_ID;
+	}
+
+private:
+
+	// Is goal before (moving straight from x, z, the goal is reached before the tabled stop)
+	static bool IsGoalBefore(int x, int z, int dx, int dz, int goalX, int goalZ, JumpDistance distance)
+	{
+		int goalDistance = 0;
+		if (dz == 0 && z == goalZ)
+		{
+			goalDistance = (goalX - x) * dx;
+		}
+		else if (dx == 0 && x == goalX)
+		{
+			goalDistance = (goalZ - z) * dz;
+		}
+
+		if (goalDistance <= 0)
+		{
+			// the goal is not along the move
+			return false;
+		}
+
+		// a jump point at the goal distance is the goal itself, a blocked cell must be further away
+		return distance > 0 ? goalDistance <= distance : goalDistance < -distance;
+	}
+};
+
+// JPS+ (octile heuristic)
+using JumpPointSearchPlus = JumpPointSearchPlusPlanner<>;
+
+#endif // !JUMP_POINT_SEARCH_PLUS_H
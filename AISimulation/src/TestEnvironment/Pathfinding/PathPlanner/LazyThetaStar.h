@@ -0,0 +1,329 @@
+#ifndef LAZY_THETA_STAR_H
+#define LAZY_THETA_STAR_H
+
+#include <limits>
+#include <algorithm>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+#include "../SearchSpace/GridSearchSpace.h"
+
+// Lazy Theta* (any-angle A* on grids).
+// A node reached from a closed node takes that node's parent as its own parent, as if it could see it, so paths
+// are made of straight segments between the corners they turn around instead of grid moves. The line of sight is
+// only checked when the node is closed: if the parent cannot be seen, the best closed neighbour becomes the parent.
+// That is one check per expansion rather than one per neighbour (Theta*), so the cost per expansion stays close
+// to A*. Costs are euclidean lengths, so the path does not need smoothing afterwards.
+class LazyThetaStar : public PathPlanner
+{
+	// open list
+	PathNodeHeap open;
+
+	// per-search node states
+	PathNodeSearchStates nodeStates;
+
+	// grid
+	std::shared_ptr<GridSearchSpace> grid;
+
+	// start/goal nodes
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+	MathGeom::Vector3 goalPosition;
+
+	// line of sight checks done by the current search
+	size_t lineOfSightChecks{ 0 };
+
+	// policies (any-angle costs)
+	EuclideanHeuristic heuristic;
+	EuclideanEdgeCost edgeCost;
+
+public:
+
+	// Constructor
+	LazyThetaStar(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
+		: PathPlanner(data, searchSpace)
+		, grid(std::dynamic_pointer_cast<GridSearchSpace>(searchSpace))
+	{
+		// line of sight is only available on grids
+		assert(grid);
+
+		// size node states up front (pages are allocated as the searches reach them)
+		nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Start search
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
+	{
+		// reset
+		Reset();
+
+		// set start/goal
+		this->start = start;
+		this->goal = goal;
+		goalPosition = searchSpace->GetNodePosition(goal);
+
+		// init open list (the start is its own parent)
+		PathNodeSearchState& startState = GetState(start);
+		startState.gCost = 0.0f;
+		startState.parent = start;
+		Open(start, startState);
+
+		// search
+		return Search();
+	}
+
+	// Resume search
+	bool ResumeSearch() final
+	{
+		// keep searching
+		return Search();
+	}
+
+	// Get path
+	void GetPath(Path& path) final
+	{
+		if (!pathFound)
+		{
+			return;
+		}
+
+		// go backwards to get the path (parents are in line of sight, so their positions are used as they are)
+		plannerPath.clear();
+
+		PathNodeId current = goal;
+		while (true)
+		{
+			plannerPath.push_back(current);
+			path.push_back(searchSpace->GetNodePosition(current));
+
+			PathNodeId parent = GetState(current).parent;
+			if (parent == current)
+			{
+				break;
+			}
+
+			current = parent;
+		}
+
+		// reverse the path
+		std::reverse(path.begin(), path.end());
+		std::reverse(plannerPath.begin(), plannerPath.end());
+	}
+
+	// Get line of sight checks (done by the current search)
+	size_t GetLineOfSightChecks() const { return lineOfSightChecks; }
+
+	// Reset
+	void Reset() final
+	{
+		searchCompleted = false;
+		pathFound = false;
+
+		revolutions = 0;
+		expansions = 0;
+		lineOfSightChecks = 0;
+
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
+
+		// clear open list
+		open.Clear();
+
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
+	}
+
+	// Debug Render
+	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
+	{
+		if (pathFound && (render.pathPlannerPath || render.finalPath))
+		{
+			Path path;
+			GetPath(path);
+
+			if (render.pathPlannerPath)
+			{
+				for (auto& node : plannerPath)
+				{
+					Transform transform;
+					transform.position = searchSpace->GetNodePosition(node);
+					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
+				}
+			}
+
+			if (render.finalPath)
+			{
+				for (auto& p : path)
+				{
+					Transform transform;
+					transform.position = p;
+					RenderUtils::RenderCube(viewProjection, transform, 0x00FF00);
+				}
+			}
+		}
+	}
+
+private:
+
+	// Search
+	bool Search()
+	{
+		int revolution = 0;
+		while (!open.IsEmpty())
+		{
+			revolutions++;
+
+			// get cheapest from open
+			PathNodeId current = open.Pop();
+			PathNodeSearchState& currentState = GetState(current);
+			currentState.list = PathNodeList::CLOSED;
+
+			// make sure the parent can be seen before using the node
+			SetVertex(current, currentState);
+
+			// check if the goal has been reached
+			if (current == goal)
+			{
+				pathFound = true;
+				break;
+			}
+
+			// Expand
+			Expand(current, currentState);
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				return false;
+			}
+		}
+
+		searchCompleted = true;
+		return true;
+	}
+
+	// Set vertex (if the parent cannot be seen, the parent becomes the closed neighbour the node is cheapest from)
+	void SetVertex(PathNodeId node, PathNodeSearchState& state)
+	{
+		if (state.parent == node)
+		{
+			return;
+		}
+
+		lineOfSightChecks++;
+		if (grid->HasLineOfSight(state.parent, node))
+		{
+			return;
+		}
+
+		MathGeom::Vector3 position = searchSpace->GetNodePosition(node);
+		state.gCost = GetInfinity();
+
+		// the node was reached from one of them, so there is always one
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(node, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			PathNodeId neighbour = neighbours[i];
+			if (!nodeStates.IsVisited(neighbour))
+			{
+				continue;
+			}
+
+			const PathNodeSearchState& neighbourState = nodeStates.Get(neighbour);
+			if (neighbourState.list != PathNodeList::CLOSED)
+			{
+				continue;
+			}
+
+			float gCost = neighbourState.gCost + edgeCost.Cost(neighbour, searchSpace->GetNodePosition(neighbour), node, position);
+			if (gCost < state.gCost)
+			{
+				state.gCost = gCost;
+				state.parent = neighbour;
+			}
+		}
+
+		assert(state.gCost != GetInfinity());
+	}
+
+	// Expand (neighbours are reached straight from the parent of the current node, checked when they are closed)
+	void Expand(PathNodeId current, const PathNodeSearchState& currentState)
+	{
+		PathNodeId origin = currentState.parent;
+		const PathNodeSearchState& originState = GetState(origin);
+		MathGeom::Vector3 originPosition = searchSpace->GetNodePosition(origin);
+
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			PathNodeId neighbour = neighbours[i];
+			PathNodeSearchState& neighbourState = GetState(neighbour);
+			if (neighbourState.list == PathNodeList::CLOSED)
+			{
+				continue;
+			}
+
+			float gCost = originState.gCost + edgeCost.Cost(origin, originPosition, neighbour, searchSpace->GetNodePosition(neighbour));
+			if (gCost >= neighbourState.gCost)
+			{
+				continue;
+			}
+
+			neighbourState.parent = origin;
+			neighbourState.gCost = gCost;
+
+			if (neighbourState.list == PathNodeList::OPEN)
+			{
+				// move it up in open
+				neighbourState.fCost = gCost + neighbourState.hCost;
+				open.DecreaseKey(neighbourState);
+			}
+			else
+			{
+				// push in open
+				Open(neighbour, neighbourState);
+			}
+		}
+	}
+
+	// Open
+	void Open(PathNodeId node, PathNodeSearchState& state)
+	{
+		state.list = PathNodeList::OPEN;
+		state.hCost = heuristic.Estimate(node, searchSpace->GetNodePosition(node), goal, goalPosition);
+		state.fCost = state.gCost + state.hCost;
+		open.Push(node, state);
+	}
+
+	// Get state (nodes not reached yet have an infinite cost)
+	PathNodeSearchState& GetState(PathNodeId node)
+	{
+		bool isVisited = nodeStates.IsVisited(node);
+
+		PathNodeSearchState& state = nodeStates.Get(node);
+		if (!isVisited)
+		{
+			state.gCost = GetInfinity();
+		}
+
+		return state;
+	}
+
+	// Get infinity
+	static float GetInfinity() { return std::numeric_limits<float>::infinity(); }
+};
+
+#endif // !LAZY_THETA_STAR_H
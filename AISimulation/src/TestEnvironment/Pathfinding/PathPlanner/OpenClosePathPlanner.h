@@ -1,36 +1,50 @@
 #ifndef OPEN_CLOSE_PATH_PLANNER_H
 #define OPEN_CLOSE_PATH_PLANNER_H
 
-#include <list>
+#include <vector>
+#include <algorithm>
 
 #include "PathPlanner.h"
+#include "PathNodeHeap.h"
 
 class OpenClosePathPlanner : public PathPlanner
 {
 protected:
 
-	// open and closed list
-	std::list<PathNode*> open;
-	std::list<PathNode*> close;
+	// open list (indexed binary heap)
+	PathNodeHeap open;
+
+	// per-search node states (costs, parent and open/closed membership) indexed by node id
+	PathNodeSearchStates nodeStates;
 
 	// start/goal nodes
-	PathNode* start{ nullptr };
-	PathNode* goal{ nullptr };
+	PathNodeId start{ INVALID_PATH_NODE_ID };
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+
+	// goal position (used by every heuristic evaluation)
+	MathGeom::Vector3 goalPosition;
+
+	// cell costs of the search space (edge costs are scaled by them)
+	const CellCostTable* cellCosts{ nullptr };
 
 private:
 
 	// Expand
-	virtual void Expand(PathNode* current) = 0;
+	virtual void Expand(PathNodeId current) = 0;
 
 public:
 	// Constructors
 	OpenClosePathPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace)
 		: PathPlanner(data, searchSpace)
 	{
+		// size node states up front (pages are allocated as the searches reach them)
+		nodeStates.Init(searchSpace->GetNodeCount());
+
+		cellCosts = searchSpace->GetCellCosts();
 	}
 
 	// Start search
-	bool StartSearch(PathNode* start, PathNode* goal) final
+	bool StartSearch(PathNodeId start, PathNodeId goal) final
 	{
 		// reset
 		Reset();
@@ -38,9 +52,10 @@ public:
 		// set start/goal
 		this->start = start;
 		this->goal = goal;
+		goalPosition = searchSpace->GetNodePosition(goal);
 
 		// init open list
-		open.push_back(start);
+		Open(start);
 
 		// search
 		return Search();
@@ -60,26 +75,26 @@ public:
 		{
 			// go backwards to get the path
 
-			auto node = close.back();
-			PathNode* current = node;
-			PathNode* parent = node->parent;
+			auto node = goal;
+			PathNodeId current = node;
+			PathNodeId parent = GetSearchState(node).parent;
 			
 			plannerPath.clear();
 			plannerPath.push_back(current);
 
-			path.push_back(node->position);
+			path.push_back(searchSpace->GetNodePosition(node));
 
-			while (parent)
+			while (parent != INVALID_PATH_NODE_ID)
 			{
 				plannerPath.push_back(parent);
 
 				// make sure that adjacency between current node and parent node is valid
 				node = searchSpace->GetValidatedPathNode(current, parent);
 				
-				path.push_back(node->position);
+				path.push_back(searchSpace->GetNodePosition(node));
 
 				current = parent;
-				parent = parent->parent;
+				parent = GetSearchState(parent).parent;
 			}
 
 			// reverse the path
@@ -91,7 +106,7 @@ public:
 	// Debug Render
 	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) final
 	{
-		if (start && goal && (render.pathPlannerPath || render.finalPath))
+		if (start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID && (render.pathPlannerPath || render.finalPath))
 		{
 			Path path;
 			GetPath(path);
@@ -101,7 +116,7 @@ public:
 				for (auto& node : plannerPath)
 				{
 					Transform transform;
-					transform.position = node->position;
+					transform.position = searchSpace->GetNodePosition(node);
 					RenderUtils::RenderCube(viewProjection, transform, 0xFF0000);
 				}
 			}
@@ -125,85 +140,116 @@ public:
 		searchCompleted = false;
 		pathFound = false;
 
-		// clear lists
-		auto ClearList = [this](std::list<PathNode*>& list)
-		{
-			// reset nodes 
-			for (auto& node : list)
-			{
-				node->fCost = 0.0f;
-				node->gCost = 0.0f;
-				node->hCost = 0.0f;
-				node->parent = nullptr;
-				node->isForced = false;
-			}
+		revolutions = 0;
+		expansions = 0;
 
-			list.clear();
-		};
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
 
-		ClearList(open);
-		ClearList(close);
+		// clear open list
+		open.Clear();
 
-		start = nullptr;
-		goal = nullptr;
+		start = INVALID_PATH_NODE_ID;
+		goal = INVALID_PATH_NODE_ID;
 	}
 	
 protected:
 
-	// Update cost
-	void UpdateCost(PathNode* current, PathNode* neighbour)
+	// Get search state
+	PathNodeSearchState& GetSearchState(PathNodeId node)
 	{
-		if (std::find(close.begin(), close.end(), neighbour) != close.end())
+		return nodeStates.Get(node);
+	}
+
+	// Update cost (with the heuristic and edge cost policies of the planner)
+	template<class Heuristic, class EdgeCost>
+	void UpdateCost(PathNodeId current, PathNodeId neighbour, const Heuristic& heuristic, const EdgeCost& edgeCost)
+	{
+		PathNodeSearchState& currentState = GetSearchState(current);
+		PathNodeSearchState& neighbourState = GetSearchState(neighbour);
+
+		if (neighbourState.list == PathNodeList::CLOSED)
 		{
 			// ignore if it is in close
 			return;
 		}
 
-		if (std::find(open.begin(), open.end(), neighbour) != open.end())
+		MathGeom::Vector3 neighbourPosition = searchSpace->GetNodePosition(neighbour);
+		float gCost = currentState.gCost + edgeCost.Cost(current, searchSpace->GetNodePosition(current), neighbour, neighbourPosition);
+
+		if (neighbourState.list == PathNodeList::OPEN)
 		{
 			// check if this path is better
-			float gCost = current->gCost + DistanceEuclidean(current, neighbour);
-			if (gCost < neighbour->gCost)
+			if (gCost < neighbourState.gCost)
 			{
 				// update neighbour
-				neighbour->parent = current;
-				neighbour->gCost = gCost;
-				neighbour->fCost = neighbour->hCost + gCost;
+				neighbourState.parent = current;
+				neighbourState.gCost = gCost;
+				neighbourState.fCost = neighbourState.hCost + gCost;
+
+				// move it up in open
+				open.DecreaseKey(neighbourState);
 			}
 		}
 		else
 		{
 			// update neighbour
-			neighbour->parent = current;
-			neighbour->hCost = DistanceManhattan(neighbour, goal);
-			neighbour->gCost = current->gCost + DistanceEuclidean(current, neighbour);
-			neighbour->fCost = neighbour->hCost + neighbour->gCost;
+			neighbourState.parent = current;
+			neighbourState.hCost = heuristic.Estimate(neighbour, neighbourPosition, goal, goalPosition);
+			neighbourState.gCost = gCost;
+			neighbourState.fCost = neighbourState.hCost + neighbourState.gCost;
 
 			// push in open
-			open.push_back(neighbour);
+			Open(neighbour);
 		}
 	}
 
+	// Open
+	void Open(PathNodeId node)
+	{
+		PathNodeSearchState& state = GetSearchState(node);
+		state.list = PathNodeList::OPEN;
+		open.Push(node, state);
+	}
+
+	// Close
+	void Close(PathNodeId node)
+	{
+		GetSearchState(node).list = PathNodeList::CLOSED;
+	}
+
 private:
 
 	// Search
 	bool Search()
 	{
 		int revolution = 0;
-		while (open.size() > 0)
+		while (!open.IsEmpty())
 		{
+			revolutions++;
+
 			// get cheapest from open
-			auto current = PopCheapestFromOpen();
+			auto current = open.Pop();
 			if (current == goal)
 			{
 				// path found!
 				pathFound = true;
-				close.push_back(current);
+				Close(current);
 				break;
 			}
 
 			// Expand
 			Expand(current);
+			expansions++;
 
 			// check search allowance
 			if (revolution++ >= maxRevolutions)
@@ -213,51 +259,10 @@ private:
 			}
 		}
 
-		searchCompleted = (pathFound || open.size() == 0);
+		searchCompleted = (pathFound || open.IsEmpty());
 
 		return searchCompleted;
 	}
-
-	// Pop cheapest from open
-	PathNode* PopCheapestFromOpen()
-	{
-		PathNode* cheapest = open.front();
-		auto cheapestIterator = open.begin();
-		for (auto nodeIterator = open.begin(); nodeIterator != open.end(); ++nodeIterator)
-		{
-			PathNode* node = *nodeIterator;
-			if (node->fCost < cheapest->fCost)
-			{
-				cheapestIterator = nodeIterator;
-				cheapest = *cheapestIterator;
-			}
-			else if (node->fCost == cheapest->fCost && node->hCost < cheapest->hCost)
-			{
-				cheapestIterator = nodeIterator;
-				cheapest = *cheapestIterator;
-			}
-		}
-
-		open.erase(cheapestIterator);
-
-		return cheapest;
-	}
-
-	// Distance Euclidean
-	float DistanceEuclidean(PathNode* nodeA, PathNode* nodeB)
-	{
-		return MathGeom::Distance(nodeA->position, nodeB->position);
-	}	
-
-	// Distance Manhattan
-	float DistanceManhattan(PathNode* nodeA, PathNode* nodeB)
-	{
-		float dx = fabsf(nodeA->position.x - nodeB->position.x);
-		float dy = fabsf(nodeA->position.y - nodeB->position.y);
-		float dz = fabsf(nodeA->position.z - nodeB->position.z);
-
-		return dx + dy + dz;
-	}
 };
 
 #endif // !OPEN_CLOSE_PATH_PLANNER_H
@@ -0,0 +1,190 @@
+#ifndef PATH_NODE_HEAP_H
+#define PATH_NODE_HEAP_H
+
+#include <vector>
+
+#include "PathNodeSearchState.h"
+
+// Indexed binary min-heap of nodes ordered by fCost (hCost breaks ties).
+// Every node keeps its position in the heap in its search state so membership
+// is O(1) and a node whose cost decreased can be moved up in O(log n) (decrease-key).
+class PathNodeHeap
+{
+	// heap entry (costs are copied so comparisons stay in the heap memory)
+	struct Entry
+	{
+		float fCost;
+		float hCost;
+		PathNodeId node;
+		PathNodeSearchState* state;
+	};
+
+	// heap
+	std::vector<Entry> heap;
+
+public:
+
+	// Is empty
+	bool IsEmpty() const { return heap.empty(); }
+
+	// Size
+	size_t Size() const { return heap.size(); }
+
+	// Push
+	void Push(PathNodeId node, PathNodeSearchState& state)
+	{
+		assert(state.heapPosition == INVALID_HEAP_POSITION);
+
+		heap.push_back({ state.fCost, state.hCost, node, &state });
+		state.heapPosition = int(heap.size() - 1);
+
+		SiftUp(heap.size() - 1);
+	}
+
+	// Pop
+	PathNodeId Pop()
+	{
+		assert(!IsEmpty());
+
+		Entry top = heap.front();
+		top.state->heapPosition = INVALID_HEAP_POSITION;
+
+		Entry last = heap.back();
+		heap.pop_back();
+
+		if (!heap.empty())
+		{
+			Place(last, 0);
+			SiftDown(0);
+		}
+
+		return top.node;
+	}
+
+	// Decrease key (the node cost has been lowered)
+	void DecreaseKey(PathNodeSearchState& state)
+	{
+		assert(state.heapPosition != INVALID_HEAP_POSITION);
+
+		Entry& entry = heap[state.heapPosition];
+		entry.fCost = state.fCost;
+		entry.hCost = state.hCost;
+
+		SiftUp(state.heapPosition);
+	}
+
+	// Top (cheapest node, the heap must not be empty)
+	PathNodeId Top() const
+	{
+		assert(!IsEmpty());
+		return heap.front().node;
+	}
+
+	// Get top costs (costs the cheapest node was ordered by)
+	float GetTopFCost() const { assert(!IsEmpty()); return heap.front().fCost; }
+	float GetTopHCost() const { assert(!IsEmpty()); return heap.front().hCost; }
+
+	// Update (the node costs have been lowered or raised)
+	void Update(PathNodeSearchState& state)
+	{
+		assert(state.heapPosition != INVALID_HEAP_POSITION);
+
+		Entry& entry = heap[state.heapPosition];
+		entry.fCost = state.fCost;
+		entry.hCost = state.hCost;
+
+		SiftUp(state.heapPosition);
+		SiftDown(state.heapPosition);
+	}
+
+	// Remove
+	void Remove(PathNodeSearchState& state)
+	{
+		assert(state.heapPosition != INVALID_HEAP_POSITION);
+
+		size_t position = size_t(state.heapPosition);
+		state.heapPosition = INVALID_HEAP_POSITION;
+
+		Entry last = heap.back();
+		heap.pop_back();
+
+		if (position < heap.size())
+		{
+			Place(last, position);
+			SiftUp(position);
+			SiftDown(last.state->heapPosition);
+		}
+	}
+
+	// Clear (the positions kept in the search states are discarded along with their search generation)
+	void Clear()
+	{
+		heap.clear();
+	}
+
+private:
+
+	// Is cheaper
+	static bool IsCheaper(const Entry& a, const Entry& b)
+	{
+		return a.fCost < b.fCost || (a.fCost == b.fCost && a.hCost < b.hCost);
+	}
+
+	// Sift up
+	void SiftUp(size_t position)
+	{
+		Entry entry = heap[position];
+		while (position > 0)
+		{
+			size_t parent = (position - 1) / 2;
+			if (!IsCheaper(entry, heap[parent]))
+			{
+				break;
+			}
+
+			Place(heap[parent], position);
+			position = parent;
+		}
+
+		Place(entry, position);
+	}
+
+	// Sift down
+	void SiftDown(size_t position)
+	{
+		Entry entry = heap[position];
+		size_t size = heap.size();
+		while (true)
+		{
+			size_t child = position * 2 + 1;
+			if (child >= size)
+			{
+				break;
+			}
+
+			if (child + 1 < size && IsCheaper(heap[child + 1], heap[child]))
+			{
+				child++;
+			}
+
+			if (!IsCheaper(heap[child], entry))
+			{
+				break;
+			}
+
+			Place(heap[child], position);
+			position = child;
+		}
+
+		Place(entry, position);
+	}
+
+	// Place
+	void Place(const Entry& entry, size_t position)
+	{
+		heap[position] = entry;
+		entry.state->heapPosition = int(position);
+	}
+};
+
+#endif // !PATH_NODE_HEAP_H
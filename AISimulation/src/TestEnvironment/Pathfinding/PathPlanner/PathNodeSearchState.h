@@ -0,0 +1,181 @@
+#ifndef PATH_NODE_SEARCH_STATE_H
+#define PATH_NODE_SEARCH_STATE_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include "../PathNode.h"
+
+// heap position of a node that is not in the heap
+static const int INVALID_HEAP_POSITION = -1;
+
+// PathNodeList
+enum class PathNodeList : unsigned char
+{
+	NONE,
+	OPEN,
+	CLOSED
+};
+
+// Per-search scratch data of a node.
+// It is owned by the planner so the search space graph is never written during a search.
+struct PathNodeSearchState
+{
+	// generation of the search this state belongs to
+	unsigned generation{ 0 };
+
+	// list the node belongs to
+	PathNodeList list{ PathNodeList::NONE };
+
+	// for JPS
+	bool isForced{ false };
+
+	// position in the open heap
+	int heapPosition{ INVALID_HEAP_POSITION };
+
+	// costs
+	float hCost{ 0.0f };
+	float gCost{ 0.0f };
+	float fCost{ 0.0f };
+
+	// for D* Lite (one step lookahead cost)
+	float rhsCost{ 0.0f };
+
+	// parent node
+	PathNodeId parent{ INVALID_PATH_NODE_ID };
+};
+
+// states per page (as a power of two)
+static const size_t PATH_NODE_SEARCH_STATE_PAGE_BITS = 6;
+static const size_t PATH_NODE_SEARCH_STATE_PAGE_SIZE = size_t(1) << PATH_NODE_SEARCH_STATE_PAGE_BITS;
+
+// pages per block (as a power of two)
+static const size_t PATH_NODE_SEARCH_STATE_BLOCK_BITS = 10;
+static const size_t PATH_NODE_SEARCH_STATE_BLOCK_SIZE = size_t(1) << PATH_NODE_SEARCH_STATE_BLOCK_BITS;
+
+// Search states indexed by node id.
+// A state stamped with an older generation is treated as unvisited, so
+// resetting every state between searches is a single increment.
+// States are allocated in pages the first time a node of the page is visited, and pages in blocks,
+// so memory follows the area searched rather than the size of the search space (one pointer per block of nodes).
+class PathNodeSearchStates
+{
+	using Page = std::unique_ptr<PathNodeSearchState[]>;
+	using Block = std::unique_ptr<Page[]>;
+
+	// blocks of pages
+	std::vector<Block> blocks;
+
+	// node count
+	size_t size{ 0 };
+
+	// current search generation
+	unsigned generation{ 1 };
+
+public:
+
+	// Init
+	void Init(size_t nodeCount)
+	{
+		const size_t BLOCK_NODES = PATH_NODE_SEARCH_STATE_PAGE_SIZE * PATH_NODE_SEARCH_STATE_BLOCK_SIZE;
+
+		size = nodeCount;
+		blocks.clear();
+		blocks.resize((nodeCount + BLOCK_NODES - 1) / BLOCK_NODES);
+		generation = 1;
+	}
+
+	// Size
+	size_t Size() const { return size; }
+
+	// Reset
+	void Reset()
+	{
+		generation++;
+
+		if (generation == 0)
+		{
+			// generation wrapped around, so stale stamps could be mistaken for current ones
+			for (auto& block : blocks)
+			{
+				for (size_t i = 0; block && i < PATH_NODE_SEARCH_STATE_BLOCK_SIZE; i++)
+				{
+					Page& page = block[i];
+					if (page)
+					{
+						std::fill(page.get(), page.get() + PATH_NODE_SEARCH_STATE_PAGE_SIZE, PathNodeSearchState());
+					}
+				}
+			}
+
+			generation = 1;
+		}
+	}
+
+	// Is visited
+	bool IsVisited(PathNodeId node) const 
+	{ 
+		const Block& block = blocks[node >> (PATH_NODE_SEARCH_STATE_PAGE_BITS + PATH_NODE_SEARCH_STATE_BLOCK_BITS)];
+		if (!block)
+		{
+			return false;
+		}
+
+		const Page& page = block[(node >> PATH_NODE_SEARCH_STATE_PAGE_BITS) & (PATH_NODE_SEARCH_STATE_BLOCK_SIZE - 1)];
+		return page && page[node & (PATH_NODE_SEARCH_STATE_PAGE_SIZE - 1)].generation == generation; 
+	}
+
+	// Get state
+	PathNodeSearchState& Get(PathNodeId node)
+	{
+		assert(node < size);
+
+		Block& block = blocks[node >> (PATH_NODE_SEARCH_STATE_PAGE_BITS + PATH_NODE_SEARCH_STATE_BLOCK_BITS)];
+		if (!block)
+		{
+			block.reset(new Page[PATH_NODE_SEARCH_STATE_BLOCK_SIZE]());
+		}
+
+		Page& page = block[(node >> PATH_NODE_SEARCH_STATE_PAGE_BITS) & (PATH_NODE_SEARCH_STATE_BLOCK_SIZE - 1)];
+		if (!page)
+		{
+			page.reset(new PathNodeSearchState[PATH_NODE_SEARCH_STATE_PAGE_SIZE]);
+		}
+
+		PathNodeSearchState& state = page[node & (PATH_NODE_SEARCH_STATE_PAGE_SIZE - 1)];
+		if (state.generation != generation)
+		{
+			state = PathNodeSearchState();
+			state.generation = generation;
+		}
+
+		return state;
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const
+	{
+		size_t memoryUsage = blocks.size() * sizeof(Block);
+		for (auto& block : blocks)
+		{
+			if (!block)
+			{
+				continue;
+			}
+
+			memoryUsage += PATH_NODE_SEARCH_STATE_BLOCK_SIZE * sizeof(Page);
+			for (size_t i = 0; i < PATH_NODE_SEARCH_STATE_BLOCK_SIZE; i++)
+			{
+				if (block[i])
+				{
+					memoryUsage += PATH_NODE_SEARCH_STATE_PAGE_SIZE * sizeof(PathNodeSearchState);
+				}
+			}
+		}
+
+		return memoryUsage;
+	}
+};
+
+#endif // !PATH_NODE_SEARCH_STATE_H
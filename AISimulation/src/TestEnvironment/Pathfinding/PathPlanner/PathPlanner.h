@@ -4,15 +4,29 @@
 #include "../PathNode.h"
 #include "../SearchSpace/SearchSpace.h"
 #include "../PathfinderDebugRenderFlags.h"
+#include "PathPlannerPolicies.h"
 
 // number of revolutions that the algorithm can perform
 static const int DEFAULT_MAX_REVOLUTIONS = 200;
 
+// heuristic weight of the first search of the anytime planner and how much each following search lowers it
+static const float DEFAULT_ANYTIME_INITIAL_WEIGHT = 3.0f;
+static const float DEFAULT_ANYTIME_WEIGHT_STEP = 0.5f;
+
 // Path planner data
 struct PathPlannerData
 {
 	PathPlannerType type;
 	int maxRevolutions = DEFAULT_MAX_REVOLUTIONS;
+
+	// heuristic of the open/close planners (a weight above 1 trades the shortest path for fewer expansions,
+	// LANDMARK needs a grid built with SearchSpaceData::landmarkCount)
+	PathPlannerHeuristic heuristic{ PathPlannerHeuristic::OCTILE };
+	float heuristicWeight{ 1.0f };
+
+	// weights of the anytime planner (the first path costs at most anytimeInitialWeight times the shortest one)
+	float anytimeInitialWeight{ DEFAULT_ANYTIME_INITIAL_WEIGHT };
+	float anytimeWeightStep{ DEFAULT_ANYTIME_WEIGHT_STEP };
 };
 
 // Abstrac path planner
@@ -21,28 +35,38 @@ class PathPlanner
 
 protected:
 
+	// type
+	PathPlannerType type;
+
 	bool searchCompleted{ false };
 	bool pathFound{ false };
 
 	int maxRevolutions{ DEFAULT_MAX_REVOLUTIONS };
 
+	// revolutions performed by the current search
+	size_t revolutions{ 0 };
+
+	// nodes expanded by the current search
+	size_t expansions{ 0 };
+
 	// search space
 	std::shared_ptr<SearchSpace> searchSpace;
 
 	// planner path (for debugging purpose)
-	std::vector<PathNode*> plannerPath;
+	std::vector<PathNodeId> plannerPath;
 
 public:
 
 	// Constructors
 	PathPlanner(const PathPlannerData& data, std::shared_ptr<SearchSpace> searchSpace_)
-		: maxRevolutions(data.maxRevolutions)
+		: type(data.type)
+		, maxRevolutions(data.maxRevolutions)
 		, searchSpace(searchSpace_)
 	{
 	}
 
 	// Start search
-	virtual bool StartSearch(PathNode* start, PathNode* goal) = 0;
+	virtual bool StartSearch(PathNodeId start, PathNodeId goal) = 0;
 
 	// Resume search
 	virtual bool ResumeSearch() = 0;
@@ -50,8 +74,32 @@ public:
 	// Get path
 	virtual void GetPath(Path& path) = 0;
 
+	// Get improved path (anytime planners hand over a path found before the search is completed, once per path)
+	virtual bool GetImprovedPath(Path& path) { return false; }
+
+	// Finds shortest paths (its paths always cost as much as the shortest paths with octile edge costs)
+	virtual bool FindsShortestPaths() const { return false; }
+
 	// Reset
 	virtual void Reset() = 0;
+
+	// Get type
+	PathPlannerType GetType() const { return type; }
+
+	// Is search completed
+	bool IsSearchCompleted() const { return searchCompleted; }
+
+	// Get max revolutions (per search slice)
+	int GetMaxRevolutions() const { return maxRevolutions; }
+
+	// Get revolutions
+	size_t GetRevolutions() const { return revolutions; }
+
+	// Get expansions
+	size_t GetExpansions() const { return expansions; }
+
+	// Get planner path (nodes of the last path returned by GetPath, before they are validated)
+	const std::vector<PathNodeId>& GetPlannerPath() const { return plannerPath; }
 	
 	// Debug render
 	virtual void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render) = 0;
@@ -0,0 +1,210 @@
+#ifndef PATH_PLANNER_POLICIES_H
+#define PATH_PLANNER_POLICIES_H
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "../PathNode.h"
+#include "../SearchSpace/LandmarkTable.h"
+#include "../SearchSpace/LayerLinkTable.h"
+#include "../SearchSpace/CellCostTable.h"
+
+// Heuristic and edge cost policies of the planners.
+// They are template parameters, so the compiler inlines them in the expansion loop instead of calling through a
+// virtual function. A heuristic estimates the cost from a node to the goal:
+//     float Estimate(PathNodeId node, const MathGeom::Vector3& position, PathNodeId goal, const MathGeom::Vector3& goalPosition) const
+// and tells whether it never overestimates that cost on grids with octile edge costs (the planners only find the
+// shortest paths with such heuristics):
+//     static const bool ADMISSIBLE
+// and an edge cost gives the cost of the move between two nodes of a path:
+//     float Cost(PathNodeId fromNode, const MathGeom::Vector3& from, PathNodeId toNode, const MathGeom::Vector3& to) const
+
+// PathPlannerHeuristic (heuristic of the planners that take one)
+enum class PathPlannerHeuristic
+{
+	OCTILE,
+	EUCLIDEAN,
+	MANHATTAN,
+	LANDMARK,
+	LAYER
+};
+
+// sqrt(2) - 1 (extra cost of a diagonal move over a straight one, per cell)
+static const float OCTILE_DIAGONAL_EXTRA_COST = 0.41421356f;
+
+// Octile heuristic (exact on an open 8-connected grid, admissible and consistent with octile edge costs;
+// the height between layers is added, so it is nothing on flat grids)
+struct OctileHeuristic
+{
+	static const bool ADMISSIBLE = true;
+
+	float Estimate(PathNodeId, const MathGeom::Vector3& position, PathNodeId, const MathGeom::Vector3& goalPosition) const
+	{
+		float dx = fabsf(position.x - goalPosition.x);
+		float dz = fabsf(position.z - goalPosition.z);
+
+		return std::max(dx, dz) + OCTILE_DIAGONAL_EXTRA_COST * std::min(dx, dz) + fabsf(position.y - goalPosition.y);
+	}
+};
+
+// Euclidean heuristic (admissible and consistent with any edge cost not shorter than the straight line, needs a sqrt)
+struct EuclideanHeuristic
+{
+	static const bool ADMISSIBLE = true;
+
+	float Estimate(PathNodeId, const MathGeom::Vector3& position, PathNodeId, const MathGeom::Vector3& goalPosition) const
+	{
+		return MathGeom::Distance(position, goalPosition);
+	}
+};
+
+// Manhattan heuristic (overestimates diagonal moves, so paths are found faster but may not be the shortest ones)
+struct ManhattanHeuristic
+{
+	static const bool ADMISSIBLE = false;
+
+	float Estimate(PathNodeId, const MathGeom::Vector3& position, PathNodeId, const MathGeom::Vector3& goalPosition) const
+	{
+		return fabsf(position.x - goalPosition.x) + fabsf(position.y - goalPosition.y) + fabsf(position.z - goalPosition.z);
+	}
+};
+
+// Landmark heuristic (ALT, the largest of the octile and the landmark bounds, octile alone while the grid has no landmarks)
+struct LandmarkHeuristic
+{
+	static const bool ADMISSIBLE = true;
+
+	const LandmarkTable* landmarks{ nullptr };
+
+	// Constructors
+	LandmarkHeuristic() = default;
+	explicit LandmarkHeuristic(const LandmarkTable* landmarks_)
+		: landmarks(landmarks_)
+	{
+	}
+
+	float Estimate(PathNodeId node, const MathGeom::Vector3& position, PathNodeId goal, const MathGeom::Vector3& goalPosition) const
+	{
+		float estimate = OctileHeuristic().Estimate(node, position, goal, goalPosition);
+		if (landmarks && landmarks->IsBuilt())
+		{
+			estimate = std::max(estimate, landmarks->Estimate(node, goal));
+		}
+
+		return estimate;
+	}
+};
+
+// Layer heuristic (octile in the layer of the goal; from another layer, the path has to leave the layer of the node
+// through one of its links, so it costs at least octile to the closest link, the link and octile from its end to the
+// goal; octile alone on search spaces without layers)
+struct LayerHeuristic
+{
+	static const bool ADMISSIBLE = true;
+
+	const LayerLinkTable* layerLinks{ nullptr };
+
+	// Constructors
+	LayerHeuristic() = default;
+	explicit LayerHeuristic(const LayerLinkTable* layerLinks_)
+		: layerLinks(layerLinks_)
+	{
+	}
+
+	float Estimate(PathNodeId node, const MathGeom::Vector3& position, PathNodeId goal, const MathGeom::Vector3& goalPosition) const
+	{
+		OctileHeuristic octile;
+		float estimate = octile.Estimate(node, position, goal, goalPosition);
+		if (!layerLinks || !layerLinks->IsBuilt())
+		{
+			return estimate;
+		}
+
+		size_t layer = layerLinks->GetLayer(node);
+		if (layer == layerLinks->GetLayer(goal))
+		{
+			return estimate;
+		}
+
+		// a layer without links can not reach the goal, octile is kept so the estimate stays finite
+		auto& exits = layerLinks->GetLayerExits(layer);
+		float throughExit = exits.empty() ? estimate : FLT_MAX;
+		for (auto& exit : exits)
+		{
+			float cost = octile.Estimate(node, position, exit.from, exit.fromPosition)
+				+ octile.Estimate(exit.from, exit.fromPosition, exit.to, exit.toPosition)
+				+ octile.Estimate(exit.to, exit.toPosition, goal, goalPosition);
+
+			throughExit = std::min(throughExit, cost);
+		}
+
+		return std::max(estimate, throughExit);
+	}
+};
+
+// Weighted heuristic (weight times another heuristic, paths cost at most weight times the shortest one
+// when the heuristic is admissible)
+template<class Heuristic>
+struct WeightedHeuristic
+{
+	// admissible with weights up to 1 only, so never treated as admissible
+	static const bool ADMISSIBLE = false;
+
+	Heuristic heuristic;
+	float weight{ 1.0f };
+
+	// Constructors
+	WeightedHeuristic() = default;
+	WeightedHeuristic(const Heuristic& heuristic_, float weight_)
+		: heuristic(heuristic_)
+		, weight(weight_)
+	{
+	}
+
+	float Estimate(PathNodeId node, const MathGeom::Vector3& position, PathNodeId goal, const MathGeom::Vector3& goalPosition) const
+	{
+		return weight * heuristic.Estimate(node, position, goal, goalPosition);
+	}
+};
+
+// Octile edge cost (cell size and sqrt(2) times the cell size between adjacent cells, and exact along the
+// straight and diagonal lines JPS jumps over, without a sqrt; links between layers also cost the height climbed).
+// With cell costs, moves are scaled by the mean multiplier of both cells, so they must be between adjacent nodes
+// (JPS does not jump on grids with costs).
+struct OctileEdgeCost
+{
+	// cell costs (nullptr or without costs: every move costs its length)
+	const CellCostTable* cellCosts{ nullptr };
+
+	OctileEdgeCost() = default;
+	explicit OctileEdgeCost(const CellCostTable* cellCosts)
+		: cellCosts(cellCosts)
+	{
+	}
+
+	float Cost(PathNodeId fromNode, const MathGeom::Vector3& from, PathNodeId toNode, const MathGeom::Vector3& to) const
+	{
+		float dx = fabsf(from.x - to.x);
+		float dz = fabsf(from.z - to.z);
+
+		float cost = std::max(dx, dz) + OCTILE_DIAGONAL_EXTRA_COST * std::min(dx, dz) + fabsf(from.y - to.y);
+		if (cellCosts && cellCosts->HasCosts())
+		{
+			cost *= cellCosts->GetMoveMultiplier(fromNode, toNode);
+		}
+
+		return cost;
+	}
+};
+
+// Euclidean edge cost (straight line between any two nodes)
+struct EuclideanEdgeCost
+{
+	float Cost(PathNodeId fromNode, const MathGeom::Vector3& from, PathNodeId toNode, const MathGeom::Vector3& to) const
+	{
+		return MathGeom::Distance(from, to);
+	}
+};
+
+#endif // !PATH_PLANNER_POLICIES_H
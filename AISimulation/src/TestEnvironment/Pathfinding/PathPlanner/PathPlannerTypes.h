@@ -4,7 +4,14 @@
 enum class PathPlannerType
 {
 	A_STAR,
-	JUMP_POINT_SEARCH
+	JUMP_POINT_SEARCH,
+	BIT_JUMP_POINT_SEARCH,
+	JUMP_POINT_SEARCH_PLUS,
+	HIERARCHICAL_A_STAR,
+	D_STAR_LITE,
+	BIDIRECTIONAL_A_STAR,
+	ANYTIME_A_STAR,
+	LAZY_THETA_STAR
 };
 
 #include "PathPlanner.h"
@@ -12,6 +19,13 @@ enum class PathPlannerType
 
 #include "AStar.h"
 #include "JumpPointSearch.h"
+#include "BitJumpPointSearch.h"
+#include "JumpPointSearchPlus.h"
+#include "HierarchicalPathPlanner.h"
+#include "DStarLite.h"
+#include "BidirectionalAStar.h"
+#include "AnytimeAStar.h"
+#include "LazyThetaStar.h"
 
 #endif // !PATH_PLANNER_TYPES_H
 
@@ -0,0 +1,211 @@
+#ifndef REVERSE_DIJKSTRA_SEARCH_H
+#define REVERSE_DIJKSTRA_SEARCH_H
+
+#include <vector>
+#include <unordered_set>
+
+#include "PathPlanner.h"
+#include "PathNodeHeap.h"
+
+// Dijkstra search from a goal towards many starts.
+// Nodes are settled by their cost to the goal, so once a start is settled following its parents leads to the goal
+// along a shortest path. It expands outwards until every start is settled, which serves all the requests that share
+// the goal with a single search. Moves are assumed to be symmetric (true on grids), so the search follows
+// the valid neighbours of each node backwards.
+class ReverseDijkstraSearch
+{
+	// search space
+	std::shared_ptr<SearchSpace> searchSpace;
+
+	// open list and per-search node states
+	PathNodeHeap open;
+	PathNodeSearchStates nodeStates;
+
+	// goal
+	PathNodeId goal{ INVALID_PATH_NODE_ID };
+
+	// starts not settled yet
+	std::unordered_set<PathNodeId> pendingStarts;
+
+	// revolutions per slice
+	int maxRevolutions{ DEFAULT_MAX_REVOLUTIONS };
+
+	// revolutions and expansions performed by the current search
+	size_t revolutions{ 0 };
+	size_t expansions{ 0 };
+
+	// edge cost policy
+	OctileEdgeCost edgeCost;
+
+public:
+
+	// Constructor
+	ReverseDijkstraSearch(std::shared_ptr<SearchSpace> searchSpace_, int maxRevolutions_)
+		: searchSpace(searchSpace_)
+		, maxRevolutions(maxRevolutions_)
+		, edgeCost(searchSpace_->GetCellCosts())
+	{
+		nodeStates.Init(searchSpace->GetNodeCount());
+	}
+
+	// Start search (true if the search is completed)
+	bool StartSearch(PathNodeId goal, const std::vector<PathNodeId>& starts)
+	{
+		// reset
+		Reset();
+
+		// set goal/starts
+		this->goal = goal;
+		pendingStarts.insert(starts.begin(), starts.end());
+
+		// init open list
+		Open(goal);
+
+		// search
+		return Search();
+	}
+
+	// Resume search (true if the search is completed)
+	bool ResumeSearch()
+	{
+		return Search();
+	}
+
+	// Get path (from the start to the goal, empty if the start has not been reached)
+	void GetPath(PathNodeId start, Path& path)
+	{
+		if (!nodeStates.IsVisited(start) || nodeStates.Get(start).list != PathNodeList::CLOSED)
+		{
+			return;
+		}
+
+		PathNodeId current = start;
+		PathNodeId parent = nodeStates.Get(start).parent;
+
+		path.push_back(searchSpace->GetNodePosition(start));
+
+		while (parent != INVALID_PATH_NODE_ID)
+		{
+			// make sure that adjacency between current node and parent node is valid
+			PathNodeId node = searchSpace->GetValidatedPathNode(current, parent);
+
+			path.push_back(searchSpace->GetNodePosition(node));
+
+			current = parent;
+			parent = nodeStates.Get(parent).parent;
+		}
+	}
+
+	// Reset
+	void Reset()
+	{
+		revolutions = 0;
+		expansions = 0;
+
+		// reset node states
+		size_t nodeCount = searchSpace->GetNodeCount();
+		if (nodeStates.Size() != nodeCount)
+		{
+			nodeStates.Init(nodeCount);
+		}
+		else
+		{
+			// states from previous searches become stale
+			nodeStates.Reset();
+		}
+
+		// clear open list
+		open.Clear();
+		pendingStarts.clear();
+
+		goal = INVALID_PATH_NODE_ID;
+	}
+
+	// Get revolutions
+	size_t GetRevolutions() const { return revolutions; }
+
+	// Get expansions
+	size_t GetExpansions() const { return expansions; }
+
+private:
+
+	// Search
+	bool Search()
+	{
+		int revolution = 0;
+		while (!open.IsEmpty() && !pendingStarts.empty())
+		{
+			revolutions++;
+
+			// get cheapest from open
+			PathNodeId current = open.Pop();
+			nodeStates.Get(current).list = PathNodeList::CLOSED;
+			pendingStarts.erase(current);
+
+			// Expand
+			Expand(current);
+			expansions++;
+
+			// check search allowance
+			if (revolution++ >= maxRevolutions)
+			{
+				// allowance surpassed so exit and continue next frame
+				break;
+			}
+		}
+
+		return open.IsEmpty() || pendingStarts.empty();
+	}
+
+	// Expand
+	void Expand(PathNodeId current)
+	{
+		MathGeom::Vector3 currentPosition = searchSpace->GetNodePosition(current);
+		float currentCost = nodeStates.Get(current).gCost;
+
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace->GetValidNeighbours(current, neighbours);
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			PathNodeId neighbour = neighbours[i];
+			PathNodeSearchState& neighbourState = nodeStates.Get(neighbour);
+
+			if (neighbourState.list == PathNodeList::CLOSED)
+			{
+				// ignore if it is in close
+				continue;
+			}
+
+			float gCost = currentCost + edgeCost.Cost(current, currentPosition, neighbour, searchSpace->GetNodePosition(neighbour));
+			if (neighbourState.list == PathNodeList::OPEN)
+			{
+				if (gCost < neighbourState.gCost)
+				{
+					// update neighbour and move it up in open
+					neighbourState.parent = current;
+					neighbourState.gCost = gCost;
+					neighbourState.fCost = gCost;
+					open.DecreaseKey(neighbourState);
+				}
+			}
+			else
+			{
+				// update neighbour and push in open
+				neighbourState.parent = current;
+				neighbourState.gCost = gCost;
+				neighbourState.fCost = gCost;
+				Open(neighbour);
+			}
+		}
+	}
+
+	// Open
+	void Open(PathNodeId node)
+	{
+		PathNodeSearchState& state = nodeStates.Get(node);
+		state.list = PathNodeList::OPEN;
+		open.Push(node, state);
+	}
+};
+
+#endif // !REVERSE_DIJKSTRA_SEARCH_H
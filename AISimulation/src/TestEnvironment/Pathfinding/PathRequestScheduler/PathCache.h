@@ -0,0 +1,192 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <list>
+#include <unordered_map>
+
+#include "PathRequest.h"
+
+// default memory the cached paths can take (bytes)
+static const size_t DEFAULT_PATH_CACHE_MEMORY_CAP = 1 << 20;
+
+// Path cache key
+struct PathCacheKey
+{
+	PathNodeId start;
+	PathNodeId goal;
+	PathPlannerType plannerType;
+
+	bool operator==(const PathCacheKey& other) const
+	{
+		return start == other.start && goal == other.goal && plannerType == other.plannerType;
+	}
+};
+
+// Path cache key hash
+struct PathCacheKeyHash
+{
+	size_t operator()(const PathCacheKey& key) const
+	{
+		uint64_t nodes = (uint64_t(key.start) << 32) | key.goal;
+		return std::hash<uint64_t>()(nodes) ^ (size_t(key.plannerType) * 0x9E3779B97F4A7C15ull);
+	}
+};
+
+// Path cache stats
+struct PathCacheStats
+{
+	size_t hits{ 0 };
+	size_t misses{ 0 };
+
+	// entries added and entries evicted to stay under the memory cap
+	size_t insertions{ 0 };
+	size_t evictions{ 0 };
+
+	// times the cache was emptied because the search space changed
+	size_t invalidations{ 0 };
+
+	// Get hit rate
+	float GetHitRate() const { return hits + misses > 0 ? float(hits) / float(hits + misses) : 0.0f; }
+};
+
+// Cache of path results keyed by the localised start/goal nodes and the planner type (the scheduler clears it
+// when its planners are replaced, since planners of one type may differ in heuristic or weight).
+// Least recently used results are evicted to stay under the memory cap, and every result is dropped
+// as soon as the search space version changes (cells changed since they were found).
+class PathCache
+{
+	// Entry
+	struct Entry
+	{
+		PathCacheKey key;
+		PathRequestResultStatus resultStatus;
+		Path path;
+	};
+
+	// entries (most recently used first)
+	std::list<Entry> entries;
+
+	// index to find an entry in O(1)
+	std::unordered_map<PathCacheKey, std::list<Entry>::iterator, PathCacheKeyHash> index;
+
+	// search space version of the entries
+	size_t version{ 0 };
+
+	// memory
+	size_t memoryUsage{ 0 };
+	size_t memoryCap{ DEFAULT_PATH_CACHE_MEMORY_CAP };
+
+	// stats
+	PathCacheStats stats;
+
+public:
+
+	// Find (false if there is no result for the key on this search space version)
+	bool Find(const PathCacheKey& key, size_t searchSpaceVersion, PathRequestResultStatus& resultStatus, Path& path)
+	{
+		SetVersion(searchSpaceVersion);
+
+		auto entryIt = index.find(key);
+		if (entryIt == index.end())
+		{
+			stats.misses++;
+			return false;
+		}
+
+		// most recently used
+		entries.splice(entries.begin(), entries, entryIt->second);
+
+		resultStatus = entryIt->second->resultStatus;
+		path = entryIt->second->path;
+
+		stats.hits++;
+		return true;
+	}
+
+	// Insert (results found on an older search space version are ignored)
+	void Insert(const PathCacheKey& key, size_t searchSpaceVersion, PathRequestResultStatus resultStatus, const Path& path)
+	{
+		SetVersion(searchSpaceVersion);
+		if (searchSpaceVersion != version || index.find(key) != index.end())
+		{
+			return;
+		}
+
+		size_t entryMemoryUsage = GetMemoryUsage(path);
+		if (entryMemoryUsage > memoryCap)
+		{
+			return;
+		}
+
+		entries.push_front({ key, resultStatus, path });
+		index[key] = entries.begin();
+		memoryUsage += entryMemoryUsage;
+		stats.insertions++;
+
+		Evict();
+	}
+
+	// Clear (the version is forgotten too, a new search space may have a lower one)
+	void Clear()
+	{
+		entries.clear();
+		index.clear();
+		memoryUsage = 0;
+		version = 0;
+	}
+
+	// Set memory cap (bytes, 0 disables the cache)
+	void SetMemoryCap(size_t cap)
+	{
+		memoryCap = cap;
+		Evict();
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return memoryUsage; }
+
+	// Get size
+	size_t Size() const { return entries.size(); }
+
+	// Get stats
+	const PathCacheStats& GetStats() const { return stats; }
+
+private:
+
+	// Set version (entries of another version are dropped)
+	void SetVersion(size_t searchSpaceVersion)
+	{
+		if (searchSpaceVersion > version)
+		{
+			if (!entries.empty())
+			{
+				stats.invalidations++;
+			}
+
+			Clear();
+			version = searchSpaceVersion;
+		}
+	}
+
+	// Evict (least recently used entries until the memory cap is met)
+	void Evict()
+	{
+		while (memoryUsage > memoryCap && !entries.empty())
+		{
+			Entry& entry = entries.back();
+			memoryUsage -= GetMemoryUsage(entry.path);
+			index.erase(entry.key);
+			entries.pop_back();
+			stats.evictions++;
+		}
+	}
+
+	// Get memory usage of an entry (bytes, including its list and index nodes)
+	static size_t GetMemoryUsage(const Path& path)
+	{
+		return sizeof(Entry) + 2 * sizeof(void*) + sizeof(std::pair<PathCacheKey, std::list<Entry>::iterator>) + 2 * sizeof(void*)
+			+ path.size() * sizeof(MathGeom::Vector3);
+	}
+};
+
+#endif // !PATH_CACHE_H
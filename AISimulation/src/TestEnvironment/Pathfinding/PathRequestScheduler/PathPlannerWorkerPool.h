@@ -0,0 +1,249 @@
+#ifndef PATH_PLANNER_WORKER_POOL_H
+#define PATH_PLANNER_WORKER_POOL_H
+
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "PathRequest.h"
+
+#include "../PathPlanner/PathPlanner.h"
+
+// Pool of worker threads, each one owning a PathPlanner instance (and so its own per-search state).
+// Workers run searches to completion against the shared search space, which is only read while searching.
+// Results are collected by the thread that owns the pool, so request callbacks are never called from a worker.
+// Running searches check a cancel flag between slices (maxRevolutions), so Interrupt/Stop do not wait for whole searches.
+class PathPlannerWorkerPool
+{
+public:
+
+	// Job
+	struct Job
+	{
+		PathRequestId id;
+		PathNodeId start;
+		PathNodeId goal;
+		MathGeom::Vector3 startPosition;
+		MathGeom::Vector3 goalPosition;
+	};
+
+	// Result
+	struct Result
+	{
+		PathRequestId id;
+		PathRequestResultStatus resultStatus;
+		Path path;
+	};
+
+private:
+
+	// planners (one per worker)
+	std::vector<std::shared_ptr<PathPlanner>> planners;
+
+	// worker threads
+	std::vector<std::thread> workers;
+
+	// pending jobs
+	std::deque<Job> jobs;
+
+	// completed jobs
+	std::vector<Result> results;
+
+	// jobs being processed by a worker
+	size_t runningJobs{ 0 };
+
+	// synchronisation
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobsIdle;
+	bool stopping{ false };
+
+	// running searches are abandoned at the end of their current slice
+	std::atomic<bool> cancelling{ false };
+
+public:
+
+	// Destructor
+	~PathPlannerWorkerPool()
+	{
+		Stop();
+	}
+
+	// Start
+	void Start(const std::vector<std::shared_ptr<PathPlanner>>& workerPlanners)
+	{
+		Stop();
+
+		planners = workerPlanners;
+		stopping = false;
+
+		for (auto& planner : planners)
+		{
+			workers.emplace_back(&PathPlannerWorkerPool::Run, this, planner);
+		}
+	}
+
+	// Stop (pending jobs and results are discarded)
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			cancelling = true;
+			jobs.clear();
+		}
+
+		jobAvailable.notify_all();
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		workers.clear();
+		planners.clear();
+		results.clear();
+		runningJobs = 0;
+		cancelling = false;
+	}
+
+	// Interrupt (pending jobs and results are discarded, running searches are abandoned and workers keep waiting for jobs)
+	void Interrupt()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cancelling = true;
+		jobs.clear();
+
+		jobsIdle.wait(lock, [this]() { return runningJobs == 0; });
+
+		results.clear();
+		cancelling = false;
+	}
+
+	// Is running
+	bool IsRunning() const { return !workers.empty(); }
+
+	// Get worker count
+	size_t GetWorkerCount() const { return workers.size(); }
+
+	// Push job
+	void PushJob(const Job& job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(job);
+		}
+
+		jobAvailable.notify_one();
+	}
+
+	// Remove job (only if it is still pending)
+	void RemoveJob(PathRequestId id)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto jobIt = jobs.begin(); jobIt != jobs.end(); ++jobIt)
+		{
+			if (jobIt->id == id)
+			{
+				jobs.erase(jobIt);
+				return;
+			}
+		}
+	}
+
+	// Pop results
+	void PopResults(std::vector<Result>& completed)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		completed.swap(results);
+		results.clear();
+	}
+
+	// Get pending job count (queued or being processed)
+	size_t GetPendingJobCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return jobs.size() + runningJobs;
+	}
+
+private:
+
+	// Run
+	void Run(std::shared_ptr<PathPlanner> planner)
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+				if (stopping)
+				{
+					return;
+				}
+
+				job = jobs.front();
+				jobs.pop_front();
+				runningJobs++;
+			}
+
+			// search until the search is completed (paths found before by anytime planners are pushed as provisional results)
+			bool searchCompleted = planner->StartSearch(job.start, job.goal);
+			while (!searchCompleted && !cancelling)
+			{
+				PushImprovedPath(job, *planner);
+				searchCompleted = planner->ResumeSearch();
+			}
+
+			if (!searchCompleted)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				runningJobs--;
+				jobsIdle.notify_all();
+				continue;
+			}
+
+			Result result{ job.id, PathRequestResultStatus::PathNotFound, Path() };
+			planner->GetPath(result.path);
+
+			// override start/goal position
+			if (result.path.size() > 0)
+			{
+				result.path[0] = job.startPosition;
+				result.path[result.path.size() - 1] = job.goalPosition;
+				result.resultStatus = PathRequestResultStatus::PathFound;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				results.emplace_back(std::move(result));
+				runningJobs--;
+			}
+
+			jobsIdle.notify_all();
+		}
+	}
+
+	// Push improved path (as a provisional result, if the planner found one since the last call)
+	void PushImprovedPath(const Job& job, PathPlanner& planner)
+	{
+		Result result{ job.id, PathRequestResultStatus::PathFound_Provisional, Path() };
+		if (!planner.GetImprovedPath(result.path) || result.path.empty())
+		{
+			return;
+		}
+
+		// override start/goal position
+		result.path[0] = job.startPosition;
+		result.path[result.path.size() - 1] = job.goalPosition;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		results.emplace_back(std::move(result));
+	}
+};
+
+#endif // !PATH_PLANNER_WORKER_POOL_H
@@ -2,6 +2,8 @@
 #define PATH_REQUEST_H
 
 #include <vector>
+#include <chrono>
+#include <memory>
 #include <functional>
 
 // PathRequestId
@@ -17,17 +19,38 @@ enum class PathRequestResultStatus
 
 	PathNotFound_StartBlocked,
 	PathNotFound_GoalBlocked,
+
+	// start and goal are in parts of the search space that no path joins (known without searching)
+	PathNotFound_GoalUnreachable,
+
+	// the search space cannot serve the request (flow fields are only built on whole grids)
+	PathNotFound_SearchSpaceNotSupported,
 		
-	PathFound
+	PathFound,
+
+	// path found by an anytime planner that is still looking for a shorter one (a better path, or the final one
+	// with PathFound, follows until the request is cancelled)
+	PathFound_Provisional
 };
 
 // OnPathRequestResult
 using OnPathRequestResult = std::function<void(PathRequestId id, PathRequestResultStatus resultStatus, Path& path)>;
 
+// FlowField
+class FlowField;
+
+// OnFlowFieldRequestResult
+using OnFlowFieldRequestResult = std::function<void(PathRequestId id, PathRequestResultStatus resultStatus, std::shared_ptr<const FlowField> flowField)>;
+
 // PathRequestPriority
 enum class PathRequestPriority
 {
-	NORMAL
+	LOW,		// background agents
+	NORMAL,
+	HIGH,		// visible agents
+	CRITICAL,	// player-facing agents
+
+	MAX_PRIORITY
 };
 
 // PathRequestData
@@ -36,6 +59,14 @@ struct PathRequestData
 	MathGeom::Vector3 start;
 	MathGeom::Vector3 goal;
 	PathRequestPriority priority{ PathRequestPriority::NORMAL };
+
+	// time from the request until the search should start (0 for no deadline)
+	std::chrono::milliseconds deadline{ 0 };
+
+	// keep the path updated as cells change (searched with D* Lite, the result is notified again
+	// every time cell changes alter the path, until the request is cancelled)
+	bool keepUpdated{ false };
+
 	OnPathRequestResult onPathRequestResult;
 };
 
@@ -54,6 +85,32 @@ struct PathRequest
 	PathRequestId id;
 	PathRequestData data;
 	State state;
+
+	// time the request was added
+	std::chrono::steady_clock::time_point enqueueTime;
+
+	// localised start/goal and search space version of the running search (to cache its result)
+	PathNodeId startNode{ INVALID_PATH_NODE_ID };
+	PathNodeId goalNode{ INVALID_PATH_NODE_ID };
+	size_t searchSpaceVersion{ 0 };
+
+	// merged into the search of another request at least once (interrupted requests may be merged again)
+	bool coalesced{ false };
+};
+
+// FlowFieldRequestData
+struct FlowFieldRequestData
+{
+	MathGeom::Vector3 goal;
+
+	OnFlowFieldRequestResult onFlowFieldRequestResult;
 };
-#endif // !PATH_REQUEST_H
 
+// FlowFieldRequest
+struct FlowFieldRequest
+{
+	PathRequestId id;
+	FlowFieldRequestData data;
+};
+
+#endif // !PATH_REQUEST_H
@@ -1,14 +1,91 @@
 #ifndef PATH_REQUEST_QUEUE_H
 #define PATH_REQUEST_QUEUE_H
 
-#include <deque>
+#include <list>
+#include <vector>
+#include <map>
+#include <array>
+#include <chrono>
+#include <unordered_map>
 
 #include "PathRequest.h"
 
+// time a request waits before it is considered one priority level higher
+static const std::chrono::milliseconds DEFAULT_PATH_REQUEST_AGING_INTERVAL{ 250 };
+
+// time before its deadline at which a request overtakes any priority
+static const std::chrono::milliseconds DEFAULT_PATH_REQUEST_DEADLINE_URGENCY{ 16 };
+
+// Path request wait histogram (bucket i counts waits in [2^(i-1), 2^i) milliseconds, bucket 0 waits under 1ms)
+struct PathRequestWaitHistogram
+{
+	static const size_t BUCKET_COUNT = 16;
+
+	std::array<size_t, BUCKET_COUNT> buckets{};
+	size_t count{ 0 };
+	std::chrono::microseconds total{ 0 };
+	std::chrono::microseconds longest{ 0 };
+
+	// Add
+	void Add(std::chrono::microseconds wait)
+	{
+		size_t bucket = 0;
+		for (long long ms = wait.count() / 1000; ms > 0 && bucket < BUCKET_COUNT - 1; ms >>= 1)
+		{
+			bucket++;
+		}
+
+		buckets[bucket]++;
+		count++;
+		total += wait;
+		longest = std::max(longest, wait);
+	}
+
+	// Get average
+	std::chrono::microseconds GetAverage() const { return count > 0 ? std::chrono::microseconds(total.count() / count) : std::chrono::microseconds(0); }
+};
+
+// Path request queue stats (for one priority)
+struct PathRequestQueueStats
+{
+	// requests waiting
+	size_t depth{ 0 };
+
+	// waits of the requests that left the queue to be searched
+	PathRequestWaitHistogram waitHistogram;
+};
+
+// Path request queue.
+// Requests are served by priority, raised one level every aging interval so low priorities never starve.
+// Requests close to their deadline overtake everything else (earliest deadline first).
 class PathRequestQueue
 {
-	// queue
-	std::deque<PathRequest*> queue;
+	using Clock = std::chrono::steady_clock;
+
+	// Entry (where a request lives in the queue)
+	struct Entry
+	{
+		PathRequestPriority priority;
+		std::list<PathRequest*>::iterator queueIt;
+		std::multimap<Clock::time_point, PathRequest*>::iterator deadlineIt;
+		bool hasDeadline;
+	};
+
+	// queue for each priority (oldest first)
+	std::array<std::list<PathRequest*>, (int)PathRequestPriority::MAX_PRIORITY> queues;
+
+	// requests with a deadline (earliest first)
+	std::multimap<Clock::time_point, PathRequest*> deadlines;
+
+	// index to find a request in O(1)
+	std::unordered_map<PathRequestId, Entry> index;
+
+	// stats for each priority
+	std::array<PathRequestQueueStats, (int)PathRequestPriority::MAX_PRIORITY> stats;
+
+	// aging and deadline urgency
+	std::chrono::microseconds agingInterval{ DEFAULT_PATH_REQUEST_AGING_INTERVAL };
+	std::chrono::microseconds deadlineUrgency{ DEFAULT_PATH_REQUEST_DEADLINE_URGENCY };
 
 public:
 
@@ -17,9 +94,33 @@ public:
 	{
 		switch (request.data.priority)
 		{
+		case PathRequestPriority::LOW:
 		case PathRequestPriority::NORMAL:
+		case PathRequestPriority::HIGH:
+		case PathRequestPriority::CRITICAL:
 		{
-			queue.push_back(&request);
+			assert(index.find(request.id) == index.end());
+
+			Entry entry;
+			entry.priority = request.data.priority;
+
+			// keep the queue sorted by enqueue time (interrupted requests are enqueued again with their original time)
+			auto& queue = queues[(int)entry.priority];
+			auto queueIt = queue.end();
+			while (queueIt != queue.begin() && (*std::prev(queueIt))->enqueueTime > request.enqueueTime)
+			{
+				--queueIt;
+			}
+			entry.queueIt = queue.insert(queueIt, &request);
+
+			entry.hasDeadline = request.data.deadline.count() > 0;
+			if (entry.hasDeadline)
+			{
+				entry.deadlineIt = deadlines.emplace(request.enqueueTime + request.data.deadline, &request);
+			}
+
+			index[request.id] = entry;
+			stats[(int)entry.priority].depth++;
 			return true;
 		}
 		default:
@@ -33,28 +134,119 @@ public:
 	// Remove
 	void Remove(PathRequestId requestId)
 	{
-		for (auto requestIt = queue.begin(); requestIt != queue.end(); ++requestIt)
+		auto entryIt = index.find(requestId);
+		if (entryIt == index.end())
 		{
-			if ((*requestIt)->id == requestId)
+			return;
+		}
+
+		Entry& entry = entryIt->second;
+		queues[(int)entry.priority].erase(entry.queueIt);
+		if (entry.hasDeadline)
+		{
+			deadlines.erase(entry.deadlineIt);
+		}
+
+		stats[(int)entry.priority].depth--;
+		index.erase(entryIt);
+	}
+
+	// Get request (next request to be served)
+	PathRequest* GetRequest()
+	{
+		auto now = Clock::now();
+
+		// a request close to its deadline goes first
+		if (!deadlines.empty() && deadlines.begin()->first - now <= deadlineUrgency)
+		{
+			return deadlines.begin()->second;
+		}
+
+		// otherwise the oldest request of the highest aged priority
+		PathRequest* request = nullptr;
+		long long requestPriority = 0;
+		for (size_t priority = 0; priority < queues.size(); priority++)
+		{
+			if (queues[priority].empty())
 			{
-				queue.erase(requestIt);
-				return;
+				continue;
+			}
+
+			PathRequest* candidate = queues[priority].front();
+			long long candidatePriority = priority + (now - candidate->enqueueTime) / agingInterval;
+			if (!request
+				|| candidatePriority > requestPriority
+				|| (candidatePriority == requestPriority && candidate->enqueueTime < request->enqueueTime))
+			{
+				request = candidate;
+				requestPriority = candidatePriority;
 			}
 		}
+
+		return request;
 	}
 
-	// Get request
-	PathRequest* GetRequest()
+	// Dequeue (remove the next request to be served and record its wait)
+	PathRequest* Dequeue()
+	{
+		PathRequest* request = GetRequest();
+		if (request)
+		{
+			Dequeue(*request);
+		}
+
+		return request;
+	}
+
+	// Dequeue matching (remove every request the predicate accepts, oldest first within each priority, and record their waits)
+	template<typename Predicate>
+	void DequeueMatching(Predicate matches, std::vector<PathRequest*>& matching)
 	{
-		if (queue.size() > 0)
+		size_t first = matching.size();
+		for (auto& queue : queues)
 		{
-			return queue.front();
+			for (PathRequest* request : queue)
+			{
+				if (matches(*request))
+				{
+					matching.push_back(request);
+				}
+			}
 		}
 
-		return nullptr;
+		for (size_t i = first; i < matching.size(); i++)
+		{
+			Dequeue(*matching[i]);
+		}
+	}
+
+	// Size
+	size_t Size() const { return index.size(); }
+
+	// Get stats
+	const PathRequestQueueStats& GetStats(PathRequestPriority priority) const { return stats[(int)priority]; }
+
+	// Set aging interval
+	void SetAgingInterval(std::chrono::microseconds interval)
+	{
+		assert(interval.count() > 0);
+		agingInterval = interval;
+	}
+
+	// Set deadline urgency
+	void SetDeadlineUrgency(std::chrono::microseconds urgency) { deadlineUrgency = urgency; }
+
+private:
+
+	// Dequeue (remove the request and record its wait)
+	void Dequeue(PathRequest& request)
+	{
+		auto wait = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - request.enqueueTime);
+		stats[(int)request.data.priority].waitHistogram.Add(wait);
+
+		Remove(request.id);
 	}
 };
 
 
 #endif // !PATH_REQUEST_QUEUE_H
-
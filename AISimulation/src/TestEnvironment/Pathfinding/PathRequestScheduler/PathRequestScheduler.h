@@ -2,16 +2,112 @@
 #define PATH_REQUEST_SCHEDULER_H
 
 #include <map>
+#include <deque>
+#include <chrono>
+#include <algorithm>
 
 #include "PathRequest.h"
 #include "PathRequestQueue.h"
+#include "PathCache.h"
+#include "PathPlannerWorkerPool.h"
 
 #include "../PathfinderDebugRenderFlags.h"
 #include "../SearchSpace/SearchSpace.h"
 #include "../PathPlanner/PathPlanner.h"
+#include "../PathPlanner/ReverseDijkstraSearch.h"
+#include "../PathPlanner/DStarLite.h"
+#include "../SearchSpace/GridSearchSpace.h"
+#include "../FlowField/FlowFieldCache.h"
+#include "../PathSmoother/PathSmoother.h"
+
+// Path request scheduler data
+struct PathRequestSchedulerData
+{
+	// number of worker threads searching concurrently (0 means searching on the thread that calls Update)
+	size_t workerCount{ 0 };
+
+	// number of searches that can be suspended at the same time (each one uses its own planner)
+	size_t maxActiveSearches{ 1 };
+
+	// memory the path cache can take (bytes, 0 disables the cache)
+	size_t pathCacheMemoryCap{ DEFAULT_PATH_CACHE_MEMORY_CAP };
+
+	// search queued requests that share the goal of a starting search along with it (searches on worker threads are not coalesced,
+	// and neither are the searches of planners that do not find the shortest paths the search from the goal finds)
+	bool coalesceRequests{ true };
+
+	// memory the flow field cache can take (bytes, 0 disables the cache)
+	size_t flowFieldCacheMemoryCap{ DEFAULT_FLOW_FIELD_CACHE_MEMORY_CAP };
+
+	// post-processing of the paths notified (on grids, cached paths are stored before it)
+	PathSmoothing pathSmoothing{ PathSmoothing::NONE };
+};
+
+// Path request scheduler frame stats
+struct PathRequestSchedulerFrameStats
+{
+	// time allowed and time spent in the last update
+	std::chrono::microseconds budget{ 0 };
+	std::chrono::microseconds used{ 0 };
+
+	// search slices (up to maxRevolutions each) run in the last update
+	size_t slices{ 0 };
+
+	// requests completed in the last update
+	size_t completedRequests{ 0 };
+
+	// requests completed from the path cache in the last update (no search needed)
+	size_t cacheHits{ 0 };
+
+	// queued requests merged into the search of another request with the same goal in the last update
+	size_t coalescedRequests{ 0 };
+
+	// flow field requests completed in the last update
+	size_t flowFieldRequests{ 0 };
+
+	// provisional paths (found by anytime planners before their search is completed) notified in the last update
+	size_t provisionalPaths{ 0 };
+
+	// requests rejected in the last update because their goal cannot be reached from their start (no search needed)
+	size_t unreachableRequests{ 0 };
+
+	// Get budget usage (fraction of the budget that has been used)
+	float GetBudgetUsage() const { return budget.count() > 0 ? float(used.count()) / float(budget.count()) : 0.0f; }
+};
 
 class PathRequestScheduler
 {
+	using Clock = std::chrono::steady_clock;
+
+	// Search slot (a search that can be suspended and resumed)
+	struct SearchSlot
+	{
+		std::shared_ptr<PathPlanner> pathPlanner;
+		PathRequest* request{ nullptr };
+
+		// requests sharing the goal of the request, all of them searched at once from the goal
+		std::vector<PathRequest*> coalescedRequests;
+		std::shared_ptr<ReverseDijkstraSearch> goalSearch;
+		bool searchingFromGoal{ false };
+	};
+
+	// Kept updated path (a request whose path is repaired as cells change)
+	struct KeptUpdatedPath
+	{
+		PathRequestId id;
+		PathRequestData data;
+
+		// planner keeping the search tree (created by the first update)
+		std::shared_ptr<DStarLite> pathPlanner;
+
+		// last path notified
+		Path path;
+		bool notified{ false };
+
+		// cells changed since the last notification
+		bool cellsChanged{ false };
+	};
+
 	// path requests
 	std::map<PathRequestId, PathRequest> requests;
 
@@ -24,13 +120,46 @@ class PathRequestScheduler
 	// search space
 	std::shared_ptr<SearchSpace> searchSpace;
 
-	// path planner
-	std::shared_ptr<PathPlanner> pathPlanner;
+	// search slots (one path planner each)
+	std::vector<SearchSlot> searchSlots;
+	size_t nextSearchSlot{ 0 };
+
+	// planner of the last search started (for debugging purpose)
+	std::shared_ptr<PathPlanner> lastPathPlanner;
+
+	// worker pool (searches run on worker threads while it is running)
+	PathPlannerWorkerPool workerPool;
+	std::vector<std::shared_ptr<PathPlanner>> workerPlanners;
+	PathPlannerType workerPlannerType;
+
+	// kept updated paths
+	std::map<PathRequestId, KeptUpdatedPath> keptUpdatedPaths;
+
+	// path cache
+	PathCache pathCache;
+
+	// request coalescing
+	bool coalesceRequests{ true };
+	size_t coalescedRequestCount{ 0 };
+
+	// flow field requests (served in order, each one by a single build or a cache hit)
+	std::deque<FlowFieldRequest> flowFieldRequests;
+	FlowFieldCache flowFieldCache;
+
+	// path smoothing
+	PathSmoothing pathSmoothing{ PathSmoothing::NONE };
+	PathSmoother pathSmoother;
+
+	// positions the search space is streamed around (set by the caller, e.g. agents) and those of the requests
+	std::vector<MathGeom::Vector3> streamingPositions;
+	std::vector<MathGeom::Vector3> streamedPositions;
 
 	// last start and goal
 	MathGeom::Vector3 lastStart;
 	MathGeom::Vector3 lastGoal;
 
+	// last update stats
+	PathRequestSchedulerFrameStats frameStats;
 
 public:
 
@@ -38,19 +167,77 @@ public:
 	void Init(std::shared_ptr<SearchSpace> searchSpace, std::shared_ptr<PathPlanner> pathPlanner)
 	{
 		this->searchSpace = searchSpace;
-		this->pathPlanner = pathPlanner;
+		SetPathPlanner(pathPlanner);
 	}
 
 	// Set search space
 	void SetSearchSpace(std::shared_ptr<SearchSpace> searchSpace)
 	{
+		// running searches belong to the previous search space, they are queued again (their planners must be
+		// replaced too, see Pathfinder::SetSearchSpace)
+		workerPool.Interrupt();
+		InterruptSearches();
+
 		this->searchSpace = searchSpace;
+
+		// cached paths, flow fields, goal searches and kept updated searches belong to the previous search space
+		pathCache.Clear();
+		flowFieldCache.Clear();
+		for (auto& slot : searchSlots)
+		{
+			slot.goalSearch = nullptr;
+		}
+
+		for (auto& entry : keptUpdatedPaths)
+		{
+			entry.second.pathPlanner = nullptr;
+		}
 	}
 
 	// Set path planner
 	void SetPathPlanner(std::shared_ptr<PathPlanner> pathPlanner)
 	{
-		this->pathPlanner = pathPlanner;
+		SetPathPlanners({ pathPlanner });
+	}
+
+	// Set path planners (one search slot per planner)
+	void SetPathPlanners(const std::vector<std::shared_ptr<PathPlanner>>& pathPlanners)
+	{
+		// a running search can not be resumed by a different planner, so start it again
+		InterruptSearches();
+
+		// cached paths are keyed by planner type only, so the paths of the previous planners (e.g. another
+		// heuristic or weight) must not be served as results of the new ones
+		pathCache.Clear();
+
+		searchSlots.clear();
+		for (auto& pathPlanner : pathPlanners)
+		{
+			SearchSlot slot;
+			slot.pathPlanner = pathPlanner;
+			searchSlots.push_back(slot);
+		}
+
+		nextSearchSlot = 0;
+		lastPathPlanner = nullptr;
+	}
+
+	// Set worker planners (one worker thread per planner, none to search on the thread that calls Update)
+	void SetWorkerPlanners(const std::vector<std::shared_ptr<PathPlanner>>& workerPlanners)
+	{
+		// stop current workers and queue again the requests being searched
+		workerPool.Stop();
+		InterruptSearches();
+
+		// cached paths of the previous planners (see SetPathPlanners)
+		pathCache.Clear();
+
+		this->workerPlanners = workerPlanners;
+		if (workerPlanners.size() > 0)
+		{
+			workerPlannerType = workerPlanners[0]->GetType();
+			workerPool.Start(workerPlanners);
+		}
 	}
 
 	// Add request
@@ -59,8 +246,17 @@ public:
 		// increase request count
 		requestCount++;
 
+		if (requestData.keepUpdated)
+		{
+			// searched by its own planner in the next updates
+			KeptUpdatedPath& keptUpdatedPath = keptUpdatedPaths[requestCount];
+			keptUpdatedPath.id = requestCount;
+			keptUpdatedPath.data = requestData;
+			return requestCount;
+		}
+
 		// register the request
-		requests[requestCount] = { requestCount, requestData, PathRequest::State::INVALID };
+		requests[requestCount] = { requestCount, requestData, PathRequest::State::INVALID, Clock::now() };
 		auto& request = requests[requestCount];
 
 		// enqueue
@@ -72,24 +268,238 @@ public:
 		return request.id;
 	}
 
+	// Add flow field request (served in the next updates, with PathNotFound_SearchSpaceNotSupported if the search space is not a whole grid)
+	PathRequestId AddFlowFieldRequest(const FlowFieldRequestData& requestData)
+	{
+		// increase request count
+		requestCount++;
+
+		flowFieldRequests.push_back({ requestCount, requestData });
+		return requestCount;
+	}
+
+	// Set cells walkable (cells at the positions of a grid)
+	void SetCellsWalkable(const std::vector<MathGeom::Vector3>& positions, bool walkable)
+	{
+		std::vector<PathNodeId> changedNodes;
+		for (auto& position : positions)
+		{
+			PathNodeId node = searchSpace->Localise(position);
+			if (node != INVALID_PATH_NODE_ID && searchSpace->IsWalkable(node) != walkable)
+			{
+				changedNodes.push_back(node);
+			}
+		}
+
+		if (changedNodes.empty())
+		{
+			return;
+		}
+
+		// searches read the grid, so running ones are interrupted (workers at the end of their current slice) and queued again
+		workerPool.Interrupt();
+		InterruptSearches();
+
+		for (PathNodeId node : changedNodes)
+		{
+			searchSpace->SetNodeWalkable(node, walkable);
+		}
+
+		// kept updated paths only repair the region around the changed cells
+		for (auto& entry : keptUpdatedPaths)
+		{
+			KeptUpdatedPath& keptUpdatedPath = entry.second;
+			if (keptUpdatedPath.pathPlanner)
+			{
+				keptUpdatedPath.pathPlanner->OnCellsChanged(changedNodes);
+				keptUpdatedPath.cellsChanged = true;
+			}
+		}
+	}
+
+	// Set cells cost (cells at the positions of a grid with cell costs, see CellCostTable)
+	void SetCellsCost(const std::vector<MathGeom::Vector3>& positions, uint8_t cost)
+	{
+		const CellCostTable* cellCosts = searchSpace->GetCellCosts();
+		if (!cellCosts)
+		{
+			return;
+		}
+
+		std::vector<PathNodeId> changedNodes;
+		for (auto& position : positions)
+		{
+			PathNodeId node = searchSpace->Localise(position);
+			if (node != INVALID_PATH_NODE_ID && cellCosts->GetCost(node) != cost)
+			{
+				changedNodes.push_back(node);
+			}
+		}
+
+		if (changedNodes.empty())
+		{
+			return;
+		}
+
+		// searches read the costs, so running ones are interrupted (workers at the end of their current slice) and queued again
+		workerPool.Interrupt();
+		InterruptSearches();
+
+		searchSpace->SetNodeCosts(changedNodes, cost);
+
+		// kept updated paths only repair the edges of the changed cells
+		for (auto& entry : keptUpdatedPaths)
+		{
+			KeptUpdatedPath& keptUpdatedPath = entry.second;
+			if (keptUpdatedPath.pathPlanner)
+			{
+				keptUpdatedPath.pathPlanner->OnCellsChanged(changedNodes);
+				keptUpdatedPath.cellsChanged = true;
+			}
+		}
+	}
+
+	// Move path start (of a kept updated path, the search tree is kept)
+	void MovePathStart(PathRequestId requestId, const MathGeom::Vector3& start)
+	{
+		auto keptUpdatedPathIt = keptUpdatedPaths.find(requestId);
+		if (keptUpdatedPathIt == keptUpdatedPaths.end())
+		{
+			return;
+		}
+
+		KeptUpdatedPath& keptUpdatedPath = keptUpdatedPathIt->second;
+		keptUpdatedPath.data.start = start;
+
+		PathNodeId startNode = searchSpace->Localise(start);
+		if (keptUpdatedPath.pathPlanner && startNode != INVALID_PATH_NODE_ID)
+		{
+			keptUpdatedPath.pathPlanner->MoveStart(startNode);
+		}
+	}
+
 	// Cancel request
 	void CancelRequest(PathRequestId requestId)
 	{
+		if (keptUpdatedPaths.erase(requestId) > 0)
+		{
+			return;
+		}
+
 		requestQueue.Remove(requestId);
+
+		auto flowFieldRequestIt = std::find_if(flowFieldRequests.begin(), flowFieldRequests.end(), [requestId](const FlowFieldRequest& request) { return request.id == requestId; });
+		if (flowFieldRequestIt != flowFieldRequests.end())
+		{
+			flowFieldRequests.erase(flowFieldRequestIt);
+			return;
+		}
+
+		// slots are released before the request is erased, they point to it
+		for (auto& slot : searchSlots)
+		{
+			// a coalesced request leaves the search of its group
+			auto& coalesced = slot.coalescedRequests;
+			coalesced.erase(std::remove_if(coalesced.begin(), coalesced.end(), [requestId](PathRequest* request) { return request->id == requestId; }), coalesced.end());
+
+			if (slot.request && slot.request->id == requestId)
+			{
+				if (coalesced.empty())
+				{
+					// release the slot
+					slot.request = nullptr;
+					slot.searchingFromGoal = false;
+				}
+				else
+				{
+					// another request of the group keeps the search
+					slot.request = coalesced.back();
+					coalesced.pop_back();
+				}
+			}
+		}
+
 		requests.erase(requestId);
+
+		if (workerPool.IsRunning())
+		{
+			// a result for a request that is already being searched will be ignored
+			workerPool.RemoveJob(requestId);
+		}
 	}
 
-	// Update
+	// Update (a single search slice)
 	void Update()
 	{
-		// find paths
-		FindPaths();
+		Update(std::chrono::microseconds::zero());
 	}
 
+	// Update (keep searching until the time budget is used up)
+	void Update(std::chrono::microseconds budget)
+	{
+		auto startTime = Clock::now();
+
+		frameStats = PathRequestSchedulerFrameStats();
+		frameStats.budget = budget;
+
+		// nodes around the agents and the requests are loaded before searching
+		StreamSearchSpace();
+
+		// flow fields are built and kept updated paths are repaired on this thread
+		ServeFlowFieldRequests(startTime, budget);
+		UpdateKeptUpdatedPaths(startTime, budget);
+
+		if (workerPool.IsRunning())
+		{
+			// hand requests to the workers and notify their results
+			DispatchRequests();
+			CollectResults();
+		}
+		else
+		{
+			// find paths
+			FindPaths(startTime, budget);
+		}
+
+		frameStats.used = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime);
+	}
+
+	// Set streaming positions (search spaces loaded on demand keep the nodes around them loaded, with those of the requests)
+	void SetStreamingPositions(const std::vector<MathGeom::Vector3>& positions)
+	{
+		streamingPositions = positions;
+	}
+
+	// Get frame stats (stats of the last update)
+	const PathRequestSchedulerFrameStats& GetFrameStats() const { return frameStats; }
+
+	// Get queue stats (depth and wait times of a priority)
+	const PathRequestQueueStats& GetQueueStats(PathRequestPriority priority) const { return requestQueue.GetStats(priority); }
+
+	// Get request queue (to tune aging and deadlines)
+	PathRequestQueue& GetRequestQueue() { return requestQueue; }
+
+	// Set coalesce requests
+	void SetCoalesceRequests(bool coalesce) { coalesceRequests = coalesce; }
+
+	// Set path smoothing
+	void SetPathSmoothing(PathSmoothing smoothing) { pathSmoothing = smoothing; }
+
+	// Get coalesced request count (requests merged into the search of another request since the start, each counted once)
+	size_t GetCoalescedRequestCount() const { return coalescedRequestCount; }
+
+	// Get flow field cache (to set its memory cap and read its stats)
+	FlowFieldCache& GetFlowFieldCache() { return flowFieldCache; }
+	const FlowFieldCache& GetFlowFieldCache() const { return flowFieldCache; }
+
+	// Get path cache (to set its memory cap and read its stats)
+	PathCache& GetPathCache() { return pathCache; }
+	const PathCache& GetPathCache() const { return pathCache; }
+
 	// Debug render
 	void DebugRender(const MathGeom::Matrix4& viewProjection, const PathfinderDebugRenderFlags& render)
 	{
-		if (requestQueue.GetRequest())
+		if (requestQueue.GetRequest() || IsSearching())
 		{
 			// ignore debug rendering until last request path is done
 			return;
@@ -107,31 +517,31 @@ public:
 
 		if (render.startGoalSearchSpace)
 		{
-			PathNode* start = searchSpace->Localise(lastStart);
-			if (start)
+			PathNodeId start = searchSpace->Localise(lastStart);
+			if (start != INVALID_PATH_NODE_ID)
 			{
 				Transform transform;
-				transform.position = start->position;
+				transform.position = searchSpace->GetNodePosition(start);
 				RenderUtils::RenderCube(viewProjection, transform, 0x0000FF);
 			}
 
-			PathNode* goal = searchSpace->Localise(lastGoal);
-			if (goal)
+			PathNodeId goal = searchSpace->Localise(lastGoal);
+			if (goal != INVALID_PATH_NODE_ID)
 			{
 				Transform transform;
-				transform.position = goal->position;
+				transform.position = searchSpace->GetNodePosition(goal);
 				RenderUtils::RenderCube(viewProjection, transform, 0x0000FF);
 			}
 		}
 
 		if (render.pathPlannerPath || render.finalPath)
 		{
-			PathNode* start = searchSpace->Localise(lastStart);
-			PathNode* goal = searchSpace->Localise(lastGoal);
+			PathNodeId start = searchSpace->Localise(lastStart);
+			PathNodeId goal = searchSpace->Localise(lastGoal);
 
-			if (start && goal && start->type != PathNodeType::BLOCKED && goal->type != PathNodeType::BLOCKED)
+			if (searchSpace->IsWalkable(start) && searchSpace->IsWalkable(goal) && lastPathPlanner)
 			{
-				pathPlanner->DebugRender(viewProjection, render);
+				lastPathPlanner->DebugRender(viewProjection, render);
 			}
 		}
 	}
@@ -146,103 +556,655 @@ protected:
 
 private:
 
-	// Find paths
-	void FindPaths()
+	// Serve flow field requests (at least one, then until the budget is used up)
+	void ServeFlowFieldRequests(Clock::time_point startTime, std::chrono::microseconds budget)
 	{
-		auto request = requestQueue.GetRequest();
-		if (!request)
+		while (!flowFieldRequests.empty())
 		{
-			// no requests left
+			FlowFieldRequest request = std::move(flowFieldRequests.front());
+			flowFieldRequests.pop_front();
+
+			ServeFlowFieldRequest(request);
+			frameStats.flowFieldRequests++;
+
+			if (Clock::now() - startTime >= budget)
+			{
+				return;
+			}
+		}
+	}
+
+	// Serve flow field request
+	void ServeFlowFieldRequest(FlowFieldRequest& request)
+	{
+		// flow fields are only built on whole grids
+		auto grid = std::dynamic_pointer_cast<GridSearchSpace>(searchSpace);
+		if (!grid)
+		{
+			request.data.onFlowFieldRequestResult(request.id, PathRequestResultStatus::PathNotFound_SearchSpaceNotSupported, nullptr);
 			return;
 		}
 
-		switch (request->state)
+		PathNodeId goal = grid->Localise(request.data.goal);
+
+		if (goal == INVALID_PATH_NODE_ID)
 		{
-		case PathRequest::State::QUEUED:
-		case PathRequest::State::INTERRUPTED:
-			StartSearch(*request);
-			break;
-		case PathRequest::State::RUNNING:
-			ResumeSearch(*request);
-			break;
-		case PathRequest::State::COMPLETED:
-		case PathRequest::State::INVALID:
-		
-			assert(false);
-			break;
-		default:
-			assert(false);
-			break;
+			request.data.onFlowFieldRequestResult(request.id, PathRequestResultStatus::PathNotFound_GoalNotLocalised, nullptr);
+			return;
 		}
+
+		if (!grid->IsWalkable(goal))
+		{
+			request.data.onFlowFieldRequestResult(request.id, PathRequestResultStatus::PathNotFound_GoalBlocked, nullptr);
+			return;
+		}
+
+		request.data.onFlowFieldRequestResult(request.id, PathRequestResultStatus::PathFound, flowFieldCache.Get(*grid, goal));
+	}
+
+	// Update kept updated paths (a slice for each path being searched, until they are done or the budget is used up)
+	void UpdateKeptUpdatedPaths(Clock::time_point startTime, std::chrono::microseconds budget)
+	{
+		std::vector<PathRequestId> searchingIds;
+		do
+		{
+			searchingIds.clear();
+			for (auto& entry : keptUpdatedPaths)
+			{
+				auto& pathPlanner = entry.second.pathPlanner;
+				if (!pathPlanner || !pathPlanner->IsSearchCompleted())
+				{
+					searchingIds.push_back(entry.first);
+				}
+			}
+
+			for (PathRequestId requestId : searchingIds)
+			{
+				// callbacks may cancel requests
+				auto keptUpdatedPathIt = keptUpdatedPaths.find(requestId);
+				if (keptUpdatedPathIt != keptUpdatedPaths.end())
+				{
+					UpdateKeptUpdatedPath(keptUpdatedPathIt->second);
+					frameStats.slices++;
+				}
+			}
+
+		} while (!searchingIds.empty() && Clock::now() - startTime < budget);
+	}
+
+	// Update kept updated path (a search slice, the path is notified when the search completes)
+	void UpdateKeptUpdatedPath(KeptUpdatedPath& keptUpdatedPath)
+	{
+		bool searchCompleted = false;
+		if (!keptUpdatedPath.pathPlanner)
+		{
+			PathNodeId start = searchSpace->Localise(keptUpdatedPath.data.start);
+			PathNodeId goal = searchSpace->Localise(keptUpdatedPath.data.goal);
+
+			PathRequestResultStatus resultStatus;
+			if (!Validate(start, goal, resultStatus))
+			{
+				Path path;
+				PathRequestId requestId = keptUpdatedPath.id;
+				OnPathRequestResult onPathRequestResult = keptUpdatedPath.data.onPathRequestResult;
+
+				keptUpdatedPaths.erase(requestId);
+				onPathRequestResult(requestId, resultStatus, path);
+				return;
+			}
+
+			PathPlannerData pathPlannerData;
+			pathPlannerData.type = PathPlannerType::D_STAR_LITE;
+			pathPlannerData.maxRevolutions = searchSlots.empty() ? DEFAULT_MAX_REVOLUTIONS : searchSlots[0].pathPlanner->GetMaxRevolutions();
+
+			keptUpdatedPath.pathPlanner = std::make_shared<DStarLite>(pathPlannerData, searchSpace);
+			keptUpdatedPath.cellsChanged = true;
+			searchCompleted = keptUpdatedPath.pathPlanner->StartSearch(start, goal);
+		}
+		else
+		{
+			searchCompleted = keptUpdatedPath.pathPlanner->ResumeSearch();
+		}
+
+		if (!searchCompleted)
+		{
+			return;
+		}
+
+		// get the path
+		Path path;
+		keptUpdatedPath.pathPlanner->GetPath(path);
+
+		// override start/goal position
+		if (path.size() > 0)
+		{
+			path[0] = keptUpdatedPath.data.start;
+			path[path.size() - 1] = keptUpdatedPath.data.goal;
+		}
+
+		// notify it when cells changed it (a moved start alone is already known by the requester)
+		bool notify = keptUpdatedPath.cellsChanged && (!keptUpdatedPath.notified || path != keptUpdatedPath.path);
+
+		keptUpdatedPath.path = path;
+		keptUpdatedPath.cellsChanged = false;
+
+		if (notify)
+		{
+			keptUpdatedPath.notified = true;
+			frameStats.completedRequests++;
+
+			PathRequestResultStatus resultStatus = path.size() > 0 ? PathRequestResultStatus::PathFound : PathRequestResultStatus::PathNotFound;
+			SmoothPath(path);
+
+			// the callback may cancel the request, which destroys the callback stored in it
+			OnPathRequestResult onPathRequestResult = keptUpdatedPath.data.onPathRequestResult;
+			onPathRequestResult(keptUpdatedPath.id, resultStatus, path);
+		}
+	}
+
+	// Find paths
+	void FindPaths(Clock::time_point startTime, std::chrono::microseconds budget)
+	{
+		// round-robin over the search slots until the budget is used up (at least one slice is run)
+		do
+		{
+			if (!RunNextSearchSlot())
+			{
+				// no requests left
+				return;
+			}
+
+			frameStats.slices++;
+
+		} while (Clock::now() - startTime < budget);
+	}
+
+	// Run next search slot (start a queued request in an idle slot or resume a suspended search)
+	bool RunNextSearchSlot()
+	{
+		for (size_t i = 0; i < searchSlots.size(); i++)
+		{
+			SearchSlot& slot = searchSlots[nextSearchSlot];
+			nextSearchSlot = (nextSearchSlot + 1) % searchSlots.size();
+
+			if (slot.request)
+			{
+				ResumeSearch(slot);
+				return true;
+			}
+
+			// the request leaves the queue while the slot owns it
+			while (auto request = requestQueue.Dequeue())
+			{
+				// cached paths complete without taking the slot
+				if (CompleteFromCache(*request))
+				{
+					continue;
+				}
+
+				StartSearch(slot, *request);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Is searching
+	bool IsSearching() const
+	{
+		for (auto& slot : searchSlots)
+		{
+			if (slot.request)
+			{
+				return true;
+			}
+		}
+
+		return false;
 	}
 
 	// Start search
-	void StartSearch(PathRequest& request)
+	void StartSearch(SearchSlot& slot, PathRequest& request)
 	{
 		assert(request.state == PathRequest::State::QUEUED || request.state == PathRequest::State::INTERRUPTED);
 
+		auto pathPlanner = slot.pathPlanner;
+
 		// for debugging purpose
 		pathPlanner->Reset();
+		lastPathPlanner = pathPlanner;
 		lastStart = request.data.start;
 		lastGoal = request.data.goal;
 
 		// running request
 		request.state = PathRequest::State::RUNNING;
+		slot.request = &request;
 
 		// Localise start/goal positions
-		PathNode* start = searchSpace->Localise(lastStart);
-		PathNode* goal = searchSpace->Localise(lastGoal);
+		PathNodeId start = searchSpace->Localise(lastStart);
+		PathNodeId goal = searchSpace->Localise(lastGoal);
 
 		// Validate request
 		if (Validate(request, start, goal))
 		{
+			request.startNode = start;
+			request.goalNode = goal;
+			request.searchSpaceVersion = searchSpace->GetVersion();
+
+			// search from the goal when other requests share it. It finds the shortest paths, so it only replaces
+			// the planners that find them too (not the any-angle, hierarchical, weighted or anytime ones)
+			std::vector<std::pair<PathRequestId, PathRequestResultStatus>> rejectedRequests;
+			if (coalesceRequests && pathPlanner->FindsShortestPaths() && CoalesceRequests(slot, request, rejectedRequests))
+			{
+				StartGoalSearch(slot);
+			}
 			// start search
-			if (pathPlanner->StartSearch(start, goal))
+			else if (pathPlanner->StartSearch(start, goal))
 			{
 				// terminate the request if the search is complete
-				TerminateRequest(request);
+				TerminateRequest(request, *pathPlanner);
+			}
+			else
+			{
+				NotifyImprovedPath(request, *pathPlanner);
+			}
+
+			// requests sharing the goal that failed validation are terminated once the slot is set up (their callbacks
+			// may cancel the requests of the slot)
+			for (auto& rejectedRequest : rejectedRequests)
+			{
+				auto requestIt = requests.find(rejectedRequest.first);
+				if (requestIt != requests.end())
+				{
+					Path path;
+					TerminateRequest(requestIt->second, rejectedRequest.second, path);
+				}
 			}
 		}		
 	}
 
 	// Resume search
-	void ResumeSearch(PathRequest& request)
+	void ResumeSearch(SearchSlot& slot)
 	{
+		if (slot.searchingFromGoal)
+		{
+			if (slot.goalSearch->ResumeSearch())
+			{
+				// terminate the requests if the search is complete
+				TerminateCoalescedRequests(slot);
+			}
+
+			return;
+		}
+
+		auto pathPlanner = slot.pathPlanner;
 		if (pathPlanner->ResumeSearch())
 		{
 			// terminate the request if the search is complete
-			TerminateRequest(request);
+			TerminateRequest(*slot.request, *pathPlanner);
+		}
+		else
+		{
+			NotifyImprovedPath(*slot.request, *pathPlanner);
+		}
+	}
+
+	// Notify improved path (a path found by an anytime planner before its search is completed)
+	void NotifyImprovedPath(PathRequest& request, PathPlanner& pathPlanner)
+	{
+		Path path;
+		if (!pathPlanner.GetImprovedPath(path) || path.empty())
+		{
+			return;
+		}
+
+		// override start/goal position
+		path[0] = request.data.start;
+		path[path.size() - 1] = request.data.goal;
+
+		frameStats.provisionalPaths++;
+		SmoothPath(path);
+
+		// the request keeps its slot (the callback may cancel it, which destroys the callback stored in it)
+		OnPathRequestResult onPathRequestResult = request.data.onPathRequestResult;
+		onPathRequestResult(request.id, PathRequestResultStatus::PathFound_Provisional, path);
+	}
+
+	// Coalesce requests (queued requests with the same goal as the request join its search, true if any joined).
+	// They are validated like the other requests, an unreachable start would make the search from the goal flood
+	// its whole component: the ones that fail are dequeued too, with their status in rejectedRequests.
+	bool CoalesceRequests(SearchSlot& slot, PathRequest& request, std::vector<std::pair<PathRequestId, PathRequestResultStatus>>& rejectedRequests)
+	{
+		assert(slot.coalescedRequests.empty());
+
+		std::vector<PathRequest*> sharingGoal;
+		requestQueue.DequeueMatching([this, &request](const PathRequest& queued)
+		{
+			return searchSpace->Localise(queued.data.goal) == request.goalNode;
+		}, sharingGoal);
+
+		for (PathRequest* coalesced : sharingGoal)
+		{
+			PathNodeId start = searchSpace->Localise(coalesced->data.start);
+
+			PathRequestResultStatus resultStatus;
+			if (!Validate(start, request.goalNode, resultStatus))
+			{
+				rejectedRequests.emplace_back(coalesced->id, resultStatus);
+				continue;
+			}
+
+			slot.coalescedRequests.push_back(coalesced);
+			coalesced->state = PathRequest::State::RUNNING;
+			coalesced->startNode = start;
+			coalesced->goalNode = request.goalNode;
+			coalesced->searchSpaceVersion = request.searchSpaceVersion;
+
+			// each request is counted once, even when an interrupted search merges it again
+			coalescedRequestCount += coalesced->coalesced ? 0 : 1;
+			coalesced->coalesced = true;
+		}
+
+		frameStats.coalescedRequests += slot.coalescedRequests.size();
+
+		return !slot.coalescedRequests.empty();
+	}
+
+	// Start goal search (a single search from the goal of the slot requests)
+	void StartGoalSearch(SearchSlot& slot)
+	{
+		if (!slot.goalSearch)
+		{
+			slot.goalSearch = std::make_shared<ReverseDijkstraSearch>(searchSpace, slot.pathPlanner->GetMaxRevolutions());
+		}
+
+		// for debugging purpose
+		lastPathPlanner = nullptr;
+
+		std::vector<PathNodeId> starts{ slot.request->startNode };
+		for (PathRequest* coalesced : slot.coalescedRequests)
+		{
+			starts.push_back(coalesced->startNode);
+		}
+
+		slot.searchingFromGoal = true;
+		if (slot.goalSearch->StartSearch(slot.request->goalNode, starts))
+		{
+			// terminate the requests if the search is complete
+			TerminateCoalescedRequests(slot);
+		}
+	}
+
+	// Terminate coalesced requests (the slot request and the requests that joined its search)
+	void TerminateCoalescedRequests(SearchSlot& slot)
+	{
+		// release the slot first, callbacks may add or cancel requests
+		std::vector<PathRequestId> requestIds{ slot.request->id };
+		for (PathRequest* coalesced : slot.coalescedRequests)
+		{
+			requestIds.push_back(coalesced->id);
+		}
+
+		auto goalSearch = slot.goalSearch;
+		PathPlannerType plannerType = slot.pathPlanner->GetType();
+
+		slot.request = nullptr;
+		slot.coalescedRequests.clear();
+		slot.searchingFromGoal = false;
+
+		for (PathRequestId requestId : requestIds)
+		{
+			auto requestIt = requests.find(requestId);
+			if (requestIt == requests.end())
+			{
+				// request cancelled by a previous callback
+				continue;
+			}
+
+			PathRequest& request = requestIt->second;
+
+			// get the path
+			Path path;
+			goalSearch->GetPath(request.startNode, path);
+
+			// override start/goal position
+			if (path.size() > 0)
+			{
+				path[0] = request.data.start;
+				path[path.size() - 1] = request.data.goal;
+			}
+
+			// terminate
+			PathRequestResultStatus resultStatus = path.size() > 0 ? PathRequestResultStatus::PathFound : PathRequestResultStatus::PathNotFound;
+			CacheResult(request, plannerType, resultStatus, path);
+			TerminateRequest(request, resultStatus, path);
+		}
+	}
+
+	// Dispatch requests
+	void DispatchRequests()
+	{
+		// the request leaves the queue while a worker owns it
+		while (auto request = requestQueue.Dequeue())
+		{
+			// cached paths complete without a job
+			if (CompleteFromCache(*request))
+			{
+				continue;
+			}
+
+			request->state = PathRequest::State::RUNNING;
+
+			lastPathPlanner = nullptr;
+			lastStart = request->data.start;
+			lastGoal = request->data.goal;
+
+			// Localise start/goal positions
+			PathNodeId start = searchSpace->Localise(request->data.start);
+			PathNodeId goal = searchSpace->Localise(request->data.goal);
+
+			// Validate request
+			if (Validate(*request, start, goal))
+			{
+				request->startNode = start;
+				request->goalNode = goal;
+				request->searchSpaceVersion = searchSpace->GetVersion();
+
+				workerPool.PushJob({ request->id, start, goal, request->data.start, request->data.goal });
+			}
+		}
+	}
+
+	// Collect results
+	void CollectResults()
+	{
+		std::vector<PathPlannerWorkerPool::Result> results;
+		workerPool.PopResults(results);
+
+		for (auto& result : results)
+		{
+			auto requestIt = requests.find(result.id);
+			if (requestIt == requests.end())
+			{
+				// request cancelled while searching
+				continue;
+			}
+
+			PathRequest& request = requestIt->second;
+			if (result.resultStatus == PathRequestResultStatus::PathFound_Provisional)
+			{
+				// the worker keeps searching (the callback may cancel the request, which destroys the callback stored in it)
+				frameStats.provisionalPaths++;
+				SmoothPath(result.path);
+				OnPathRequestResult onPathRequestResult = request.data.onPathRequestResult;
+				onPathRequestResult(request.id, result.resultStatus, result.path);
+				continue;
+			}
+
+			CacheResult(request, workerPlannerType, result.resultStatus, result.path);
+			TerminateRequest(request, result.resultStatus, result.path);
+		}
+	}
+
+	// Complete from cache (true if the request has been completed with a cached path)
+	bool CompleteFromCache(PathRequest& request)
+	{
+		PathNodeId start = searchSpace->Localise(request.data.start);
+		PathNodeId goal = searchSpace->Localise(request.data.goal);
+
+		if (!searchSpace->IsWalkable(start) || !searchSpace->IsWalkable(goal))
+		{
+			// invalid requests are terminated when validated
+			return false;
+		}
+
+		if (!workerPool.IsRunning() && searchSlots.empty())
+		{
+			return false;
+		}
+
+		PathPlannerType plannerType = workerPool.IsRunning() ? workerPlannerType : searchSlots[0].pathPlanner->GetType();
+
+		PathRequestResultStatus resultStatus;
+		Path path;
+		if (!pathCache.Find({ start, goal, plannerType }, searchSpace->GetVersion(), resultStatus, path))
+		{
+			return false;
+		}
+
+		// for debugging purpose
+		lastPathPlanner = nullptr;
+		lastStart = request.data.start;
+		lastGoal = request.data.goal;
+
+		// override start/goal position
+		if (path.size() > 0)
+		{
+			path[0] = request.data.start;
+			path[path.size() - 1] = request.data.goal;
+		}
+
+		frameStats.cacheHits++;
+		TerminateRequest(request, resultStatus, path);
+		return true;
+	}
+
+	// Stream search space (around the streaming positions and the start/goal of the requests)
+	void StreamSearchSpace()
+	{
+		if (!searchSpace || !searchSpace->IsLoadedOnDemand())
+		{
+			return;
+		}
+
+		streamedPositions = streamingPositions;
+		for (auto& entry : requests)
+		{
+			streamedPositions.push_back(entry.second.data.start);
+			streamedPositions.push_back(entry.second.data.goal);
+		}
+
+		for (auto& entry : keptUpdatedPaths)
+		{
+			streamedPositions.push_back(entry.second.data.start);
+			streamedPositions.push_back(entry.second.data.goal);
+		}
+
+		searchSpace->StreamAround(streamedPositions);
+	}
+
+	// Smooth path (on grids)
+	void SmoothPath(Path& path)
+	{
+		if (pathSmoothing == PathSmoothing::NONE)
+		{
+			return;
+		}
+
+		auto grid = std::dynamic_pointer_cast<GridSearchSpace>(searchSpace);
+		if (grid)
+		{
+			pathSmoother.Smooth(*grid, pathSmoothing, path);
+		}
+	}
+
+	// Cache result
+	void CacheResult(const PathRequest& request, PathPlannerType plannerType, PathRequestResultStatus resultStatus, const Path& path)
+	{
+		pathCache.Insert({ request.startNode, request.goalNode, plannerType }, request.searchSpaceVersion, resultStatus, path);
+	}
+
+	// Interrupt searches (requests being searched are queued again)
+	void InterruptSearches()
+	{
+		for (auto& slot : searchSlots)
+		{
+			slot.request = nullptr;
+			slot.coalescedRequests.clear();
+			slot.searchingFromGoal = false;
+		}
+
+		for (auto& entry : requests)
+		{
+			PathRequest& request = entry.second;
+			if (request.state == PathRequest::State::RUNNING)
+			{
+				request.state = PathRequest::State::INTERRUPTED;
+				requestQueue.Enqueue(request);
+			}
 		}
 	}
 	
 private:
 
 	// Validate request
-	bool Validate(PathRequest& request, PathNode* start, PathNode* goal)
+	bool Validate(PathRequest& request, PathNodeId start, PathNodeId goal)
 	{
-		assert(start && goal);
+		assert(start != INVALID_PATH_NODE_ID && goal != INVALID_PATH_NODE_ID);
 
-		if (!start)
+		PathRequestResultStatus resultStatus;
+		if (!Validate(start, goal, resultStatus))
 		{
-			TerminateRequest(request, PathRequestResultStatus::PathNotFound_StartNotLocalised, Path());
+			Path path;
+			TerminateRequest(request, resultStatus, path);
 			return false;
 		}
 
-		if (!goal)
+		return true;
+	}
+
+	// Validate start/goal (resultStatus is set when they are not valid)
+	bool Validate(PathNodeId start, PathNodeId goal, PathRequestResultStatus& resultStatus)
+	{
+		if (start == INVALID_PATH_NODE_ID)
 		{
-			TerminateRequest(request, PathRequestResultStatus::PathNotFound_GoalNotLocalised, Path());
+			resultStatus = PathRequestResultStatus::PathNotFound_StartNotLocalised;
 			return false;
 		}
 
-		if (start->type == PathNodeType::BLOCKED)
+		if (goal == INVALID_PATH_NODE_ID)
 		{
-			TerminateRequest(request, PathRequestResultStatus::PathNotFound_StartBlocked, Path());
+			resultStatus = PathRequestResultStatus::PathNotFound_GoalNotLocalised;
 			return false;
 		}
 
-		if (goal->type == PathNodeType::BLOCKED)
+		if (!searchSpace->IsWalkable(start))
 		{
-			TerminateRequest(request, PathRequestResultStatus::PathNotFound_GoalBlocked, Path());
+			resultStatus = PathRequestResultStatus::PathNotFound_StartBlocked;
+			return false;
+		}
+
+		if (!searchSpace->IsWalkable(goal))
+		{
+			resultStatus = PathRequestResultStatus::PathNotFound_GoalBlocked;
+			return false;
+		}
+
+		if (!searchSpace->IsReachable(start, goal))
+		{
+			resultStatus = PathRequestResultStatus::PathNotFound_GoalUnreachable;
+			frameStats.unreachableRequests++;
 			return false;
 		}
 
@@ -250,11 +1212,11 @@ private:
 	}
 
 	// Terminate request
-	void TerminateRequest(PathRequest& request)
+	void TerminateRequest(PathRequest& request, PathPlanner& pathPlanner)
 	{
 		// get the path
 		Path path;
-		pathPlanner->GetPath(path);
+		pathPlanner.GetPath(path);
 		
 		// override start/goal position
 		if (path.size() > 0)
@@ -265,6 +1227,7 @@ private:
 	
 		// terminate
 		PathRequestResultStatus resultStatus = path.size() > 0 ? PathRequestResultStatus::PathFound : PathRequestResultStatus::PathNotFound;
+		CacheResult(request, pathPlanner.GetType(), resultStatus, path);
 		TerminateRequest(request, resultStatus, path);
 	}
 
@@ -272,12 +1235,18 @@ private:
 	{
 		// mark as completed
 		request.state = PathRequest::State::COMPLETED;
+		frameStats.completedRequests++;
+
+		SmoothPath(path);
 
-		// notify the result
-		request.data.onPathRequestResult(request.id, resultStatus, path);
+		// notify the result (the callback may cancel the request, which destroys the request and the callback stored in it,
+		// so both the id and the callback are kept)
+		PathRequestId requestId = request.id;
+		OnPathRequestResult onPathRequestResult = request.data.onPathRequestResult;
+		onPathRequestResult(requestId, resultStatus, path);
 
 		// cancel current request
-		CancelRequest(request.id);
+		CancelRequest(requestId);
 	}
 };
 
@@ -0,0 +1,294 @@
+#ifndef PATH_SMOOTHER_H
+#define PATH_SMOOTHER_H
+
+#include <vector>
+#include <cstdlib>
+
+#include "../SearchSpace/GridSearchSpace.h"
+
+// PathSmoothing (post-processing of the paths found on grids)
+enum class PathSmoothing
+{
+	// every node of the planner path
+	NONE,
+
+	// waypoints that can see each other are joined (greedy line of sight)
+	LINE_OF_SIGHT,
+
+	// shortest path through the cells of the planner path (funnel over the borders between the cells)
+	STRING_PULLING
+};
+
+// Path smoother.
+// Planners return a waypoint per cell (or per jump point), smoothing keeps only the waypoints where the path turns
+// around a blocked cell, so less is copied to and followed by the agents. Smoothed paths never go through a cell
+// the grid does not allow to cross.
+class PathSmoother
+{
+	// Portal (border between two consecutive cells of the corridor, left/right seen from the first one)
+	struct Portal
+	{
+		MathGeom::Vector3 left;
+		MathGeom::Vector3 right;
+	};
+
+	// corridor cells and portals (kept to reuse their memory)
+	std::vector<PathNodeId> corridor;
+	std::vector<Portal> portals;
+
+public:
+
+	// Smooth
+	void Smooth(GridSearchSpace& grid, PathSmoothing smoothing, Path& path)
+	{
+		if (path.size() <= 2)
+		{
+			return;
+		}
+
+		switch (smoothing)
+		{
+		case PathSmoothing::LINE_OF_SIGHT:
+			SmoothLineOfSight(grid, path);
+			break;
+		case PathSmoothing::STRING_PULLING:
+			if (!PullString(grid, path))
+			{
+				// the path does not go through adjacent walkable cells (e.g. corners cut by the validated nodes)
+				SmoothLineOfSight(grid, path);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Smooth line of sight (a waypoint is dropped while the previous kept one can see the next one)
+	static void SmoothLineOfSight(const GridSearchSpace& grid, Path& path)
+	{
+		size_t anchor = 0;
+		size_t count = 1;
+		for (size_t i = 2; i < path.size(); i++)
+		{
+			if (!grid.HasLineOfSight(path[anchor], path[i]))
+			{
+				// the previous waypoint is needed
+				anchor = i - 1;
+				path[count++] = path[anchor];
+			}
+		}
+
+		path[count++] = path.back();
+		path.resize(count);
+	}
+
+private:
+
+	// Pull string (funnel algorithm over the corridor, false if the path cells do not make one)
+	bool PullString(GridSearchSpace& grid, Path& path)
+	{
+		if (!BuildCorridor(grid, path))
+		{
+			return false;
+		}
+
+		MathGeom::Vector3 start = path.front();
+		MathGeom::Vector3 goal = path.back();
+
+		// the start and the goal are portals of a single point
+		portals.clear();
+		portals.push_back({ start, start });
+		for (size_t i = 1; i < corridor.size(); i++)
+		{
+			portals.push_back(GetPortal(grid, corridor[i - 1], corridor[i]));
+		}
+		portals.push_back({ goal, goal });
+
+		path.clear();
+		path.push_back(start);
+
+		MathGeom::Vector3 apex = start;
+		MathGeom::Vector3 left = start;
+		MathGeom::Vector3 right = start;
+		size_t leftIndex = 0;
+		size_t rightIndex = 0;
+
+		for (size_t i = 1; i < portals.size(); i++)
+		{
+			const Portal& portal = portals[i];
+
+			// narrow the funnel from the right
+			if (GetSide(apex, right, portal.right) >= 0.0f)
+			{
+				if (IsEqual(apex, right) || GetSide(apex, left, portal.right) < 0.0f)
+				{
+					right = portal.right;
+					rightIndex = i;
+				}
+				else
+				{
+					// the right side crosses the left one, the left point is a corner of the path
+					apex = left;
+					path.push_back(apex);
+
+					right = apex;
+					rightIndex = leftIndex;
+					i = leftIndex;
+					continue;
+				}
+			}
+
+			// narrow the funnel from the left
+			if (GetSide(apex, left, portal.left) <= 0.0f)
+			{
+				if (IsEqual(apex, left) || GetSide(apex, right, portal.left) > 0.0f)
+				{
+					left = portal.left;
+					leftIndex = i;
+				}
+				else
+				{
+					// the left side crosses the right one, the right point is a corner of the path
+					apex = right;
+					path.push_back(apex);
+
+					left = apex;
+					leftIndex = rightIndex;
+					i = rightIndex;
+					continue;
+				}
+			}
+		}
+
+		if (!IsEqual(path.back(), goal))
+		{
+			path.push_back(goal);
+		}
+
+		RemoveCollinearWaypoints(path);
+		return true;
+	}
+
+	// Remove collinear waypoints (corners the path only touches while going straight past them)
+	static void RemoveCollinearWaypoints(Path& path)
+	{
+		const float EPSILON = 1e-4f;
+
+		size_t count = 1;
+		for (size_t i = 1; i + 1 < path.size(); i++)
+		{
+			if (fabsf(GetSide(path[count - 1], path[i], path[i + 1])) > EPSILON)
+			{
+				path[count++] = path[i];
+			}
+		}
+
+		path[count++] = path.back();
+		path.resize(count);
+	}
+
+	// Build corridor (cells of the path, false if they are not connected by cells that can be crossed)
+	bool BuildCorridor(GridSearchSpace& grid, const Path& path)
+	{
+		corridor.clear();
+		for (auto& position : path)
+		{
+			PathNodeId node = grid.Localise(position);
+			if (node == INVALID_PATH_NODE_ID)
+			{
+				return false;
+			}
+
+			if (corridor.empty())
+			{
+				corridor.push_back(node);
+				continue;
+			}
+
+			// waypoints further apart (jump points) are joined by diagonal and straight steps, in either order
+			if (!FillCorridor(grid, node, true) && !FillCorridor(grid, node, false))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Fill corridor (cells from the last one of the corridor to the node, diagonal steps first or last)
+	bool FillCorridor(const GridSearchSpace& grid, PathNodeId node, bool diagonalFirst)
+	{
+		size_t size = corridor.size();
+
+		int x = int(grid.GetCellX(corridor.back()));
+		int z = int(grid.GetCellZ(corridor.back()));
+		int endX = int(grid.GetCellX(node));
+		int endZ = int(grid.GetCellZ(node));
+
+		while (x != endX || z != endZ)
+		{
+			int dx = endX > x ? 1 : (endX < x ? -1 : 0);
+			int dz = endZ > z ? 1 : (endZ < z ? -1 : 0);
+
+			// straight steps first while the remaining distance is longer along one axis
+			if (!diagonalFirst && abs(endX - x) != abs(endZ - z))
+			{
+				if (abs(endX - x) > abs(endZ - z))
+				{
+					dz = 0;
+				}
+				else
+				{
+					dx = 0;
+				}
+			}
+
+			// diagonal moves are blocked when both straight cells next to them are blocked
+			if (!grid.IsCellWalkable(x + dx, z + dz) || (dx != 0 && dz != 0 && !grid.IsCellWalkable(x + dx, z) && !grid.IsCellWalkable(x, z + dz)))
+			{
+				corridor.resize(size);
+				return false;
+			}
+
+			x += dx;
+			z += dz;
+			corridor.push_back(grid.GetNodeId(x, z));
+		}
+
+		return true;
+	}
+
+	// Get portal (the border between adjacent cells, a single corner between diagonal ones)
+	static Portal GetPortal(const GridSearchSpace& grid, PathNodeId from, PathNodeId to)
+	{
+		float halfCellSize = grid.GetCellSize() * 0.5f;
+
+		int dx = int(grid.GetCellX(to)) - int(grid.GetCellX(from));
+		int dz = int(grid.GetCellZ(to)) - int(grid.GetCellZ(from));
+
+		MathGeom::Vector3 middle = (grid.GetNodePosition(from) + grid.GetNodePosition(to)) * 0.5f;
+		if (dx != 0 && dz != 0)
+		{
+			return { middle, middle };
+		}
+
+		// right is clockwise from the direction of the move (seen from above, x right and z up)
+		MathGeom::Vector3 right(float(dz) * halfCellSize, 0.0f, float(-dx) * halfCellSize);
+		return { middle - right, middle + right };
+	}
+
+	// Get side (above 0 if point is counterclockwise from the direction from origin to target, XZ plane)
+	static float GetSide(const MathGeom::Vector3& origin, const MathGeom::Vector3& target, const MathGeom::Vector3& point)
+	{
+		return (target.x - origin.x) * (point.z - origin.z) - (target.z - origin.z) * (point.x - origin.x);
+	}
+
+	// Is equal (XZ plane)
+	static bool IsEqual(const MathGeom::Vector3& a, const MathGeom::Vector3& b)
+	{
+		const float EPSILON = 1e-6f;
+		return fabsf(a.x - b.x) < EPSILON && fabsf(a.z - b.z) < EPSILON;
+	}
+};
+
+#endif // !PATH_SMOOTHER_H
@@ -16,6 +16,7 @@ struct PathfinderData
 {
 	SearchSpaceData searchSpaceData;
 	PathPlannerData pathPlannerData;
+	PathRequestSchedulerData pathRequestSchedulerData;
 };
 
 class Pathfinder
@@ -25,6 +26,10 @@ class Pathfinder
 
 	// path planner
 	std::shared_ptr<PathPlanner> pathPlanner;
+	PathPlannerData pathPlannerData;
+
+	// path request scheduler data
+	PathRequestSchedulerData pathRequestSchedulerData;
 
 	// path request scheduler
 	PathRequestScheduler pathRequestScheduler;
@@ -37,6 +42,13 @@ public:
 		// set search space
 		SetSearchSpace(data.searchSpaceData);
 
+		// set scheduler data
+		pathRequestSchedulerData = data.pathRequestSchedulerData;
+		pathRequestScheduler.GetPathCache().SetMemoryCap(pathRequestSchedulerData.pathCacheMemoryCap);
+		pathRequestScheduler.SetCoalesceRequests(pathRequestSchedulerData.coalesceRequests);
+		pathRequestScheduler.GetFlowFieldCache().SetMemoryCap(pathRequestSchedulerData.flowFieldCacheMemoryCap);
+		pathRequestScheduler.SetPathSmoothing(pathRequestSchedulerData.pathSmoothing);
+
 		// set planner
 		SetPathPlanner(data.pathPlannerData);
 	}
@@ -44,45 +56,65 @@ public:
 	// set search space
 	void SetSearchSpace(const SearchSpaceData& searchSpaceData)
 	{
-		switch (searchSpaceData.searchSpaceType)
+		searchSpace = CreateSearchSpace(searchSpaceData);
+
+		// set search space to the scheduler
+		pathRequestScheduler.SetSearchSpace(searchSpace);
+
+		// planners keep the search space they were created with, so they are created again on the new one
+		if (pathPlanner)
 		{
-		case SearchSpaceType::OCTILE_GRID:
-			searchSpace = std::make_shared<NavGrid>(searchSpaceData);
-			break;
-		default:
-			assert(false);
-			break;
+			SetPathPlanner(pathPlannerData);
 		}
+	}
 
-		// build search space
-		if (searchSpace)
+	// Set planner type
+	void SetPathPlanner(const PathPlannerData& pathPlannerData)
+	{
+		this->pathPlannerData = pathPlannerData;
+
+		// create planners (each suspended search needs its own planner)
+		SetMaxActiveSearches(pathRequestSchedulerData.maxActiveSearches);
+
+		// workers need their own planner instances
+		SetWorkerCount(pathRequestSchedulerData.workerCount);
+	}
+
+	// Set max active searches (number of searches that can be suspended at the same time)
+	void SetMaxActiveSearches(size_t count)
+	{
+		pathRequestSchedulerData.maxActiveSearches = std::max(count, size_t(1));
+
+		std::vector<std::shared_ptr<PathPlanner>> pathPlanners;
+		for (size_t i = 0; i < pathRequestSchedulerData.maxActiveSearches; i++)
 		{
-			searchSpace->Build();
+			pathPlanners.push_back(CreatePathPlanner(pathPlannerData, searchSpace));
 		}
 
-		// set search space to the scheduler
-		pathRequestScheduler.SetSearchSpace(searchSpace);
+		pathPlanner = pathPlanners[0];
+
+		// set planners to the scheduler
+		pathRequestScheduler.SetPathPlanners(pathPlanners);
 	}
 
-	// Set planner type
-	void SetPathPlanner(const PathPlannerData& pathPlannerData)
+	// Set worker count (0 to search on the thread that calls Update)
+	void SetWorkerCount(size_t count)
 	{
-		// create planner
-		switch (pathPlannerData.type)
+		pathRequestSchedulerData.workerCount = count;
+
+		// searches load the nodes of search spaces loaded on demand, so they all run on the thread that calls Update
+		if (searchSpace && searchSpace->IsLoadedOnDemand())
 		{
-		case PathPlannerType::A_STAR:
-			pathPlanner = std::make_shared<AStar>(pathPlannerData, searchSpace);
-			break;
-		case PathPlannerType::JUMP_POINT_SEARCH:
-			pathPlanner = std::make_shared<JumpPointSearch>(pathPlannerData, searchSpace);
-			break;
-		default:
-			assert(false);
-			break;
+			count = 0;
+		}
+
+		std::vector<std::shared_ptr<PathPlanner>> workerPlanners;
+		for (size_t i = 0; i < count; i++)
+		{
+			workerPlanners.push_back(CreatePathPlanner(pathPlannerData, searchSpace));
 		}
 
-		// set planner to the scheduler
-		pathRequestScheduler.SetPathPlanner(pathPlanner);
+		pathRequestScheduler.SetWorkerPlanners(workerPlanners);
 	}
 
 	// Request path
@@ -92,18 +124,101 @@ public:
 		return pathRequestScheduler.AddRequest(requestData);
 	}
 
+	// Request flow field (a field towards the goal that many agents can follow).
+	// Only whole grids build flow fields: on other search spaces (e.g. tiled or layered grids) the callback is called
+	// with PathNotFound_SearchSpaceNotSupported by the next update.
+	PathRequestId RequestFlowField(const FlowFieldRequestData& requestData)
+	{
+		// add the request to the scheduler
+		return pathRequestScheduler.AddFlowFieldRequest(requestData);
+	}
+
+	// Set cells walkable (cells at the positions, searches are restarted and kept updated paths are repaired)
+	void SetCellsWalkable(const std::vector<MathGeom::Vector3>& positions, bool walkable)
+	{
+		pathRequestScheduler.SetCellsWalkable(positions, walkable);
+	}
+
+	// Set cells cost (cells at the positions, e.g. mud or danger zones; searches are restarted and kept updated paths are repaired)
+	void SetCellsCost(const std::vector<MathGeom::Vector3>& positions, uint8_t cost)
+	{
+		pathRequestScheduler.SetCellsCost(positions, cost);
+	}
+
+	// Set streaming positions (e.g. of the agents, search spaces loaded on demand keep the nodes around them loaded)
+	void SetStreamingPositions(const std::vector<MathGeom::Vector3>& positions)
+	{
+		pathRequestScheduler.SetStreamingPositions(positions);
+	}
+
+	// Move path start (start of a kept updated path, e.g. as the agent follows it)
+	void MovePathStart(PathRequestId requestId, const MathGeom::Vector3& start)
+	{
+		pathRequestScheduler.MovePathStart(requestId, start);
+	}
+
 	// Cancel request
 	void CancelRequest(PathRequestId requestId)
 	{
 		return pathRequestScheduler.CancelRequest(requestId);
 	}
 
-	// Update
+	// Update (a single search slice)
 	void Update()
 	{
 		pathRequestScheduler.Update();
 	}
 
+	// Update (keep searching until the time budget is used up)
+	void Update(std::chrono::microseconds budget)
+	{
+		pathRequestScheduler.Update(budget);
+	}
+
+	// Get scheduler frame stats
+	const PathRequestSchedulerFrameStats& GetSchedulerFrameStats() const
+	{
+		return pathRequestScheduler.GetFrameStats();
+	}
+
+	// Get request queue stats
+	const PathRequestQueueStats& GetRequestQueueStats(PathRequestPriority priority) const
+	{
+		return pathRequestScheduler.GetQueueStats(priority);
+	}
+
+	// Get coalesced request count
+	size_t GetCoalescedRequestCount() const
+	{
+		return pathRequestScheduler.GetCoalescedRequestCount();
+	}
+
+	// Get path cache stats
+	const PathCacheStats& GetPathCacheStats() const
+	{
+		return pathRequestScheduler.GetPathCache().GetStats();
+	}
+
+	// Get flow field cache stats
+	const FlowFieldCacheStats& GetFlowFieldCacheStats() const
+	{
+		return pathRequestScheduler.GetFlowFieldCache().GetStats();
+	}
+
+	// Set path cache memory cap (bytes, 0 disables the cache)
+	void SetPathCacheMemoryCap(size_t cap)
+	{
+		pathRequestSchedulerData.pathCacheMemoryCap = cap;
+		pathRequestScheduler.GetPathCache().SetMemoryCap(cap);
+	}
+
+	// Set path smoothing (post-processing of the paths notified from now on)
+	void SetPathSmoothing(PathSmoothing smoothing)
+	{
+		pathRequestSchedulerData.pathSmoothing = smoothing;
+		pathRequestScheduler.SetPathSmoothing(smoothing);
+	}
+
 	// Debug render
 	PathfinderDebugRenderFlags debugRenderFlags;
 	void DebugRender(const MathGeom::Matrix4& viewProjection)
@@ -120,8 +235,159 @@ public:
 		
 	}
 
+	// Create search space (built)
+	static std::shared_ptr<SearchSpace> CreateSearchSpace(const SearchSpaceData& searchSpaceData)
+	{
+		std::shared_ptr<SearchSpace> searchSpace;
+		switch (searchSpaceData.searchSpaceType)
+		{
+		case SearchSpaceType::OCTILE_GRID:
+			searchSpace = std::make_shared<NavGrid>(searchSpaceData);
+			break;
+		case SearchSpaceType::COMPACT_OCTILE_GRID:
+			searchSpace = std::make_shared<CompactNavGrid>(searchSpaceData);
+			break;
+		case SearchSpaceType::HIERARCHICAL_OCTILE_GRID:
+			searchSpace = std::make_shared<HierarchicalNavGrid>(searchSpaceData);
+			break;
+		case SearchSpaceType::TILED_OCTILE_GRID:
+			searchSpace = std::make_shared<TiledNavGrid>(searchSpaceData);
+			break;
+		case SearchSpaceType::LAYERED_OCTILE_GRID:
+			searchSpace = std::make_shared<LayeredNavGrid>(searchSpaceData);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		// build search space
+		if (searchSpace)
+		{
+			searchSpace->Build();
+		}
+
+		return searchSpace;
+	}
+
+	// Create path planner
+	static std::shared_ptr<PathPlanner> CreatePathPlanner(const PathPlannerData& pathPlannerData, std::shared_ptr<SearchSpace> searchSpace)
+	{
+		switch (pathPlannerData.type)
+		{
+		case PathPlannerType::A_STAR:
+			return CreateAStar(pathPlannerData, searchSpace);
+		case PathPlannerType::JUMP_POINT_SEARCH:
+			return CreateJumpPointSearch<JumpPointSearchPlanner>(pathPlannerData, searchSpace);
+		case PathPlannerType::BIT_JUMP_POINT_SEARCH:
+			return CreateJumpPointSearch<BitJumpPointSearchPlanner>(pathPlannerData, searchSpace);
+		case PathPlannerType::JUMP_POINT_SEARCH_PLUS:
+			return CreateJumpPointSearch<JumpPointSearchPlusPlanner>(pathPlannerData, searchSpace);
+		case PathPlannerType::HIERARCHICAL_A_STAR:
+			return std::make_shared<HierarchicalPathPlanner>(pathPlannerData, searchSpace);
+		case PathPlannerType::D_STAR_LITE:
+			return std::make_shared<DStarLite>(pathPlannerData, searchSpace);
+		case PathPlannerType::BIDIRECTIONAL_A_STAR:
+			return std::make_shared<BidirectionalAStar>(pathPlannerData, searchSpace);
+		case PathPlannerType::ANYTIME_A_STAR:
+			return std::make_shared<AnytimeAStar>(pathPlannerData, searchSpace);
+		case PathPlannerType::LAZY_THETA_STAR:
+			return std::make_shared<LazyThetaStar>(pathPlannerData, searchSpace);
+		default:
+			assert(false);
+			break;
+		}
+
+		return nullptr;
+	}
+
 private:
 
+	// Create A* (with the heuristic of the planner data)
+	static std::shared_ptr<PathPlanner> CreateAStar(const PathPlannerData& pathPlannerData, std::shared_ptr<SearchSpace> searchSpace)
+	{
+		switch (pathPlannerData.heuristic)
+		{
+		case PathPlannerHeuristic::OCTILE:
+			return CreateAStar(pathPlannerData, searchSpace, OctileHeuristic());
+		case PathPlannerHeuristic::EUCLIDEAN:
+			return CreateAStar(pathPlannerData, searchSpace, EuclideanHeuristic());
+		case PathPlannerHeuristic::MANHATTAN:
+			return CreateAStar(pathPlannerData, searchSpace, ManhattanHeuristic());
+		case PathPlannerHeuristic::LANDMARK:
+		{
+			auto grid = std::dynamic_pointer_cast<GridSearchSpace>(searchSpace);
+			return CreateAStar(pathPlannerData, searchSpace, LandmarkHeuristic(grid ? &grid->GetLandmarks() : nullptr));
+		}
+		case PathPlannerHeuristic::LAYER:
+		{
+			auto layeredGrid = std::dynamic_pointer_cast<LayeredNavGrid>(searchSpace);
+			return CreateAStar(pathPlannerData, searchSpace, LayerHeuristic(layeredGrid ? &layeredGrid->GetLayerLinks() : nullptr));
+		}
+		default:
+			assert(false);
+			break;
+		}
+
+		return nullptr;
+	}
+
+	// Create A* (weighted if the planner data asks for it)
+	template<class Heuristic>
+	static std::shared_ptr<PathPlanner> CreateAStar(const PathPlannerData& pathPlannerData, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic)
+	{
+		if (pathPlannerData.heuristicWeight != 1.0f)
+		{
+			WeightedHeuristic<Heuristic> weightedHeuristic(heuristic, pathPlannerData.heuristicWeight);
+			return std::make_shared<AStarPlanner<WeightedHeuristic<Heuristic>>>(pathPlannerData, searchSpace, weightedHeuristic, OctileEdgeCost(searchSpace->GetCellCosts()));
+		}
+
+		return std::make_shared<AStarPlanner<Heuristic>>(pathPlannerData, searchSpace, heuristic, OctileEdgeCost(searchSpace->GetCellCosts()));
+	}
+
+	// Create JPS, bit JPS or JPS+ (with the heuristic of the planner data).
+	// Their paths are only as short as those of A* with admissible heuristics, so manhattan, which overestimates
+	// diagonal moves, is replaced by octile (a weight above 1 still trades path length for speed).
+	template<template<class> class Planner>
+	static std::shared_ptr<PathPlanner> CreateJumpPointSearch(const PathPlannerData& pathPlannerData, std::shared_ptr<SearchSpace> searchSpace)
+	{
+		switch (pathPlannerData.heuristic)
+		{
+		case PathPlannerHeuristic::OCTILE:
+		case PathPlannerHeuristic::MANHATTAN:
+			return CreateJumpPointSearch<Planner>(pathPlannerData, searchSpace, OctileHeuristic());
+		case PathPlannerHeuristic::EUCLIDEAN:
+			return CreateJumpPointSearch<Planner>(pathPlannerData, searchSpace, EuclideanHeuristic());
+		case PathPlannerHeuristic::LANDMARK:
+		{
+			auto grid = std::dynamic_pointer_cast<GridSearchSpace>(searchSpace);
+			return CreateJumpPointSearch<Planner>(pathPlannerData, searchSpace, LandmarkHeuristic(grid ? &grid->GetLandmarks() : nullptr));
+		}
+		case PathPlannerHeuristic::LAYER:
+		{
+			auto layeredGrid = std::dynamic_pointer_cast<LayeredNavGrid>(searchSpace);
+			return CreateJumpPointSearch<Planner>(pathPlannerData, searchSpace, LayerHeuristic(layeredGrid ? &layeredGrid->GetLayerLinks() : nullptr));
+		}
+		default:
+			assert(false);
+			break;
+		}
+
+		return nullptr;
+	}
+
+	// Create JPS, bit JPS or JPS+ (weighted if the planner data asks for it)
+	template<template<class> class Planner, class Heuristic>
+	static std::shared_ptr<PathPlanner> CreateJumpPointSearch(const PathPlannerData& pathPlannerData, std::shared_ptr<SearchSpace> searchSpace, const Heuristic& heuristic)
+	{
+		if (pathPlannerData.heuristicWeight != 1.0f)
+		{
+			WeightedHeuristic<Heuristic> weightedHeuristic(heuristic, pathPlannerData.heuristicWeight);
+			return std::make_shared<Planner<WeightedHeuristic<Heuristic>>>(pathPlannerData, searchSpace, weightedHeuristic);
+		}
+
+		return std::make_shared<Planner<Heuristic>>(pathPlannerData, searchSpace, heuristic);
+	}
 };
 
 #endif // !PATHFINDING_SYSTEM_H
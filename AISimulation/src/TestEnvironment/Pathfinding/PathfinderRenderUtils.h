@@ -0,0 +1,26 @@
+#ifndef PATHFINDER_RENDER_UTILS_H
+#define PATHFINDER_RENDER_UTILS_H
+
+// Render utils used by the pathfinder debug rendering.
+// Headless builds (PATHFINDER_HEADLESS, like the pathfinding benchmark) get a version that draws nothing,
+// so the pathfinder compiles without OpenGL.
+#ifndef PATHFINDER_HEADLESS
+
+#include "../Render/RenderUtils.h"
+
+#else
+
+#include "../MathGeom.h"
+#include "../Transform.h"
+
+class RenderUtils
+{
+public:
+
+	// Render cube
+	static void RenderCube(const MathGeom::Matrix4& viewProjection, const Transform& transform, unsigned hexColor) {}
+};
+
+#endif // !PATHFINDER_HEADLESS
+
+#endif // !PATHFINDER_RENDER_UTILS_H
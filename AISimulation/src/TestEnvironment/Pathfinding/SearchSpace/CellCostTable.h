@@ -0,0 +1,102 @@
+#ifndef CELL_COST_TABLE_H
+#define CELL_COST_TABLE_H
+
+#include <cstdint>
+
+#include "NavDataArray.h"
+#include "../PathNode.h"
+
+// cost of the cells that were not given one (the cheapest terrain, e.g. roads)
+static const uint8_t CELL_COST_DEFAULT = 0;
+
+// cell cost of one more time the cost of a default cell (a cell of cost 16 costs twice as much to cross)
+static const float CELL_COST_UNIT = 16.0f;
+
+// Cell cost table (traversal cost of every cell, e.g. mud, roads or danger zones).
+// One byte per cell: the extra cost of crossing the cell in CELL_COST_UNIT steps, so the multiplier of a cell goes
+// from 1 (default) to about 17 (255). A move between two adjacent cells costs its length times the mean multiplier
+// of both cells, so moves cost the same both ways and never less than their length: distance heuristics and tables
+// computed without costs (e.g. landmarks) stay admissible. The table is only allocated once a cell is given a cost,
+// and moves are not scaled at all while every cell has the default cost.
+class CellCostTable
+{
+	// cost of every cell (empty while every cell has the default cost)
+	NavDataArray<uint8_t> costs;
+
+	// cells without the default cost
+	size_t costlyCellCount{ 0 };
+
+public:
+
+	// Clear (every cell has the default cost)
+	void Clear()
+	{
+		costs.clear();
+		costlyCellCount = 0;
+	}
+
+	// Attach (costs of a mapped nav data file, false if they do not match)
+	bool Attach(uint8_t* mappedCosts, size_t count, size_t nodeCount)
+	{
+		if (count != nodeCount)
+		{
+			return false;
+		}
+
+		Clear();
+		costs.Attach(mappedCosts, count);
+		for (size_t node = 0; node < count; node++)
+		{
+			costlyCellCount += costs[node] != CELL_COST_DEFAULT ? 1 : 0;
+		}
+
+		return true;
+	}
+
+	// Set cost (true if it changed)
+	bool SetCost(PathNodeId node, uint8_t cost, size_t nodeCount)
+	{
+		if (GetCost(node) == cost)
+		{
+			return false;
+		}
+
+		if (costs.empty())
+		{
+			costs.assign(nodeCount, CELL_COST_DEFAULT);
+		}
+
+		costlyCellCount -= costs[node] != CELL_COST_DEFAULT ? 1 : 0;
+		costlyCellCount += cost != CELL_COST_DEFAULT ? 1 : 0;
+		costs[node] = cost;
+
+		return true;
+	}
+
+	// Get cost
+	uint8_t GetCost(PathNodeId node) const { return costs.empty() ? CELL_COST_DEFAULT : costs[node]; }
+
+	// Has costs (some cell does not have the default cost)
+	bool HasCosts() const { return costlyCellCount > 0; }
+
+	// Get move multiplier (of the move between two adjacent cells, the table must have costs)
+	float GetMoveMultiplier(PathNodeId from, PathNodeId to) const
+	{
+		return 1.0f + (float(costs[from]) + float(costs[to])) * (0.5f / CELL_COST_UNIT);
+	}
+
+	// Get cell multiplier (of a cell)
+	float GetCellMultiplier(PathNodeId node) const { return 1.0f + float(GetCost(node)) / CELL_COST_UNIT; }
+
+	// Get costs (to write them to nav data files, nullptr while every cell has the default cost)
+	const uint8_t* GetCosts() const { return costs.data(); }
+	size_t GetCostCount() const { return costs.size(); }
+
+	// Get costly cell count (cells without the default cost)
+	size_t GetCostlyCellCount() const { return costlyCellCount; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return costs.size() * sizeof(uint8_t); }
+};
+
+#endif // !CELL_COST_TABLE_H
@@ -0,0 +1,63 @@
+#ifndef COMPACT_NAVGRID_H
+#define COMPACT_NAVGRID_H
+
+#include "GridSearchSpace.h"
+#include "NodeBitset.h"
+
+// Grid that only stores one walkable bit per cell.
+// Neighbours and positions are derived from the node id, so a 4096x4096 grid takes 2MB.
+class CompactNavGrid : public GridSearchSpace
+{
+	// walkable cells
+	NodeBitset walkable;
+
+public:
+
+	// Constructors
+	CompactNavGrid() = default;
+	CompactNavGrid(const SearchSpaceData& data)
+		: GridSearchSpace(data)
+	{
+	}
+
+	// Get node position
+	MathGeom::Vector3 GetNodePosition(PathNodeId node) const override 
+	{ 
+		assert(node != INVALID_PATH_NODE_ID);
+		return GetCellPosition(GetCellX(node), GetCellZ(node)); 
+	}
+
+	// Is walkable
+	bool IsWalkable(PathNodeId node) const override final { return node != INVALID_PATH_NODE_ID && walkable.Get(node); }
+
+	// Get neighbour
+	PathNodeId GetNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const override { return GetCellNeighbour(node, adjacency); }
+
+	// Get valid neighbours
+	size_t GetValidNeighbours(PathNodeId node, PathNodeNeighbours& neighbours) override { return GetValidCellNeighbours(*this, node, neighbours); }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return walkable.GetMemoryUsage(); }
+
+protected:
+
+	// Create cells
+	void CreateCells() override
+	{
+		walkable.Init(GetNodeCount(), true);
+	}
+
+	// Set walkable
+	void SetWalkable(PathNodeId node, bool isWalkable) override
+	{
+		walkable.Set(node, isWalkable);
+	}
+
+	// Load cells (the walkable bits of mapped nav data are used in place)
+	bool LoadCells(uint64_t* walkableNodes, size_t wordCount) override
+	{
+		return walkable.Attach(GetNodeCount(), walkableNodes, wordCount);
+	}
+};
+
+#endif // !COMPACT_NAVGRID_H
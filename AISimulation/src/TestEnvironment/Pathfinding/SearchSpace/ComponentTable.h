@@ -0,0 +1,294 @@
+#ifndef COMPONENT_TABLE_H
+#define COMPONENT_TABLE_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "SearchSpace.h"
+#include "NavDataArray.h"
+
+// component of the nodes that are not walkable
+static const uint32_t NO_COMPONENT = 0;
+
+// Component table (connected components of the walkable nodes).
+// Nodes with the same component are joined by a path, so a request between different components can be rejected
+// without searching. Components are kept up to date one node at a time: a node made walkable joins the components
+// around it (the smaller ones take the label of the largest), a node made blocked only splits its component when the
+// nodes around it are no longer joined around it, and then the parts are labelled again by flood fill.
+// Nodes are expected to have 8 neighbours in PathNodeAdjacency order, around them (grids). Links past them (e.g. to
+// other layers) are followed when components are joined and filled, but a blocked node only splits what its ring
+// splits, so parts only joined through its links keep one label (they are then taken as reachable).
+class ComponentTable
+{
+	// component of every node
+	NavDataArray<uint32_t> components;
+
+	// nodes of every component (labels are not reused until the next build)
+	std::vector<size_t> componentSizes;
+
+	// components with nodes
+	size_t componentCount{ 0 };
+
+	// flood fill queue (kept to reuse its memory)
+	std::vector<PathNodeId> queue;
+
+public:
+
+	// Build (the search space must be built)
+	void Build(SearchSpace& searchSpace)
+	{
+		Clear();
+
+		size_t nodeCount = searchSpace.GetNodeCount();
+		components.assign(nodeCount, NO_COMPONENT);
+
+		for (PathNodeId node = 0; node < nodeCount; node++)
+		{
+			if (components[node] == NO_COMPONENT && searchSpace.IsWalkable(node))
+			{
+				Fill(searchSpace, node, NO_COMPONENT, NewComponent());
+			}
+		}
+	}
+
+	// Attach (components of a mapped nav data file and the size of every component, false if they do not match)
+	bool Attach(uint32_t* mappedComponents, size_t count, const uint64_t* sizes, size_t sizeCount)
+	{
+		if (count == 0 || sizeCount == 0 || sizes[0] != 0)
+		{
+			return false;
+		}
+
+		Clear();
+		componentSizes.assign(sizes, sizes + sizeCount);
+		for (size_t size : componentSizes)
+		{
+			componentCount += size > 0 ? 1 : 0;
+		}
+
+		components.Attach(mappedComponents, count);
+		return true;
+	}
+
+	// Clear
+	void Clear()
+	{
+		components.clear();
+		componentSizes.assign(1, 0);
+		componentCount = 0;
+	}
+
+	// Is built
+	bool IsBuilt() const { return !components.empty(); }
+
+	// Update (after the node was made walkable or blocked)
+	void Update(SearchSpace& searchSpace, PathNodeId node)
+	{
+		if (!IsBuilt())
+		{
+			return;
+		}
+
+		if (searchSpace.IsWalkable(node))
+		{
+			Join(searchSpace, node);
+		}
+		else
+		{
+			Split(searchSpace, node);
+		}
+	}
+
+	// Get component (NO_COMPONENT for nodes that are not walkable)
+	uint32_t GetComponent(PathNodeId node) const
+	{
+		return node < components.size() ? components[node] : NO_COMPONENT;
+	}
+
+	// Are connected (both nodes are walkable and a path joins them)
+	bool AreConnected(PathNodeId nodeA, PathNodeId nodeB) const
+	{
+		uint32_t component = GetComponent(nodeA);
+		return component != NO_COMPONENT && component == GetComponent(nodeB);
+	}
+
+	// Get component count
+	size_t GetComponentCount() const { return componentCount; }
+
+	// Get components (to write them to nav data files)
+	const uint32_t* GetComponents() const { return components.data(); }
+	size_t GetNodeCount() const { return components.size(); }
+
+	// Get component sizes (nodes of every component label)
+	const std::vector<size_t>& GetComponentSizes() const { return componentSizes; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return components.size() * sizeof(uint32_t) + componentSizes.size() * sizeof(size_t); }
+
+private:
+
+	// Join (a node made walkable joins the components of its neighbours)
+	void Join(SearchSpace& searchSpace, PathNodeId node)
+	{
+		PathNodeNeighbours neighbours;
+		size_t neighbourCount = searchSpace.GetValidNeighbours(node, neighbours);
+
+		// the largest component keeps its label
+		uint32_t largest = NO_COMPONENT;
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			uint32_t component = components[neighbours[i]];
+			if (componentSizes[component] > componentSizes[largest])
+			{
+				largest = component;
+			}
+		}
+
+		if (largest == NO_COMPONENT)
+		{
+			largest = NewComponent();
+		}
+
+		components[node] = largest;
+		componentSizes[largest]++;
+
+		for (size_t i = 0; i < neighbourCount; i++)
+		{
+			uint32_t component = components[neighbours[i]];
+			if (component != largest)
+			{
+				Fill(searchSpace, neighbours[i], component, largest);
+			}
+		}
+	}
+
+	// Split (a node made blocked may split its component, only paths through the node or around its corners are lost)
+	void Split(SearchSpace& searchSpace, PathNodeId node)
+	{
+		uint32_t component = components[node];
+		if (component == NO_COMPONENT)
+		{
+			return;
+		}
+
+		components[node] = NO_COMPONENT;
+		RemoveNodes(component, 1);
+
+		// group the neighbours joined around the node (next ones in the ring, and straight ones through a corner)
+		const int RING_SIZE = (int)PathNodeAdjacency::MAX_ADJACENCY;
+
+		PathNodeNeighbours ring;
+		std::array<int, RING_SIZE> groups;
+		for (int i = 0; i < RING_SIZE; i++)
+		{
+			ring[i] = searchSpace.GetNeighbour(node, PathNodeAdjacency(i));
+			groups[i] = searchSpace.IsWalkable(ring[i]) ? i : -1;
+		}
+
+		for (int i = 0; i < RING_SIZE; i++)
+		{
+			// PathNodeAdjacency alternates diagonal and straight directions, starting with TOP_LEFT
+			JoinGroups(searchSpace, ring, groups, i, (i + 1) % RING_SIZE);
+			if ((i & 1) != 0)
+			{
+				JoinGroups(searchSpace, ring, groups, i, (i + 2) % RING_SIZE);
+			}
+		}
+
+		// every group but the last one is labelled again (unless a previous fill reached it, the split did not cut them)
+		int lastGroup = -1;
+		for (int i = 0; i < RING_SIZE; i++)
+		{
+			if (groups[i] == i)
+			{
+				lastGroup = i;
+			}
+		}
+
+		for (int i = 0; i < lastGroup; i++)
+		{
+			if (groups[i] == i && components[ring[i]] == component)
+			{
+				Fill(searchSpace, ring[i], component, NewComponent());
+			}
+		}
+	}
+
+	// Join groups (of two nodes of the ring, if the move between them is valid)
+	static void JoinGroups(SearchSpace& searchSpace, const PathNodeNeighbours& ring, std::array<int, (int)PathNodeAdjacency::MAX_ADJACENCY>& groups, int a, int b)
+	{
+		if (groups[a] < 0 || groups[b] < 0 || !searchSpace.IsValidAdjacency(ring[a], ring[b]))
+		{
+			return;
+		}
+
+		int from = std::max(groups[a], groups[b]);
+		int to = std::min(groups[a], groups[b]);
+		for (int& group : groups)
+		{
+			if (group == from)
+			{
+				group = to;
+			}
+		}
+	}
+
+	// Fill (the nodes of a component reached from the seed take another one)
+	void Fill(SearchSpace& searchSpace, PathNodeId seed, uint32_t from, uint32_t to)
+	{
+		size_t count = 1;
+
+		components[seed] = to;
+		queue.clear();
+		queue.push_back(seed);
+
+		PathNodeNeighbours neighbours;
+		while (!queue.empty())
+		{
+			PathNodeId current = queue.back();
+			queue.pop_back();
+
+			size_t neighbourCount = searchSpace.GetValidNeighbours(current, neighbours);
+			for (size_t i = 0; i < neighbourCount; i++)
+			{
+				PathNodeId neighbour = neighbours[i];
+				if (components[neighbour] == from)
+				{
+					components[neighbour] = to;
+					queue.push_back(neighbour);
+					count++;
+				}
+			}
+		}
+
+		RemoveNodes(from, count);
+		componentSizes[to] += count;
+	}
+
+	// New component
+	uint32_t NewComponent()
+	{
+		componentSizes.push_back(0);
+		componentCount++;
+		return uint32_t(componentSizes.size() - 1);
+	}
+
+	// Remove nodes (from a component, which is gone when it has none left)
+	void RemoveNodes(uint32_t component, size_t count)
+	{
+		if (component == NO_COMPONENT)
+		{
+			return;
+		}
+
+		componentSizes[component] -= count;
+		if (componentSizes[component] == 0)
+		{
+			componentCount--;
+		}
+	}
+};
+
+#endif // !COMPONENT_TABLE_H
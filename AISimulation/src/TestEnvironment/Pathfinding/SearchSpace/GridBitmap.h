@@ -0,0 +1,143 @@
+#ifndef GRID_BITMAP_H
+#define GRID_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+#include "NavDataArray.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Count trailing zeros (bits must not be 0)
+inline int CountTrailingZeros(uint64_t bits)
+{
+	assert(bits != 0);
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return int(index);
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+// Count leading zeros (bits must not be 0)
+inline int CountLeadingZeros(uint64_t bits)
+{
+	assert(bits != 0);
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, bits);
+	return 63 - int(index);
+#else
+	return __builtin_clzll(bits);
+#endif
+}
+
+// Grid bitmap, one bit per cell stored row by row.
+// Rows are padded with empty words on both sides and there is an empty row above and below the grid,
+// so 64 cells can be read from any row at any column next to the grid (cells outside of it read as 0).
+class GridBitmap
+{
+	// empty words on each side of a row
+	static const int PADDING_WORDS = 2;
+
+	// size
+	int width{ 0 };
+	int height{ 0 };
+
+	// words per row (padding included)
+	size_t wordsPerRow{ 0 };
+
+	// words
+	NavDataArray<uint64_t> words;
+
+public:
+
+	// Init (all cells cleared)
+	void Init(size_t width, size_t height)
+	{
+		this->width = int(width);
+		this->height = int(height);
+
+		wordsPerRow = (width + 63) / 64 + 2 * PADDING_WORDS;
+		words.assign(wordsPerRow * (height + 2), 0);
+	}
+
+	// Attach (words of a mapped nav data file, laid out as Init does for the size; false if the count does not match)
+	bool Attach(size_t width, size_t height, uint64_t* mappedWords, size_t wordCount)
+	{
+		size_t rowWords = (width + 63) / 64 + 2 * PADDING_WORDS;
+		if (wordCount != rowWords * (height + 2))
+		{
+			return false;
+		}
+
+		this->width = int(width);
+		this->height = int(height);
+
+		wordsPerRow = rowWords;
+		words.Attach(mappedWords, wordCount);
+		return true;
+	}
+
+	// Get words (padding included, to write them to nav data files)
+	const uint64_t* GetWords() const { return words.data(); }
+	size_t GetWordCount() const { return words.size(); }
+
+	// Get width/height
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+
+	// Get
+	bool Get(int x, int y) const
+	{
+		return (GetBits(x, y) & 1) != 0;
+	}
+
+	// Set
+	void Set(int x, int y, bool value)
+	{
+		assert(x >= 0 && x < width && y >= 0 && y < height);
+
+		size_t bit = size_t(x) + PADDING_WORDS * 64;
+		uint64_t& word = GetRow(y)[bit >> 6];
+		uint64_t mask = uint64_t(1) << (bit & 63);
+
+		word = value ? (word | mask) : (word & ~mask);
+	}
+
+	// Get bits (bit i is the cell x + i of row y)
+	uint64_t GetBits(int x, int y) const
+	{
+		assert(x >= -PADDING_WORDS * 64 && x <= width + (PADDING_WORDS - 1) * 64);
+		assert(y >= -1 && y <= height);
+
+		size_t bit = size_t(x + PADDING_WORDS * 64);
+		const uint64_t* row = GetRow(y);
+		size_t word = bit >> 6;
+		size_t shift = bit & 63;
+
+		uint64_t bits = row[word] >> shift;
+		if (shift != 0)
+		{
+			bits |= row[word + 1] << (64 - shift);
+		}
+
+		return bits;
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return words.size() * sizeof(uint64_t); }
+
+private:
+
+	// Get row (row -1 and row height are the empty rows around the grid)
+	uint64_t* GetRow(int y) { return &words[size_t(y + 1) * wordsPerRow]; }
+	const uint64_t* GetRow(int y) const { return &words[size_t(y + 1) * wordsPerRow]; }
+};
+
+#endif // !GRID_BITMAP_H
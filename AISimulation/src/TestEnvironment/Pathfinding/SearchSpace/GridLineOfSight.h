@@ -0,0 +1,185 @@
+#ifndef GRID_LINE_OF_SIGHT_H
+#define GRID_LINE_OF_SIGHT_H
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+#include "GridBitmap.h"
+
+// Grid line of sight.
+// A segment has line of sight when every cell it goes through (supercover) is walkable. Where it goes exactly
+// through a cell corner the diagonal move rule of the grids applies: one of the two cells next to the corner has
+// to be walkable, so a line of sight between adjacent cells is the same as a valid adjacency.
+// It only reads the walkable bitmaps (one bit per cell), so it is cheap on cache and can be used by any system
+// holding them. Straight lines are tested 64 cells at a time.
+class GridLineOfSight
+{
+	// walkable cells by rows (x, z) and by columns (z, x)
+	const GridBitmap* rows{ nullptr };
+	const GridBitmap* columns{ nullptr };
+
+public:
+
+	// Constructors
+	GridLineOfSight() = default;
+	GridLineOfSight(const GridBitmap& rows_, const GridBitmap& columns_)
+		: rows(&rows_)
+		, columns(&columns_)
+	{
+	}
+
+	// Has line of sight (between the centres of two cells, exact)
+	bool HasLineOfSight(int x0, int z0, int x1, int z1) const
+	{
+		if (!IsWalkable(x0, z0) || !IsWalkable(x1, z1))
+		{
+			return false;
+		}
+
+		if (z0 == z1)
+		{
+			return IsRunWalkable(*rows, std::min(x0, x1), std::max(x0, x1), z0);
+		}
+
+		if (x0 == x1)
+		{
+			return IsRunWalkable(*columns, std::min(z0, z1), std::max(z0, z1), x0);
+		}
+
+		int countX = abs(x1 - x0);
+		int countZ = abs(z1 - z0);
+		int stepX = x1 > x0 ? 1 : -1;
+		int stepZ = z1 > z0 ? 1 : -1;
+
+		// the i-th vertical border is crossed at (2i + 1) / (2 countX) of the segment and the j-th horizontal one
+		// at (2j + 1) / (2 countZ), so comparing (2i + 1) countZ and (2j + 1) countX gives the next one
+		int x = x0;
+		int z = z0;
+		for (int i = 0, j = 0; i < countX || j < countZ; )
+		{
+			long long crossing = (2LL * i + 1) * countZ - (2LL * j + 1) * countX;
+			if (crossing == 0)
+			{
+				// through the corner
+				if (!IsWalkable(x + stepX, z) && !IsWalkable(x, z + stepZ))
+				{
+					return false;
+				}
+
+				x += stepX;
+				z += stepZ;
+				i++;
+				j++;
+			}
+			else if (crossing < 0)
+			{
+				x += stepX;
+				i++;
+			}
+			else
+			{
+				z += stepZ;
+				j++;
+			}
+
+			if (!IsWalkable(x, z))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Has line of sight (between two points in cell units, e.g. agent positions)
+	bool HasLineOfSight(float x0, float z0, float x1, float z1) const
+	{
+		int x = int(std::floor(x0));
+		int z = int(std::floor(z0));
+		int endX = int(std::floor(x1));
+		int endZ = int(std::floor(z1));
+
+		if (!IsWalkable(x, z) || !IsWalkable(endX, endZ))
+		{
+			return false;
+		}
+
+		float dx = x1 - x0;
+		float dz = z1 - z0;
+		int stepX = dx > 0.0f ? 1 : -1;
+		int stepZ = dz > 0.0f ? 1 : -1;
+
+		// segment parameter (0 to 1) where the next vertical/horizontal cell border is crossed
+		const float infinity = std::numeric_limits<float>::infinity();
+		float deltaX = dx != 0.0f ? 1.0f / fabsf(dx) : infinity;
+		float deltaZ = dz != 0.0f ? 1.0f / fabsf(dz) : infinity;
+		float nextX = dx != 0.0f ? (stepX > 0 ? float(x + 1) - x0 : x0 - float(x)) * deltaX : infinity;
+		float nextZ = dz != 0.0f ? (stepZ > 0 ? float(z + 1) - z0 : z0 - float(z)) * deltaZ : infinity;
+
+		// crossings closer than this are the same corner
+		const float CORNER_EPSILON = 1e-5f;
+
+		while (x != endX || z != endZ)
+		{
+			// the end cell bounds the steps, so rounding errors never take the traversal past it
+			bool crossX = x != endX && (z == endZ || nextX <= nextZ + CORNER_EPSILON);
+			bool crossZ = z != endZ && (x == endX || nextZ <= nextX + CORNER_EPSILON);
+
+			if (crossX && crossZ)
+			{
+				// through the corner
+				if (!IsWalkable(x + stepX, z) && !IsWalkable(x, z + stepZ))
+				{
+					return false;
+				}
+			}
+
+			if (crossX)
+			{
+				x += stepX;
+				nextX += deltaX;
+			}
+
+			if (crossZ)
+			{
+				z += stepZ;
+				nextZ += deltaZ;
+			}
+
+			if (!IsWalkable(x, z))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Is walkable (false outside the grid)
+	bool IsWalkable(int x, int z) const
+	{
+		return x >= 0 && x < rows->GetWidth() && z >= 0 && z < rows->GetHeight() && rows->Get(x, z);
+	}
+
+private:
+
+	// Is run walkable (cells from begin to end, both included, of a row of the bitmap, which holds them)
+	static bool IsRunWalkable(const GridBitmap& bitmap, int begin, int end, int row)
+	{
+		for (int x = begin; x <= end; x += 64)
+		{
+			int count = std::min(end - x + 1, 64);
+			uint64_t mask = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+			if ((bitmap.GetBits(x, row) & mask) != mask)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+#endif // !GRID_LINE_OF_SIGHT_H
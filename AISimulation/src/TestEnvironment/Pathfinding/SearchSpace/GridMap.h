@@ -0,0 +1,139 @@
+#ifndef GRID_MAP_H
+#define GRID_MAP_H
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <sstream>
+#include <cstdint>
+#include <cassert>
+
+// Grid map (walkable cells of a grid, loaded from a file or generated), to build grids other than the test layout
+struct GridMap
+{
+	// size (in cells)
+	size_t width{ 0 };
+	size_t height{ 0 };
+
+	// walkable cells (z * width + x)
+	std::vector<bool> walkable;
+
+	// cell costs (z * width + x, see CellCostTable), empty if every cell has the default cost
+	std::vector<uint8_t> costs;
+
+	// Init
+	void Init(size_t mapWidth, size_t mapHeight, bool isWalkable)
+	{
+		width = mapWidth;
+		height = mapHeight;
+		walkable.assign(width * height, isWalkable);
+		costs.clear();
+	}
+
+	// Is walkable (false outside the map)
+	bool IsWalkable(int x, int z) const
+	{
+		return x >= 0 && x < int(width) && z >= 0 && z < int(height) && walkable[z * width + x];
+	}
+
+	// Set walkable
+	void SetWalkable(int x, int z, bool isWalkable)
+	{
+		assert(x >= 0 && x < int(width) && z >= 0 && z < int(height));
+		walkable[z * width + x] = isWalkable;
+	}
+
+	// Get cost (0, the default cost, outside the map or if no cell has a cost)
+	uint8_t GetCost(int x, int z) const
+	{
+		return !costs.empty() && x >= 0 && x < int(width) && z >= 0 && z < int(height) ? costs[z * width + x] : 0;
+	}
+
+	// Set cost
+	void SetCost(int x, int z, uint8_t cost)
+	{
+		assert(x >= 0 && x < int(width) && z >= 0 && z < int(height));
+		if (costs.empty())
+		{
+			costs.assign(width * height, 0);
+		}
+
+		costs[z * width + x] = cost;
+	}
+
+	// Get walkable count
+	size_t GetWalkableCount() const
+	{
+		size_t count = 0;
+		for (bool isWalkable : walkable)
+		{
+			count += isWalkable ? 1 : 0;
+		}
+
+		return count;
+	}
+
+	// Load Moving AI map (false if it is not a valid octile map).
+	// Rows of the map are z and columns x, '.', 'G' and 'S' are walkable, anything else ('@', 'O', 'T', 'W') is blocked.
+	bool LoadMovingAIMap(std::istream& stream)
+	{
+		std::string line;
+		size_t mapWidth = 0;
+		size_t mapHeight = 0;
+
+		// header
+		while (std::getline(stream, line))
+		{
+			std::istringstream header(line);
+			std::string key;
+			header >> key;
+
+			if (key == "type")
+			{
+				std::string type;
+				header >> type;
+				if (type != "octile")
+				{
+					return false;
+				}
+			}
+			else if (key == "height")
+			{
+				header >> mapHeight;
+			}
+			else if (key == "width")
+			{
+				header >> mapWidth;
+			}
+			else if (key == "map")
+			{
+				break;
+			}
+		}
+
+		if (mapWidth == 0 || mapHeight == 0)
+		{
+			return false;
+		}
+
+		// cells
+		Init(mapWidth, mapHeight, false);
+		for (size_t z = 0; z < height; z++)
+		{
+			if (!std::getline(stream, line))
+			{
+				return false;
+			}
+
+			for (size_t x = 0; x < width && x < line.size(); x++)
+			{
+				char cell = line[x];
+				walkable[z * width + x] = cell == '.' || cell == 'G' || cell == 'S';
+			}
+		}
+
+		return true;
+	}
+};
+
+#endif // !GRID_MAP_H
@@ -0,0 +1,189 @@
+#ifndef GRID_REGION_SEARCH_H
+#define GRID_REGION_SEARCH_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "GridSearchSpace.h"
+#include "../PathPlanner/PathNodeHeap.h"
+
+// cost of a diagonal move relative to a straight one
+static const float GRID_DIAGONAL_COST = 1.41421356f;
+
+// Grid region (cell bounds, inclusive)
+struct GridRegion
+{
+	int minX{ 0 };
+	int minZ{ 0 };
+	int maxX{ -1 };
+	int maxZ{ -1 };
+
+	// Contains
+	bool Contains(int x, int z) const { return x >= minX && x <= maxX && z >= minZ && z <= maxZ; }
+};
+
+// Search that never leaves a region of a grid.
+// Used to compute costs inside the clusters of a hierarchical grid and to refine paths one cluster at a time,
+// so its cost is bound by the region area rather than by the grid size.
+class GridRegionSearch
+{
+	// node states
+	PathNodeSearchStates nodeStates;
+
+	// open list
+	PathNodeHeap open;
+
+	// revolutions performed by the last search
+	size_t revolutions{ 0 };
+
+public:
+
+	// Search costs from the source to every cell of the region it can reach (read them with GetCost)
+	void SearchCosts(GridSearchSpace& grid, PathNodeId source, const GridRegion& region)
+	{
+		Search(grid, source, INVALID_PATH_NODE_ID, region);
+	}
+
+	// Find path (cells from start to goal), false if the goal cannot be reached without leaving the region
+	bool FindPath(GridSearchSpace& grid, PathNodeId start, PathNodeId goal, const GridRegion& region, std::vector<PathNodeId>& cells)
+	{
+		if (!Search(grid, start, goal, region))
+		{
+			return false;
+		}
+
+		size_t first = cells.size();
+		for (PathNodeId node = goal; node != INVALID_PATH_NODE_ID; node = nodeStates.Get(node).parent)
+		{
+			cells.push_back(node);
+		}
+
+		std::reverse(cells.begin() + first, cells.end());
+		return true;
+	}
+
+	// Get cost (from the source of the last search, INFINITY if it was not reached)
+	float GetCost(PathNodeId node)
+	{
+		if (node == INVALID_PATH_NODE_ID || !nodeStates.IsVisited(node) || nodeStates.Get(node).list != PathNodeList::CLOSED)
+		{
+			return INFINITY;
+		}
+
+		return nodeStates.Get(node).gCost;
+	}
+
+	// Get revolutions (of the last search)
+	size_t GetRevolutions() const { return revolutions; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return nodeStates.GetMemoryUsage(); }
+
+	// Get octile distance (shortest distance between two cells when nothing is blocked)
+	static float GetOctileDistance(const GridSearchSpace& grid, PathNodeId nodeA, PathNodeId nodeB)
+	{
+		float dx = fabsf(float(grid.GetCellX(nodeA)) - float(grid.GetCellX(nodeB)));
+		float dz = fabsf(float(grid.GetCellZ(nodeA)) - float(grid.GetCellZ(nodeB)));
+
+		return (std::max(dx, dz) + (GRID_DIAGONAL_COST - 1.0f) * std::min(dx, dz)) * grid.GetCellSize();
+	}
+
+private:
+
+	// Search (to every cell of the region if there is no goal)
+	bool Search(GridSearchSpace& grid, PathNodeId start, PathNodeId goal, const GridRegion& region)
+	{
+		assert(grid.IsWalkable(start));
+
+		if (nodeStates.Size() != grid.GetNodeCount())
+		{
+			nodeStates.Init(grid.GetNodeCount());
+		}
+		else
+		{
+			nodeStates.Reset();
+		}
+
+		open.Clear();
+		revolutions = 0;
+
+		PathNodeSearchState& startState = nodeStates.Get(start);
+		startState.list = PathNodeList::OPEN;
+		startState.hCost = goal != INVALID_PATH_NODE_ID ? GetOctileDistance(grid, start, goal) : 0.0f;
+		startState.fCost = startState.hCost;
+		open.Push(start, startState);
+
+		float diagonalCost = grid.GetCellSize() * GRID_DIAGONAL_COST;
+
+		// cell costs (moves are scaled by them only when some cell has one)
+		const CellCostTable* cellCosts = grid.GetCellCosts()->HasCosts() ? grid.GetCellCosts() : nullptr;
+
+		PathNodeNeighbours neighbours;
+		while (!open.IsEmpty())
+		{
+			revolutions++;
+
+			PathNodeId current = open.Pop();
+			PathNodeSearchState& currentState = nodeStates.Get(current);
+			currentState.list = PathNodeList::CLOSED;
+
+			if (current == goal)
+			{
+				return true;
+			}
+
+			int x = int(grid.GetCellX(current));
+			int z = int(grid.GetCellZ(current));
+
+			size_t count = grid.GetValidNeighbours(current, neighbours);
+			for (size_t i = 0; i < count; i++)
+			{
+				PathNodeId neighbour = neighbours[i];
+				int neighbourX = int(grid.GetCellX(neighbour));
+				int neighbourZ = int(grid.GetCellZ(neighbour));
+				if (!region.Contains(neighbourX, neighbourZ))
+				{
+					continue;
+				}
+
+				PathNodeSearchState& neighbourState = nodeStates.Get(neighbour);
+				if (neighbourState.list == PathNodeList::CLOSED)
+				{
+					continue;
+				}
+
+				float moveCost = neighbourX != x && neighbourZ != z ? diagonalCost : grid.GetCellSize();
+				if (cellCosts)
+				{
+					moveCost *= cellCosts->GetMoveMultiplier(current, neighbour);
+				}
+
+				float gCost = currentState.gCost + moveCost;
+				if (neighbourState.list == PathNodeList::OPEN)
+				{
+					if (gCost < neighbourState.gCost)
+					{
+						neighbourState.parent = current;
+						neighbourState.gCost = gCost;
+						neighbourState.fCost = neighbourState.hCost + gCost;
+						open.DecreaseKey(neighbourState);
+					}
+				}
+				else
+				{
+					neighbourState.list = PathNodeList::OPEN;
+					neighbourState.parent = current;
+					neighbourState.hCost = goal != INVALID_PATH_NODE_ID ? GetOctileDistance(grid, neighbour, goal) : 0.0f;
+					neighbourState.gCost = gCost;
+					neighbourState.fCost = neighbourState.hCost + gCost;
+					open.Push(neighbour, neighbourState);
+				}
+			}
+		}
+
+		return goal == INVALID_PATH_NODE_ID;
+	}
+};
+
+#endif // !GRID_REGION_SEARCH_H
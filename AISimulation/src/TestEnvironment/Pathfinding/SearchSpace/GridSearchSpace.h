@@ -0,0 +1,682 @@
+#ifndef GRID_SEARCH_SPACE_H
+#define GRID_SEARCH_SPACE_H
+
+#include <chrono>
+#include <cstdlib>
+
+#include "SearchSpace.h"
+#include "GridMap.h"
+#include "GridBitmap.h"
+#include "NodeBitset.h"
+#include "GridLineOfSight.h"
+#include "JumpDistanceTable.h"
+#include "LandmarkTable.h"
+#include "ComponentTable.h"
+#include "CellCostTable.h"
+#include "NavData.h"
+
+// Grid search space.
+// Cells of a grid laid on the XZ plane from the anchor position, the node id of a cell is z * totalCellsX + x.
+// Derived grids only decide how cells are stored.
+class GridSearchSpace : public SearchSpace
+{
+protected:
+
+	// cell size
+	float cellSize { 1.0f };
+
+	// total cells
+	size_t totalCellsX { 0 };
+	size_t totalCellsY { 0 };
+	size_t totalCellsZ { 0 };
+
+	// walkable cells by rows (x, z) and by columns (z, x), for planners that scan whole words of cells
+	GridBitmap walkableRows;
+	GridBitmap walkableColumns;
+
+	// jump distances (JPS+)
+	JumpDistanceTable jumpDistances;
+
+	// landmark distances (ALT heuristic)
+	LandmarkTable landmarks;
+
+	// connected components (requests between them are rejected without searching)
+	ComponentTable components;
+
+	// cell costs (mud, roads, danger zones)
+	CellCostTable cellCosts;
+
+	// mapped nav data (tables loaded from it are used in place, so it lives as long as they do)
+	std::shared_ptr<NavData> navData;
+
+public:
+
+	// Constructors
+	GridSearchSpace() = default;
+	GridSearchSpace(const SearchSpaceData& data)
+		: SearchSpace(data)
+		, cellSize(data.gridCellSize)
+	{
+	}
+
+	// Build
+	void Build() override
+	{
+		// prebuilt nav data is used when it can be loaded, the grid is built from the map or test layout otherwise
+		if (!searchSpaceData.navDataFile.empty())
+		{
+			if (LoadNavData(searchSpaceData.navDataFile))
+			{
+				version++;
+				return;
+			}
+
+			printf("Navgrid could not load nav data: %s\n", searchSpaceData.navDataFile.c_str());
+		}
+
+		// calculate total cells
+		auto& worldSize = searchSpaceData.worldSize;
+		auto& gridMap = searchSpaceData.gridMap;
+
+		if (gridMap)
+		{
+			totalCellsX = gridMap->width;
+			totalCellsZ = gridMap->height;
+
+			worldSize.x = totalCellsX * cellSize;
+			worldSize.z = totalCellsZ * cellSize;
+		}
+		else
+		{
+			totalCellsX = int(worldSize.x / cellSize);
+			totalCellsZ = int(worldSize.z / cellSize);
+		}
+
+		totalCellsY = 1;
+
+		// Create cells
+		CreateCells();
+
+		cellCosts.Clear();
+		if (gridMap)
+		{
+			CreateMapLayout(*gridMap);
+		}
+		else
+		{
+			// Note: To be removed when create the grid from static world
+			CreateTestLayout();
+		}
+
+		// Compute adjacency
+		ComputeAdjacency();
+
+		// Build walkable bitmaps
+		BuildWalkableBitmaps();
+
+		// Build connected components
+		components.Build(*this);
+
+		// Build jump distances
+		jumpDistances.Clear();
+		if (searchSpaceData.precomputeJumpDistances)
+		{
+			jumpDistances.Build(walkableRows);
+		}
+
+		// Build landmarks
+		landmarks.Clear();
+		if (searchSpaceData.landmarkCount > 0)
+		{
+			BuildLandmarks();
+		}
+
+		// nothing uses previously loaded nav data anymore
+		navData.reset();
+
+		version++;
+	}
+
+	// Save nav data (cells and tables of the built grid, to be loaded in place through SearchSpaceData::navDataFile)
+	bool SaveNavData(const std::string& fileName) const
+	{
+		NavDataWriter writer;
+
+		NavDataHeader& header = writer.GetHeader();
+		header.totalCellsX = uint32_t(totalCellsX);
+		header.totalCellsZ = uint32_t(totalCellsZ);
+		header.cellSize = cellSize;
+		header.anchorPosition[0] = searchSpaceData.anchorPosition.x;
+		header.anchorPosition[1] = searchSpaceData.anchorPosition.y;
+		header.anchorPosition[2] = searchSpaceData.anchorPosition.z;
+		header.landmarkUnit = landmarks.GetUnit();
+
+		NodeBitset walkableNodes;
+		walkableNodes.Init(GetNodeCount(), false);
+		for (PathNodeId node = 0; node < GetNodeCount(); node++)
+		{
+			walkableNodes.Set(node, IsWalkable(node));
+		}
+
+		writer.AddSection(NavDataSectionType::WALKABLE_NODES, walkableNodes.GetWords(), walkableNodes.GetWordCount() * sizeof(uint64_t));
+		writer.AddSection(NavDataSectionType::WALKABLE_ROWS, walkableRows.GetWords(), walkableRows.GetWordCount() * sizeof(uint64_t));
+		writer.AddSection(NavDataSectionType::WALKABLE_COLUMNS, walkableColumns.GetWords(), walkableColumns.GetWordCount() * sizeof(uint64_t));
+		writer.AddSection(NavDataSectionType::JUMP_DISTANCES, jumpDistances.GetDistances(), jumpDistances.GetDistanceCount() * sizeof(JumpDistance));
+		writer.AddSection(NavDataSectionType::LANDMARKS, landmarks.GetLandmarks().data(), landmarks.GetLandmarks().size() * sizeof(PathNodeId));
+		writer.AddSection(NavDataSectionType::LANDMARK_DISTANCES, landmarks.GetDistances(), landmarks.GetDistanceCount() * sizeof(uint16_t));
+		writer.AddSection(NavDataSectionType::COMPONENTS, components.GetComponents(), components.GetNodeCount() * sizeof(uint32_t));
+
+		std::vector<uint64_t> componentSizes(components.GetComponentSizes().begin(), components.GetComponentSizes().end());
+		writer.AddSection(NavDataSectionType::COMPONENT_SIZES, componentSizes.data(), componentSizes.size() * sizeof(uint64_t));
+
+		if (cellCosts.HasCosts())
+		{
+			writer.AddSection(NavDataSectionType::CELL_COSTS, cellCosts.GetCosts(), cellCosts.GetCostCount() * sizeof(uint8_t));
+		}
+
+		return writer.Write(fileName);
+	}
+
+	// Is nav data loaded (the grid uses the tables of a mapped nav data file)
+	bool IsNavDataLoaded() const { return navData != nullptr; }
+
+	// Set cell walkable (not to be called while a search is running)
+	void SetCellWalkable(int x, int z, bool walkable)
+	{
+		PathNodeId node = GetNodeId(x, z);
+		assert(node != INVALID_PATH_NODE_ID);
+
+		if (IsWalkable(node) == walkable)
+		{
+			return;
+		}
+
+		SetWalkable(node, walkable);
+		walkableRows.Set(x, z, walkable);
+		walkableColumns.Set(z, x, walkable);
+
+		if (jumpDistances.IsBuilt())
+		{
+			jumpDistances.Update(walkableRows, x, z);
+		}
+
+		components.Update(*this, node);
+
+		// landmark distances would no longer be a lower bound (the ALT heuristic falls back to octile until they are rebuilt)
+		landmarks.Clear();
+
+		OnCellWalkableChanged(x, z);
+
+		version++;
+	}
+
+	// Set node walkable (see SetCellWalkable)
+	bool SetNodeWalkable(PathNodeId node, bool walkable) override
+	{
+		SetCellWalkable(int(GetCellX(node)), int(GetCellZ(node)), walkable);
+		return true;
+	}
+
+	// Set node costs (see SearchSpace::SetNodeCosts)
+	bool SetNodeCosts(const std::vector<PathNodeId>& nodes, uint8_t cost) override
+	{
+		std::vector<PathNodeId> changedNodes;
+		for (PathNodeId node : nodes)
+		{
+			assert(node < GetNodeCount());
+			if (cellCosts.SetCost(node, cost, GetNodeCount()))
+			{
+				changedNodes.push_back(node);
+			}
+		}
+
+		if (!changedNodes.empty())
+		{
+			OnCellCostsChanged(changedNodes);
+			version++;
+		}
+
+		return true;
+	}
+
+	// Get cell costs
+	const CellCostTable* GetCellCosts() const override { return &cellCosts; }
+
+	// Localise
+	PathNodeId Localise(const MathGeom::Vector3& position) override
+	{
+		MathGeom::Vector3 anchorToPos = position - searchSpaceData.anchorPosition;
+		if (	anchorToPos.x >= 0 && anchorToPos.x <= searchSpaceData.worldSize.x 
+			&&	anchorToPos.z >= 0 && anchorToPos.z <= searchSpaceData.worldSize.z)
+		{
+			anchorToPos /= cellSize;
+			return GetNodeId(int(anchorToPos.x), int(anchorToPos.z));
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get node count
+	size_t GetNodeCount() const override { return totalCellsX * totalCellsZ; }
+
+	// Is reachable (both cells are in the same connected component)
+	bool IsReachable(PathNodeId from, PathNodeId to) const override { return components.AreConnected(from, to); }
+
+	// Is valid adjacency
+	bool IsValidAdjacency(PathNodeId node, PathNodeId neighbour) override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		if (!IsWalkable(neighbour))
+			return false;
+
+		int x = int(GetCellX(node));
+		int z = int(GetCellZ(node));
+		int dx = int(GetCellX(neighbour)) - x;
+		int dz = int(GetCellZ(neighbour)) - z;
+
+		assert(dx >= -1 && dx <= 1 && dz >= -1 && dz <= 1);
+
+		// a diagonal move is only blocked when both straight cells next to it are blocked
+		if (dx != 0 && dz != 0)
+		{
+			if (!IsWalkable(GetNodeId(x, z + dz)) && !IsWalkable(GetNodeId(x + dx, z)))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Get validated PathNode
+	PathNodeId GetValidatedPathNode(PathNodeId nodeA, PathNodeId nodeB) override
+	{
+		int x = int(GetCellX(nodeA));
+		int z = int(GetCellZ(nodeA));
+		int dx = int(GetCellX(nodeB)) - x;
+		int dz = int(GetCellZ(nodeB)) - z;
+
+		// a diagonal move cutting a blocked corner goes through the walkable straight cell instead
+		// (nodes further apart, like jump points, are returned as they are)
+		if ((dx == 1 || dx == -1) && (dz == 1 || dz == -1))
+		{
+			PathNodeId verticalNode = GetNodeId(x, z + dz);
+			PathNodeId horizontalNode = GetNodeId(x + dx, z);
+
+			if (!IsWalkable(verticalNode))
+			{
+				assert(IsWalkable(horizontalNode));
+				return horizontalNode;
+			}
+
+			if (!IsWalkable(horizontalNode))
+			{
+				assert(IsWalkable(verticalNode));
+				return verticalNode;
+			}
+		}
+
+		return nodeB;
+	}
+
+	// Has line of sight (between two positions, see GridLineOfSight)
+	bool HasLineOfSight(const MathGeom::Vector3& from, const MathGeom::Vector3& to) const
+	{
+		auto& anchorPos = searchSpaceData.anchorPosition;
+
+		// cell space
+		return GetLineOfSight().HasLineOfSight(
+			(from.x - anchorPos.x) / cellSize, (from.z - anchorPos.z) / cellSize,
+			(to.x - anchorPos.x) / cellSize, (to.z - anchorPos.z) / cellSize);
+	}
+
+	// Has line of sight (between the centres of two cells)
+	bool HasLineOfSight(PathNodeId nodeA, PathNodeId nodeB) const
+	{
+		return GetLineOfSight().HasLineOfSight(int(GetCellX(nodeA)), int(GetCellZ(nodeA)), int(GetCellX(nodeB)), int(GetCellZ(nodeB)));
+	}
+
+	// Get line of sight (reads the walkable bitmaps of the grid, so it is only valid while the grid is)
+	GridLineOfSight GetLineOfSight() const { return GridLineOfSight(walkableRows, walkableColumns); }
+
+	// Is cell walkable (false outside the grid)
+	bool IsCellWalkable(int x, int z) const
+	{
+		return x >= 0 && x < int(totalCellsX) && z >= 0 && z < int(totalCellsZ) && walkableRows.Get(x, z);
+	}
+
+	// Get node id (INVALID_PATH_NODE_ID outside the grid)
+	PathNodeId GetNodeId(int x, int z) const
+	{
+		if (x >= 0 && x < int(totalCellsX) && z >= 0 && z < int(totalCellsZ))
+		{
+			return PathNodeId(z * totalCellsX + x);
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get cell coordinates
+	size_t GetCellX(PathNodeId node) const { return node % totalCellsX; }
+	size_t GetCellZ(PathNodeId node) const { return node / totalCellsX; }
+
+	// Get total cells
+	size_t GetTotalCellsX() const { return totalCellsX; }
+	size_t GetTotalCellsZ() const { return totalCellsZ; }
+
+	// Get cell size
+	float GetCellSize() const { return cellSize; }
+
+	// Get anchor position
+	const MathGeom::Vector3& GetAnchorPosition() const { return searchSpaceData.anchorPosition; }
+
+	// Get walkable bitmaps
+	const GridBitmap& GetWalkableRows() const { return walkableRows; }
+	const GridBitmap& GetWalkableColumns() const { return walkableColumns; }
+
+	// Get jump distances
+	const JumpDistanceTable& GetJumpDistances() const { return jumpDistances; }
+
+	// Build landmarks (SearchSpaceData::landmarkCount of them, e.g. again after cells changed; not while a search is running)
+	void BuildLandmarks()
+	{
+		landmarks.Build(*this, searchSpaceData.landmarkCount);
+	}
+
+	// Get landmarks
+	const LandmarkTable& GetLandmarks() const { return landmarks; }
+
+	// Get connected components
+	const ComponentTable& GetComponents() const { return components; }
+
+protected:
+
+	// Create cells (all of them walkable)
+	virtual void CreateCells() = 0;
+
+	// Set walkable
+	virtual void SetWalkable(PathNodeId node, bool walkable) = 0;
+
+	// Compute adjacency
+	virtual void ComputeAdjacency() {}
+
+	// On cell walkable changed (the storage, bitmaps and jump distances are already updated)
+	virtual void OnCellWalkableChanged(int x, int z) {}
+
+	// On cell costs changed (of a batch of nodes, the cost table is already updated)
+	virtual void OnCellCostsChanged(const std::vector<PathNodeId>& nodes) {}
+
+	// Load cells (from the walkable node bits of mapped nav data, cells are created all walkable; false if they do not match)
+	virtual bool LoadCells(uint64_t* walkableNodes, size_t wordCount)
+	{
+		if (wordCount != (GetNodeCount() + 63) / 64)
+		{
+			return false;
+		}
+
+		for (PathNodeId node = 0; node < GetNodeCount(); node++)
+		{
+			if ((walkableNodes[node / 64] & (uint64_t(1) << (node % 64))) == 0)
+			{
+				SetWalkable(node, false);
+			}
+		}
+
+		return true;
+	}
+
+	// Get cell position (centre of the cell)
+	MathGeom::Vector3 GetCellPosition(size_t x, size_t z) const
+	{
+		auto& anchorPos = searchSpaceData.anchorPosition;
+		float halfCellSize = cellSize * 0.5f;
+
+		return MathGeom::Vector3(anchorPos.x + x * cellSize + halfCellSize, anchorPos.y, anchorPos.z + z * cellSize + halfCellSize);
+	}
+
+	// Get cell neighbour
+	PathNodeId GetCellNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		return GetNodeId(
+			int(GetCellX(node)) + GRID_ADJACENCY_OFFSET_X[(int)adjacency], 
+			int(GetCellZ(node)) + GRID_ADJACENCY_OFFSET_Z[(int)adjacency]);
+	}
+
+	// Get valid cell neighbours.
+	// Grid is the concrete grid type (with a final IsWalkable), so the walkable checks are resolved at compile time.
+	template<typename Grid>
+	static size_t GetValidCellNeighbours(const Grid& grid, PathNodeId node, PathNodeNeighbours& neighbours)
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		int x = int(grid.GetCellX(node));
+		int z = int(grid.GetCellZ(node));
+
+		// straight neighbours first, diagonals need to know them
+		std::array<bool, (int)PathNodeAdjacency::MAX_ADJACENCY> walkable;
+		for (int adjacency = 1; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency += 2)
+		{
+			walkable[adjacency] = grid.IsWalkable(grid.GetNodeId(x + GRID_ADJACENCY_OFFSET_X[adjacency], z + GRID_ADJACENCY_OFFSET_Z[adjacency]));
+		}
+
+		size_t count = 0;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			PathNodeId neighbour = grid.GetNodeId(x + GRID_ADJACENCY_OFFSET_X[adjacency], z + GRID_ADJACENCY_OFFSET_Z[adjacency]);
+
+			// PathNodeAdjacency alternates diagonal and straight directions, starting with TOP_LEFT
+			if ((adjacency & 1) == 0)
+			{
+				// diagonal: a diagonal move is only blocked when both straight cells next to it are blocked
+				int previous = (adjacency + 7) % (int)PathNodeAdjacency::MAX_ADJACENCY;
+				int next = adjacency + 1;
+				if (!grid.IsWalkable(neighbour) || (!walkable[previous] && !walkable[next]))
+				{
+					continue;
+				}
+			}
+			else if (!walkable[adjacency])
+			{
+				continue;
+			}
+
+			neighbours[count++] = neighbour;
+		}
+
+		return count;
+	}
+
+private:
+
+	// Load nav data (the grid and its tables are restored as they were if the file can not be used)
+	bool LoadNavData(const std::string& fileName)
+	{
+		auto loadedNavData = std::make_shared<NavData>();
+		if (!loadedNavData->Load(fileName, searchSpaceData.verifyNavData))
+		{
+			return false;
+		}
+
+		const NavDataHeader& header = loadedNavData->GetHeader();
+		if (header.totalCellsX == 0 || header.totalCellsZ == 0 || uint64_t(header.totalCellsX) * header.totalCellsZ >= INVALID_PATH_NODE_ID || !(header.cellSize > 0.0f))
+		{
+			return false;
+		}
+
+		SearchSpaceData previousData = searchSpaceData;
+		float previousCellSize = cellSize;
+
+		// grid
+		cellSize = header.cellSize;
+		totalCellsX = header.totalCellsX;
+		totalCellsY = 1;
+		totalCellsZ = header.totalCellsZ;
+
+		searchSpaceData.anchorPosition = MathGeom::Vector3(header.anchorPosition[0], header.anchorPosition[1], header.anchorPosition[2]);
+		searchSpaceData.worldSize.x = totalCellsX * cellSize;
+		searchSpaceData.worldSize.z = totalCellsZ * cellSize;
+		searchSpaceData.gridCellSize = cellSize;
+
+		if (!LoadTables(*loadedNavData, header.landmarkUnit))
+		{
+			searchSpaceData = previousData;
+			cellSize = previousCellSize;
+			totalCellsX = 0;
+			totalCellsZ = 0;
+			return false;
+		}
+
+		navData = loadedNavData;
+		return true;
+	}
+
+	// Load tables (cells and tables used in place, the optional ones missing from the file are built)
+	bool LoadTables(NavData& loadedNavData, float landmarkUnit)
+	{
+		size_t count = 0;
+
+		// cells
+		CreateCells();
+
+		uint64_t* walkableNodes = loadedNavData.GetSection<uint64_t>(NavDataSectionType::WALKABLE_NODES, count);
+		if (!walkableNodes || !LoadCells(walkableNodes, count))
+		{
+			return false;
+		}
+
+		ComputeAdjacency();
+
+		// walkable bitmaps
+		uint64_t* rowWords = loadedNavData.GetSection<uint64_t>(NavDataSectionType::WALKABLE_ROWS, count);
+		if (!walkableRows.Attach(totalCellsX, totalCellsZ, rowWords, count))
+		{
+			return false;
+		}
+
+		uint64_t* columnWords = loadedNavData.GetSection<uint64_t>(NavDataSectionType::WALKABLE_COLUMNS, count);
+		if (!walkableColumns.Attach(totalCellsZ, totalCellsX, columnWords, count))
+		{
+			return false;
+		}
+
+		// connected components
+		size_t sizeCount = 0;
+		uint32_t* componentLabels = loadedNavData.GetSection<uint32_t>(NavDataSectionType::COMPONENTS, count);
+		const uint64_t* componentSizes = loadedNavData.GetSection<uint64_t>(NavDataSectionType::COMPONENT_SIZES, sizeCount);
+		if (count != GetNodeCount() || !components.Attach(componentLabels, count, componentSizes, sizeCount))
+		{
+			components.Build(*this);
+		}
+
+		// jump distances
+		jumpDistances.Clear();
+		JumpDistance* distances = loadedNavData.GetSection<JumpDistance>(NavDataSectionType::JUMP_DISTANCES, count);
+		if (!jumpDistances.Attach(int(totalCellsX), int(totalCellsZ), distances, count) && searchSpaceData.precomputeJumpDistances)
+		{
+			jumpDistances.Build(walkableRows);
+		}
+
+		// cell costs (every cell has the default cost if the file has none)
+		cellCosts.Clear();
+		uint8_t* costs = loadedNavData.GetSection<uint8_t>(NavDataSectionType::CELL_COSTS, count);
+		if (costs)
+		{
+			cellCosts.Attach(costs, count, GetNodeCount());
+		}
+
+		// landmarks
+		landmarks.Clear();
+
+		size_t landmarkCount = 0;
+		const PathNodeId* landmarkNodes = loadedNavData.GetSection<PathNodeId>(NavDataSectionType::LANDMARKS, landmarkCount);
+		uint16_t* landmarkDistances = loadedNavData.GetSection<uint16_t>(NavDataSectionType::LANDMARK_DISTANCES, count);
+
+		std::vector<PathNodeId> mappedLandmarks(landmarkNodes, landmarkNodes + landmarkCount);
+		if (!landmarks.Attach(mappedLandmarks, landmarkUnit, landmarkDistances, count, GetNodeCount()) && searchSpaceData.landmarkCount > 0)
+		{
+			BuildLandmarks();
+		}
+
+		return true;
+	}
+
+	// Build walkable bitmaps
+	void BuildWalkableBitmaps()
+	{
+		walkableRows.Init(totalCellsX, totalCellsZ);
+		walkableColumns.Init(totalCellsZ, totalCellsX);
+
+		for (PathNodeId node = 0; node < GetNodeCount(); node++)
+		{
+			if (IsWalkable(node))
+			{
+				int x = int(GetCellX(node));
+				int z = int(GetCellZ(node));
+
+				walkableRows.Set(x, z, true);
+				walkableColumns.Set(z, x, true);
+			}
+		}
+	}
+
+	// Create map layout (cells and their costs)
+	void CreateMapLayout(const GridMap& gridMap)
+	{
+		for (PathNodeId node = 0; node < GetNodeCount(); node++)
+		{
+			if (!gridMap.IsWalkable(int(GetCellX(node)), int(GetCellZ(node))))
+			{
+				SetWalkable(node, false);
+			}
+
+			if (!gridMap.costs.empty())
+			{
+				cellCosts.SetCost(node, gridMap.GetCost(int(GetCellX(node)), int(GetCellZ(node))), GetNodeCount());
+			}
+		}
+	}
+
+	// Create test layout
+	void CreateTestLayout()
+	{
+		for (size_t x = 1; x < totalCellsX; x += 3)
+		{
+			for (size_t z = 1; z < totalCellsZ; z += 3)
+			{
+				// 2x2 block
+				size_t startX = x;
+				size_t startZ = z;
+				for (size_t blockX = startX; blockX < startX + 2; blockX++)
+				{
+					for (size_t blockZ = startZ; blockZ < startZ + 2; blockZ++)
+					{
+						PathNodeId node = GetNodeId(int(blockX), int(blockZ));
+						if (node == INVALID_PATH_NODE_ID)
+						{
+							// early exit
+							break;
+						}
+
+						SetWalkable(node, false);
+					}
+				}
+			}
+		}
+
+		std::srand((unsigned)std::chrono::system_clock::now().time_since_epoch().count());
+		int count = 3;
+		while (count > 0)
+		{
+			PathNodeId n = PathNodeId(std::rand() % GetNodeCount());
+			if (IsWalkable(n))
+			{
+				printf("Navgrid random blocked cell index: %d\n", n);
+				SetWalkable(n, false);
+				count--;
+			}
+		}
+	}
+};
+
+#endif // !GRID_SEARCH_SPACE_H
@@ -0,0 +1,404 @@
+#ifndef HIERARCHICAL_NAVGRID_H
+#define HIERARCHICAL_NAVGRID_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "CompactNavGrid.h"
+#include "GridRegionSearch.h"
+
+// entrances at least this wide get a portal at each end instead of a single one in the middle
+static const int HIERARCHICAL_WIDE_ENTRANCE = 6;
+
+// Portal (cell of a cluster next to a walkable cell of a neighbour cluster)
+struct HierarchicalPortal
+{
+	// cell
+	PathNodeId cell{ INVALID_PATH_NODE_ID };
+
+	// portal cells it connects to in neighbour clusters (one straight move away)
+	std::vector<PathNodeId> links;
+};
+
+// Cluster
+struct HierarchicalCluster
+{
+	// cells
+	GridRegion region;
+
+	// portals
+	std::vector<HierarchicalPortal> portals;
+
+	// cost between every pair of portals without leaving the cluster (portal count squared, INFINITY if unreachable)
+	std::vector<float> costs;
+
+	// Get cost
+	float GetCost(size_t portalA, size_t portalB) const { return costs[portalA * portals.size() + portalB]; }
+};
+
+// Hierarchical grid (HPA*).
+// Compact grid split in square clusters, with portals placed along the entrances between neighbour clusters
+// and the costs between the portals of a cluster computed once, so planners can search the small graph of
+// portals and then refine the path one cluster at a time.
+// The grid itself is still a full search space, so every other planner works on it too.
+class HierarchicalNavGrid : public CompactNavGrid
+{
+	// Transition (pair of walkable cells facing each other across the border of two clusters)
+	using Transition = std::pair<PathNodeId, PathNodeId>;
+
+	// cluster size (in cells)
+	int clusterSize{ DEFAULT_HIERARCHICAL_CLUSTER_SIZE };
+
+	// clusters
+	int totalClustersX{ 0 };
+	int totalClustersZ{ 0 };
+	std::vector<HierarchicalCluster> clusters;
+
+	// transitions between each cluster and the cluster to its right (first cell on this cluster)
+	std::vector<std::vector<Transition>> rightTransitions;
+
+	// transitions between each cluster and the cluster below it (first cell on this cluster)
+	std::vector<std::vector<Transition>> bottomTransitions;
+
+	// search used to compute the portal costs
+	GridRegionSearch regionSearch;
+
+public:
+
+	// Constructors
+	HierarchicalNavGrid() = default;
+	HierarchicalNavGrid(const SearchSpaceData& data)
+		: CompactNavGrid(data)
+		, clusterSize(data.hierarchicalClusterSize)
+	{
+		assert(clusterSize > 0);
+	}
+
+	// Build
+	void Build() override
+	{
+		CompactNavGrid::Build();
+
+		BuildAbstractGraph();
+	}
+
+	// Get cluster index
+	size_t GetClusterIndex(PathNodeId node) const
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+		return GetClusterIndex(int(GetCellX(node)) / clusterSize, int(GetCellZ(node)) / clusterSize);
+	}
+
+	// Get cluster
+	const HierarchicalCluster& GetCluster(size_t cluster) const { return clusters[cluster]; }
+
+	// Get cluster count
+	size_t GetClusterCount() const { return clusters.size(); }
+
+	// Get portal index (-1 if the cell is not a portal of the cluster)
+	int GetPortalIndex(size_t cluster, PathNodeId node) const
+	{
+		auto& portals = clusters[cluster].portals;
+		for (size_t portal = 0; portal < portals.size(); portal++)
+		{
+			if (portals[portal].cell == node)
+			{
+				return int(portal);
+			}
+		}
+
+		return -1;
+	}
+
+	// Get portal count
+	size_t GetPortalCount() const
+	{
+		size_t count = 0;
+		for (auto& cluster : clusters)
+		{
+			count += cluster.portals.size();
+		}
+
+		return count;
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const
+	{
+		size_t memoryUsage = CompactNavGrid::GetMemoryUsage() + regionSearch.GetMemoryUsage();
+		for (auto& cluster : clusters)
+		{
+			memoryUsage += sizeof(HierarchicalCluster) + cluster.costs.size() * sizeof(float);
+			for (auto& portal : cluster.portals)
+			{
+				memoryUsage += sizeof(HierarchicalPortal) + portal.links.size() * sizeof(PathNodeId);
+			}
+		}
+
+		for (size_t cluster = 0; cluster < clusters.size(); cluster++)
+		{
+			memoryUsage += (rightTransitions[cluster].size() + bottomTransitions[cluster].size()) * sizeof(Transition);
+		}
+
+		return memoryUsage;
+	}
+
+	// Debug render
+	void DebugRender(const MathGeom::Matrix4& viewProjection) override
+	{
+		CompactNavGrid::DebugRender(viewProjection);
+
+		for (auto& cluster : clusters)
+		{
+			for (auto& portal : cluster.portals)
+			{
+				Transform transform;
+				transform.position = GetNodePosition(portal.cell);
+				transform.scale = MathGeom::Vector3(0.5f, 1.5f, 0.5f);
+				RenderUtils::RenderCube(viewProjection, transform, 0xFFFF00);
+			}
+		}
+	}
+
+protected:
+
+	// On cell walkable changed (only the entrances and costs of the clusters around the cell are rebuilt)
+	void OnCellWalkableChanged(int x, int z) override
+	{
+		if (clusters.empty())
+		{
+			return;
+		}
+
+		int clusterX = x / clusterSize;
+		int clusterZ = z / clusterSize;
+
+		// the four borders of the cluster
+		BuildRightTransitions(clusterX, clusterZ);
+		BuildBottomTransitions(clusterX, clusterZ);
+		if (clusterX > 0)
+		{
+			BuildRightTransitions(clusterX - 1, clusterZ);
+		}
+		if (clusterZ > 0)
+		{
+			BuildBottomTransitions(clusterX, clusterZ - 1);
+		}
+
+		// the cluster and the clusters sharing those borders
+		BuildCluster(clusterX, clusterZ);
+		for (int adjacency = 1; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency += 2)
+		{
+			int neighbourX = clusterX + GRID_ADJACENCY_OFFSET_X[adjacency];
+			int neighbourZ = clusterZ + GRID_ADJACENCY_OFFSET_Z[adjacency];
+			if (neighbourX >= 0 && neighbourX < totalClustersX && neighbourZ >= 0 && neighbourZ < totalClustersZ)
+			{
+				BuildCluster(neighbourX, neighbourZ);
+			}
+		}
+	}
+
+	// On cell costs changed (only the costs of the clusters holding the cells are recomputed, once per cluster;
+	// moves across cluster borders are costed by the planner as it takes them)
+	void OnCellCostsChanged(const std::vector<PathNodeId>& nodes) override
+	{
+		if (clusters.empty())
+		{
+			return;
+		}
+
+		std::vector<size_t> changedClusters;
+		changedClusters.reserve(nodes.size());
+		for (PathNodeId node : nodes)
+		{
+			changedClusters.push_back(GetClusterIndex(node));
+		}
+
+		std::sort(changedClusters.begin(), changedClusters.end());
+		changedClusters.erase(std::unique(changedClusters.begin(), changedClusters.end()), changedClusters.end());
+		for (size_t cluster : changedClusters)
+		{
+			BuildCluster(int(cluster % totalClustersX), int(cluster / totalClustersX));
+		}
+	}
+
+private:
+
+	// Get cluster index
+	size_t GetClusterIndex(int clusterX, int clusterZ) const { return size_t(clusterZ) * totalClustersX + clusterX; }
+
+	// Build abstract graph
+	void BuildAbstractGraph()
+	{
+		totalClustersX = (int(totalCellsX) + clusterSize - 1) / clusterSize;
+		totalClustersZ = (int(totalCellsZ) + clusterSize - 1) / clusterSize;
+
+		size_t clusterCount = size_t(totalClustersX) * totalClustersZ;
+		clusters.clear();
+		clusters.resize(clusterCount);
+		rightTransitions.clear();
+		rightTransitions.resize(clusterCount);
+		bottomTransitions.clear();
+		bottomTransitions.resize(clusterCount);
+
+		for (int clusterZ = 0; clusterZ < totalClustersZ; clusterZ++)
+		{
+			for (int clusterX = 0; clusterX < totalClustersX; clusterX++)
+			{
+				GridRegion& region = clusters[GetClusterIndex(clusterX, clusterZ)].region;
+				region.minX = clusterX * clusterSize;
+				region.minZ = clusterZ * clusterSize;
+				region.maxX = std::min(region.minX + clusterSize, int(totalCellsX)) - 1;
+				region.maxZ = std::min(region.minZ + clusterSize, int(totalCellsZ)) - 1;
+
+				BuildRightTransitions(clusterX, clusterZ);
+				BuildBottomTransitions(clusterX, clusterZ);
+			}
+		}
+
+		for (int clusterZ = 0; clusterZ < totalClustersZ; clusterZ++)
+		{
+			for (int clusterX = 0; clusterX < totalClustersX; clusterX++)
+			{
+				BuildCluster(clusterX, clusterZ);
+			}
+		}
+	}
+
+	// Build right transitions (border between the cluster and the cluster to its right)
+	void BuildRightTransitions(int clusterX, int clusterZ)
+	{
+		auto& transitions = rightTransitions[GetClusterIndex(clusterX, clusterZ)];
+		transitions.clear();
+
+		if (clusterX + 1 >= totalClustersX)
+		{
+			return;
+		}
+
+		auto& region = clusters[GetClusterIndex(clusterX, clusterZ)].region;
+		BuildTransitions(region.maxX, region.minZ, 0, 1, region.maxZ - region.minZ + 1, 1, 0, transitions);
+	}
+
+	// Build bottom transitions (border between the cluster and the cluster below it)
+	void BuildBottomTransitions(int clusterX, int clusterZ)
+	{
+		auto& transitions = bottomTransitions[GetClusterIndex(clusterX, clusterZ)];
+		transitions.clear();
+
+		if (clusterZ + 1 >= totalClustersZ)
+		{
+			return;
+		}
+
+		auto& region = clusters[GetClusterIndex(clusterX, clusterZ)].region;
+		BuildTransitions(region.minX, region.maxZ, 1, 0, region.maxX - region.minX + 1, 0, 1, transitions);
+	}
+
+	// Build transitions along a border.
+	// The border starts at (x, z) and runs for length cells along (dx, dz), the other cluster is one cell along (crossX, crossZ).
+	// Diagonal moves across the border are always next to a straight one, so straight transitions keep every connection.
+	void BuildTransitions(int x, int z, int dx, int dz, int length, int crossX, int crossZ, std::vector<Transition>& transitions)
+	{
+		auto addTransition = [&](int i)
+		{
+			transitions.emplace_back(GetNodeId(x + i * dx, z + i * dz), GetNodeId(x + i * dx + crossX, z + i * dz + crossZ));
+		};
+
+		int entranceStart = -1;
+		for (int i = 0; i <= length; i++)
+		{
+			bool open = i < length
+				&& IsWalkable(GetNodeId(x + i * dx, z + i * dz))
+				&& IsWalkable(GetNodeId(x + i * dx + crossX, z + i * dz + crossZ));
+
+			if (open && entranceStart < 0)
+			{
+				entranceStart = i;
+			}
+			else if (!open && entranceStart >= 0)
+			{
+				// entrance [entranceStart, i - 1]
+				int entranceEnd = i - 1;
+				if (entranceEnd - entranceStart + 1 >= HIERARCHICAL_WIDE_ENTRANCE)
+				{
+					addTransition(entranceStart);
+					addTransition(entranceEnd);
+				}
+				else
+				{
+					addTransition((entranceStart + entranceEnd) / 2);
+				}
+
+				entranceStart = -1;
+			}
+		}
+	}
+
+	// Build cluster (portals from the transitions of its four borders, then the costs between them)
+	void BuildCluster(int clusterX, int clusterZ)
+	{
+		HierarchicalCluster& cluster = clusters[GetClusterIndex(clusterX, clusterZ)];
+		cluster.portals.clear();
+
+		auto addPortal = [&](PathNodeId cell, PathNodeId link)
+		{
+			for (auto& portal : cluster.portals)
+			{
+				if (portal.cell == cell)
+				{
+					portal.links.push_back(link);
+					return;
+				}
+			}
+
+			cluster.portals.push_back({ cell, { link } });
+		};
+
+		for (auto& transition : rightTransitions[GetClusterIndex(clusterX, clusterZ)])
+		{
+			addPortal(transition.first, transition.second);
+		}
+		for (auto& transition : bottomTransitions[GetClusterIndex(clusterX, clusterZ)])
+		{
+			addPortal(transition.first, transition.second);
+		}
+		if (clusterX > 0)
+		{
+			for (auto& transition : rightTransitions[GetClusterIndex(clusterX - 1, clusterZ)])
+			{
+				addPortal(transition.second, transition.first);
+			}
+		}
+		if (clusterZ > 0)
+		{
+			for (auto& transition : bottomTransitions[GetClusterIndex(clusterX, clusterZ - 1)])
+			{
+				addPortal(transition.second, transition.first);
+			}
+		}
+
+		// costs (symmetric, so each search fills a row and a column)
+		size_t portalCount = cluster.portals.size();
+		cluster.costs.assign(portalCount * portalCount, INFINITY);
+		for (size_t portalA = 0; portalA < portalCount; portalA++)
+		{
+			cluster.costs[portalA * portalCount + portalA] = 0.0f;
+			if (portalA + 1 == portalCount)
+			{
+				break;
+			}
+
+			regionSearch.SearchCosts(*this, cluster.portals[portalA].cell, cluster.region);
+			for (size_t portalB = portalA + 1; portalB < portalCount; portalB++)
+			{
+				float cost = regionSearch.GetCost(cluster.portals[portalB].cell);
+				cluster.costs[portalA * portalCount + portalB] = cost;
+				cluster.costs[portalB * portalCount + portalA] = cost;
+			}
+		}
+	}
+};
+
+#endif // !HIERARCHICAL_NAVGRID_H
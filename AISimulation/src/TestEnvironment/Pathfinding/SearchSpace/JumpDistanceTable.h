@@ -0,0 +1,290 @@
+#ifndef JUMP_DISTANCE_TABLE_H
+#define JUMP_DISTANCE_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "GridBitmap.h"
+#include "NavDataArray.h"
+#include "../PathNode.h"
+
+// Jump distance: cells to the next jump point (> 0) or to the first blocked cell (< 0)
+using JumpDistance = int16_t;
+
+// Jump distance table (JPS+).
+// For every cell and PathNodeAdjacency it stores where JumpPointSearch would stop jumping,
+// ignoring the goal, so a jump becomes a lookup. It follows the JumpPointSearch rules:
+// - straight moves stop at a blocked cell or at a cell with a forced neighbour
+// - diagonal moves stop at a blocked cell, at a cell reached between two blocked straight cells (treated as
+//   blocked), at a cell with a forced neighbour or at a cell with a straight jump point along the vertical or
+//   horizontal part of the move
+class JumpDistanceTable
+{
+	// size
+	int width{ 0 };
+	int height{ 0 };
+
+	// distances (MAX_ADJACENCY per cell)
+	NavDataArray<JumpDistance> distances;
+
+	// Stop
+	enum class Stop
+	{
+		NONE,
+		JUMP_POINT,
+		BLOCKED
+	};
+
+public:
+
+	// Build
+	void Build(const GridBitmap& walkable)
+	{
+		width = walkable.GetWidth();
+		height = walkable.GetHeight();
+
+		// distances must fit in a JumpDistance
+		assert(width <= INT16_MAX && height <= INT16_MAX);
+
+		distances.assign(size_t(width) * height * (int)PathNodeAdjacency::MAX_ADJACENCY, 0);
+
+		// straight moves first, diagonal moves depend on them
+		for (int adjacency = 1; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency += 2)
+		{
+			BuildDirection(walkable, PathNodeAdjacency(adjacency));
+		}
+
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency += 2)
+		{
+			BuildDirection(walkable, PathNodeAdjacency(adjacency));
+		}
+	}
+
+	// Attach (distances of a mapped nav data file for a grid of that size, false if the count does not match)
+	bool Attach(int width, int height, JumpDistance* mappedDistances, size_t count)
+	{
+		if (count != size_t(width) * height * (int)PathNodeAdjacency::MAX_ADJACENCY)
+		{
+			return false;
+		}
+
+		this->width = width;
+		this->height = height;
+
+		distances.Attach(mappedDistances, count);
+		return true;
+	}
+
+	// Clear
+	void Clear()
+	{
+		width = 0;
+		height = 0;
+		distances.clear();
+	}
+
+	// Is built
+	bool IsBuilt() const { return !distances.empty(); }
+
+	// Update (the walkability of the cell x, z changed)
+	void Update(const GridBitmap& walkable, int x, int z)
+	{
+		assert(IsBuilt());
+
+		// straight distances read the cells next to the move, so the rows/columns around the cell change
+		for (int row = std::max(z - 1, 0); row <= std::min(z + 1, height - 1); row++)
+		{
+			UpdateRow(walkable, row, PathNodeAdjacency::RIGHT);
+			UpdateRow(walkable, row, PathNodeAdjacency::LEFT);
+		}
+
+		for (int column = std::max(x - 1, 0); column <= std::min(x + 1, width - 1); column++)
+		{
+			UpdateColumn(walkable, column, PathNodeAdjacency::BOTTOM);
+			UpdateColumn(walkable, column, PathNodeAdjacency::TOP);
+		}
+
+		// the diagonal stops that may have changed are in those rows/columns,
+		// walk back from each of them while the distances keep changing
+		std::vector<std::pair<int, int>> cells;
+		for (int row = std::max(z - 1, 0); row <= std::min(z + 1, height - 1); row++)
+		{
+			for (int column = 0; column < width; column++)
+			{
+				cells.emplace_back(column, row);
+			}
+		}
+
+		for (int column = std::max(x - 1, 0); column <= std::min(x + 1, width - 1); column++)
+		{
+			for (int row = 0; row < height; row++)
+			{
+				cells.emplace_back(column, row);
+			}
+		}
+
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency += 2)
+		{
+			int dx = GRID_ADJACENCY_OFFSET_X[adjacency];
+			int dz = GRID_ADJACENCY_OFFSET_Z[adjacency];
+
+			// cells further along the move first, so a cell is final before the cells behind it read it
+			std::sort(cells.begin(), cells.end(), [dx, dz](const std::pair<int, int>& a, const std::pair<int, int>& b)
+			{
+				return a.first * dx + a.second * dz > b.first * dx + b.second * dz;
+			});
+
+			for (auto& cell : cells)
+			{
+				int cellX = cell.first - dx;
+				int cellZ = cell.second - dz;
+				while (IsInside(cellX, cellZ))
+				{
+					JumpDistance distance = ComputeDistance(walkable, cellX, cellZ, PathNodeAdjacency(adjacency));
+					JumpDistance& current = distances[GetIndex(cellX, cellZ, PathNodeAdjacency(adjacency))];
+					if (distance == current)
+					{
+						break;
+					}
+
+					current = distance;
+					cellX -= dx;
+					cellZ -= dz;
+				}
+			}
+		}
+	}
+
+	// Get
+	JumpDistance Get(int x, int z, PathNodeAdjacency adjacency) const { return distances[GetIndex(x, z, adjacency)]; }
+
+	// Get distances (to write them to nav data files)
+	const JumpDistance* GetDistances() const { return distances.data(); }
+	size_t GetDistanceCount() const { return distances.size(); }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return distances.size() * sizeof(JumpDistance); }
+
+private:
+
+	// Build direction
+	void BuildDirection(const GridBitmap& walkable, PathNodeAdjacency adjacency)
+	{
+		int dx = GRID_ADJACENCY_OFFSET_X[(int)adjacency];
+		int dz = GRID_ADJACENCY_OFFSET_Z[(int)adjacency];
+
+		// cells further along the move first
+		for (int i = 0; i < height; i++)
+		{
+			int z = dz > 0 ? height - 1 - i : i;
+			for (int j = 0; j < width; j++)
+			{
+				int x = dx > 0 ? width - 1 - j : j;
+				distances[GetIndex(x, z, adjacency)] = ComputeDistance(walkable, x, z, adjacency);
+			}
+		}
+	}
+
+	// Update row
+	void UpdateRow(const GridBitmap& walkable, int z, PathNodeAdjacency adjacency)
+	{
+		int dx = GRID_ADJACENCY_OFFSET_X[(int)adjacency];
+		for (int j = 0; j < width; j++)
+		{
+			int x = dx > 0 ? width - 1 - j : j;
+			distances[GetIndex(x, z, adjacency)] = ComputeDistance(walkable, x, z, adjacency);
+		}
+	}
+
+	// Update column
+	void UpdateColumn(const GridBitmap& walkable, int x, PathNodeAdjacency adjacency)
+	{
+		int dz = GRID_ADJACENCY_OFFSET_Z[(int)adjacency];
+		for (int i = 0; i < height; i++)
+		{
+			int z = dz > 0 ? height - 1 - i : i;
+			distances[GetIndex(x, z, adjacency)] = ComputeDistance(walkable, x, z, adjacency);
+		}
+	}
+
+	// Compute distance (the distance of the next cell along the move must be up to date)
+	JumpDistance ComputeDistance(const GridBitmap& walkable, int x, int z, PathNodeAdjacency adjacency) const
+	{
+		int dx = GRID_ADJACENCY_OFFSET_X[(int)adjacency];
+		int dz = GRID_ADJACENCY_OFFSET_Z[(int)adjacency];
+		int nextX = x + dx;
+		int nextZ = z + dz;
+
+		switch (GetStop(walkable, nextX, nextZ, dx, dz))
+		{
+		case Stop::BLOCKED:
+			return -1;
+		case Stop::JUMP_POINT:
+			return 1;
+		default:
+		{
+			JumpDistance next = distances[GetIndex(nextX, nextZ, adjacency)];
+			return next > 0 ? next + 1 : next - 1;
+		}
+		}
+	}
+
+	// Get stop (reaching the cell x, z moving dx, dz)
+	Stop GetStop(const GridBitmap& walkable, int x, int z, int dx, int dz) const
+	{
+		if (!walkable.Get(x, z))
+		{
+			return Stop::BLOCKED;
+		}
+
+		if (dx != 0 && dz != 0)
+		{
+			// a diagonal move is blocked when both straight cells next to it are blocked
+			if (!walkable.Get(x - dx, z) && !walkable.Get(x, z - dz))
+			{
+				return Stop::BLOCKED;
+			}
+
+			// forced neighbours
+			if ((walkable.Get(x, z + dz) && walkable.Get(x - dx, z + dz) && !walkable.Get(x - dx, z))
+				|| (walkable.Get(x + dx, z) && walkable.Get(x + dx, z - dz) && !walkable.Get(x, z - dz)))
+			{
+				return Stop::JUMP_POINT;
+			}
+
+			// straight jump points
+			if (Get(x, z, dz > 0 ? PathNodeAdjacency::BOTTOM : PathNodeAdjacency::TOP) > 0
+				|| Get(x, z, dx > 0 ? PathNodeAdjacency::RIGHT : PathNodeAdjacency::LEFT) > 0)
+			{
+				return Stop::JUMP_POINT;
+			}
+		}
+		else
+		{
+			// forced neighbours (the next cell is walkable and so is a cell next to it whose neighbour on the side is blocked)
+			int sideX = dz;
+			int sideZ = dx;
+			if (walkable.Get(x + dx, z + dz)
+				&& ((walkable.Get(x + dx + sideX, z + dz + sideZ) && !walkable.Get(x + sideX, z + sideZ))
+				||  (walkable.Get(x + dx - sideX, z + dz - sideZ) && !walkable.Get(x - sideX, z - sideZ))))
+			{
+				return Stop::JUMP_POINT;
+			}
+		}
+
+		return Stop::NONE;
+	}
+
+	// Is inside
+	bool IsInside(int x, int z) const { return x >= 0 && x < width && z >= 0 && z < height; }
+
+	// Get index
+	size_t GetIndex(int x, int z, PathNodeAdjacency adjacency) const
+	{
+		assert(IsInside(x, z));
+		return (size_t(z) * width + x) * (int)PathNodeAdjacency::MAX_ADJACENCY + (int)adjacency;
+	}
+};
+
+#endif // !JUMP_DISTANCE_TABLE_H
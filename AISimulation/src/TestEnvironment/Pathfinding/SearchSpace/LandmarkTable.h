@@ -0,0 +1,238 @@
+#ifndef LANDMARK_TABLE_H
+#define LANDMARK_TABLE_H
+
+#include <queue>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include "SearchSpace.h"
+#include "NavDataArray.h"
+
+// distance of a node a landmark can not reach
+static const uint16_t LANDMARK_UNREACHABLE = UINT16_MAX;
+
+// Landmark table (ALT heuristic).
+// A few landmarks are picked far apart from each other (each one is the node furthest from the ones already picked,
+// within the area reachable from the first walkable node) and the shortest distance from every landmark to every node
+// is stored. By the triangle inequality |d(L, goal) - d(L, node)| never overestimates the distance from the node to
+// the goal, and the largest one over the landmarks is a much tighter bound than a geometric one around walls and dead ends.
+// Distances are quantised to uint16_t (units of the longest distance / 65534), one row of landmarks per node so
+// an estimate reads two contiguous rows. Moves are assumed to be symmetric (true on grids).
+class LandmarkTable
+{
+	// landmarks
+	std::vector<PathNodeId> landmarks;
+
+	// quantised distances (node * landmark count + landmark)
+	NavDataArray<uint16_t> distances;
+
+	// distance of one quantised unit
+	float unit{ 0.0f };
+
+public:
+
+	// Build (the search space must be built)
+	void Build(SearchSpace& searchSpace, size_t landmarkCount)
+	{
+		Clear();
+
+		size_t nodeCount = searchSpace.GetNodeCount();
+		if (landmarkCount == 0 || nodeCount == 0)
+		{
+			return;
+		}
+
+		// the first landmark is the node furthest from the first walkable node
+		PathNodeId seed = 0;
+		while (seed < nodeCount && !searchSpace.IsWalkable(seed))
+		{
+			seed++;
+		}
+
+		if (seed == nodeCount)
+		{
+			return;
+		}
+
+		std::vector<float> costs;
+		std::vector<float> nearestLandmarkCosts(nodeCount, std::numeric_limits<float>::infinity());
+		std::vector<std::vector<float>> landmarkCosts;
+
+		SearchCosts(searchSpace, seed, costs);
+		PathNodeId landmark = GetFurthestNode(costs);
+
+		while (landmark != INVALID_PATH_NODE_ID && landmarks.size() < landmarkCount)
+		{
+			landmarks.push_back(landmark);
+
+			SearchCosts(searchSpace, landmark, costs);
+			for (size_t node = 0; node < nodeCount; node++)
+			{
+				nearestLandmarkCosts[node] = std::min(nearestLandmarkCosts[node], costs[node]);
+			}
+
+			landmarkCosts.push_back(costs);
+
+			// next landmark, furthest from the ones picked
+			landmark = GetFurthestNode(nearestLandmarkCosts);
+		}
+
+		// quantise
+		float maxCost = 0.0f;
+		for (auto& landmarkCost : landmarkCosts)
+		{
+			for (float cost : landmarkCost)
+			{
+				if (cost != std::numeric_limits<float>::infinity())
+				{
+					maxCost = std::max(maxCost, cost);
+				}
+			}
+		}
+
+		unit = std::max(maxCost / float(LANDMARK_UNREACHABLE - 1), std::numeric_limits<float>::min());
+
+		size_t count = landmarks.size();
+		distances.assign(nodeCount * count, LANDMARK_UNREACHABLE);
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t node = 0; node < nodeCount; node++)
+			{
+				float cost = landmarkCosts[i][node];
+				if (cost != std::numeric_limits<float>::infinity())
+				{
+					distances[node * count + i] = uint16_t(std::min(cost / unit, float(LANDMARK_UNREACHABLE - 1)));
+				}
+			}
+		}
+	}
+
+	// Attach (distances of a mapped nav data file for nodeCount nodes, false if the count does not match)
+	bool Attach(const std::vector<PathNodeId>& mappedLandmarks, float mappedUnit, uint16_t* mappedDistances, size_t count, size_t nodeCount)
+	{
+		if (mappedLandmarks.empty() || count != nodeCount * mappedLandmarks.size())
+		{
+			return false;
+		}
+
+		landmarks = mappedLandmarks;
+		unit = mappedUnit;
+		distances.Attach(mappedDistances, count);
+		return true;
+	}
+
+	// Clear
+	void Clear()
+	{
+		landmarks.clear();
+		distances.clear();
+		unit = 0.0f;
+	}
+
+	// Is built
+	bool IsBuilt() const { return !landmarks.empty(); }
+
+	// Estimate (lower bound of the distance between the nodes, 0 if no landmark knows both of them)
+	float Estimate(PathNodeId node, PathNodeId goal) const
+	{
+		size_t count = landmarks.size();
+		const uint16_t* nodeDistances = &distances[size_t(node) * count];
+		const uint16_t* goalDistances = &distances[size_t(goal) * count];
+
+		int best = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (nodeDistances[i] != LANDMARK_UNREACHABLE && goalDistances[i] != LANDMARK_UNREACHABLE)
+			{
+				best = std::max(best, std::abs(int(nodeDistances[i]) - int(goalDistances[i])));
+			}
+		}
+
+		// both distances were rounded down, so the difference can be one unit too long
+		return best > 0 ? float(best - 1) * unit : 0.0f;
+	}
+
+	// Get landmarks
+	const std::vector<PathNodeId>& GetLandmarks() const { return landmarks; }
+
+	// Get distances (to write them to nav data files)
+	const uint16_t* GetDistances() const { return distances.data(); }
+	size_t GetDistanceCount() const { return distances.size(); }
+
+	// Get unit (distance of one quantised unit)
+	float GetUnit() const { return unit; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return landmarks.size() * sizeof(PathNodeId) + distances.size() * sizeof(uint16_t); }
+
+private:
+
+	// Search costs (Dijkstra from the node, infinity for the nodes it can not reach)
+	static void SearchCosts(SearchSpace& searchSpace, PathNodeId source, std::vector<float>& costs)
+	{
+		using Entry = std::pair<float, PathNodeId>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+		costs.assign(searchSpace.GetNodeCount(), std::numeric_limits<float>::infinity());
+		costs[source] = 0.0f;
+		open.push({ 0.0f, source });
+
+		while (!open.empty())
+		{
+			Entry entry = open.top();
+			open.pop();
+
+			PathNodeId current = entry.second;
+			if (entry.first > costs[current])
+			{
+				// already settled with a lower cost
+				continue;
+			}
+
+			MathGeom::Vector3 currentPosition = searchSpace.GetNodePosition(current);
+
+			PathNodeNeighbours neighbours;
+			size_t neighbourCount = searchSpace.GetValidNeighbours(current, neighbours);
+			for (size_t i = 0; i < neighbourCount; i++)
+			{
+				PathNodeId neighbour = neighbours[i];
+				float cost = entry.first + GetOctileDistance(currentPosition, searchSpace.GetNodePosition(neighbour));
+				if (cost < costs[neighbour])
+				{
+					costs[neighbour] = cost;
+					open.push({ cost, neighbour });
+				}
+			}
+		}
+	}
+
+	// Get furthest node (reachable node with the highest cost, INVALID_PATH_NODE_ID if none is above 0)
+	static PathNodeId GetFurthestNode(const std::vector<float>& costs)
+	{
+		PathNodeId furthest = INVALID_PATH_NODE_ID;
+		float furthestCost = 0.0f;
+		for (size_t node = 0; node < costs.size(); node++)
+		{
+			if (costs[node] > furthestCost && costs[node] != std::numeric_limits<float>::infinity())
+			{
+				furthest = PathNodeId(node);
+				furthestCost = costs[node];
+			}
+		}
+
+		return furthest;
+	}
+
+	// Get octile distance (edge cost of the planners between adjacent nodes)
+	static float GetOctileDistance(const MathGeom::Vector3& positionA, const MathGeom::Vector3& positionB)
+	{
+		float dx = fabsf(positionA.x - positionB.x);
+		float dz = fabsf(positionA.z - positionB.z);
+
+		return std::max(dx, dz) + 0.41421356f * std::min(dx, dz);
+	}
+};
+
+#endif // !LANDMARK_TABLE_H
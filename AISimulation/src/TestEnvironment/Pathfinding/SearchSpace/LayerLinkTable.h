@@ -0,0 +1,150 @@
+#ifndef LAYER_LINK_TABLE_H
+#define LAYER_LINK_TABLE_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "NodeBitset.h"
+
+// Layer link (move between nodes of two layers, e.g. stairs or a ladder)
+struct LayerLink
+{
+	PathNodeId from;
+	PathNodeId to;
+
+	MathGeom::Vector3 fromPosition;
+	MathGeom::Vector3 toPosition;
+};
+
+// Layer link table (links between the layers of a layered search space, both ways).
+// Links are few and nodes are many, so they are kept apart from the nodes: one bit per node tells whether it has
+// links, and the links of the linked nodes are found in an array sorted by node, so nodes without links only pay
+// for a bit test. Links leaving every layer are also kept by layer, for the layer heuristic.
+class LayerLinkTable
+{
+	// nodes per layer (node ids are layer-major)
+	size_t layerNodeCount{ 0 };
+
+	// nodes with links
+	NodeBitset linkedNodes;
+
+	// links of the linked nodes (node, linked node), sorted by node
+	std::vector<std::pair<PathNodeId, PathNodeId>> nodeLinks;
+
+	// links leaving every layer
+	std::vector<std::vector<LayerLink>> layerExits;
+
+public:
+
+	// Init (no links)
+	void Init(size_t layerCount, size_t nodesPerLayer)
+	{
+		layerNodeCount = nodesPerLayer;
+		linkedNodes.Init(layerCount * nodesPerLayer, false);
+		nodeLinks.clear();
+		layerExits.assign(layerCount, {});
+	}
+
+	// Add (both ways, between nodes of different layers; false if the nodes are already linked or one of them has
+	// MAX_PATH_NODE_LINKS links)
+	bool Add(const LayerLink& link)
+	{
+		assert(link.from < linkedNodes.Size() && link.to < linkedNodes.Size());
+		assert(GetLayer(link.from) != GetLayer(link.to));
+
+		if (IsLinked(link.from, link.to) || GetLinkCount(link.from) >= MAX_PATH_NODE_LINKS || GetLinkCount(link.to) >= MAX_PATH_NODE_LINKS)
+		{
+			return false;
+		}
+
+		Insert(link.from, link.to);
+		Insert(link.to, link.from);
+
+		layerExits[GetLayer(link.from)].push_back(link);
+		layerExits[GetLayer(link.to)].push_back({ link.to, link.from, link.toPosition, link.fromPosition });
+
+		return true;
+	}
+
+	// Is built (initialised with at least one layer)
+	bool IsBuilt() const { return !layerExits.empty(); }
+
+	// Get layer (of a node)
+	size_t GetLayer(PathNodeId node) const { return node / layerNodeCount; }
+
+	// Get layer count
+	size_t GetLayerCount() const { return layerExits.size(); }
+
+	// Has links
+	bool HasLinks(PathNodeId node) const { return linkedNodes.Get(node); }
+
+	// Get links (nodes linked to the node, returns how many were written, up to MAX_PATH_NODE_LINKS)
+	size_t GetLinks(PathNodeId node, PathNodeId* links) const
+	{
+		size_t count = 0;
+		if (linkedNodes.Get(node))
+		{
+			for (auto link = FindLinks(node); link != nodeLinks.end() && link->first == node; ++link)
+			{
+				links[count++] = link->second;
+			}
+		}
+
+		return count;
+	}
+
+	// Is linked
+	bool IsLinked(PathNodeId node, PathNodeId linkedNode) const
+	{
+		if (!linkedNodes.Get(node))
+		{
+			return false;
+		}
+
+		return std::binary_search(nodeLinks.begin(), nodeLinks.end(), std::make_pair(node, linkedNode));
+	}
+
+	// Get layer exits (links leaving the layer, from its nodes)
+	const std::vector<LayerLink>& GetLayerExits(size_t layer) const { return layerExits[layer]; }
+
+	// Get link count (links between layers, each counted once)
+	size_t GetLinkCount() const { return nodeLinks.size() / 2; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const
+	{
+		size_t memoryUsage = linkedNodes.GetMemoryUsage() + nodeLinks.size() * sizeof(std::pair<PathNodeId, PathNodeId>);
+		for (auto& exits : layerExits)
+		{
+			memoryUsage += exits.size() * sizeof(LayerLink);
+		}
+
+		return memoryUsage;
+	}
+
+private:
+
+	// Get link count (of a node)
+	size_t GetLinkCount(PathNodeId node) const
+	{
+		PathNodeId links[MAX_PATH_NODE_LINKS];
+		return GetLinks(node, links);
+	}
+
+	// Find links (first link of a node)
+	std::vector<std::pair<PathNodeId, PathNodeId>>::const_iterator FindLinks(PathNodeId node) const
+	{
+		return std::lower_bound(nodeLinks.begin(), nodeLinks.end(), std::make_pair(node, PathNodeId(0)));
+	}
+
+	// Insert (one way)
+	void Insert(PathNodeId node, PathNodeId linkedNode)
+	{
+		auto entry = std::make_pair(node, linkedNode);
+		nodeLinks.insert(std::upper_bound(nodeLinks.begin(), nodeLinks.end(), entry), entry);
+		linkedNodes.Set(node, true);
+	}
+};
+
+#endif // !LAYER_LINK_TABLE_H
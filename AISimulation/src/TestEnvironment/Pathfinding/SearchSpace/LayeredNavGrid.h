@@ -0,0 +1,469 @@
+#ifndef LAYERED_NAVGRID_H
+#define LAYERED_NAVGRID_H
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "SearchSpace.h"
+#include "GridMap.h"
+#include "NodeBitset.h"
+#include "ComponentTable.h"
+#include "LayerLinkTable.h"
+#include "CellCostTable.h"
+
+// height between the floors of layered grids
+static const float DEFAULT_GRID_LAYER_HEIGHT = 3.0f;
+
+// part of the height between floors below a floor that still belongs to its layer (agents on the lower end of
+// stairs or standing a bit below the floor), the rest of its height band is above it
+static const float GRID_LAYER_BAND_BELOW = 0.25f;
+
+// Grid layer link type
+enum class GridLayerLinkType
+{
+	STAIRS,
+	LADDER
+};
+
+// Grid layer link (cells of two layers joined both ways, the move costs the octile distance between the cells
+// and the height climbed)
+struct GridLayerLink
+{
+	int x;
+	int z;
+	int layer;
+
+	int toX;
+	int toZ;
+	int toLayer;
+
+	GridLayerLinkType type{ GridLayerLinkType::STAIRS };
+};
+
+// Layered grid map (floors of a building or a multi-level world, from the lowest one, all of the same size)
+struct LayeredGridMap
+{
+	// floors
+	std::vector<GridMap> layers;
+
+	// height between floors
+	float layerHeight{ DEFAULT_GRID_LAYER_HEIGHT };
+
+	// links between floors
+	std::vector<GridLayerLink> links;
+};
+
+// Layered grid (floors stacked in height, joined by stairs and ladders).
+// Every layer is a grid with the cells of its floor, one bit per cell, and node ids are layer-major
+// ((layer * totalCellsZ + z) * totalCellsX + x), so the nodes of a layer are contiguous and a layer of a flat world
+// costs what a compact grid does. Moves inside a layer follow the rules of grids, moves between layers go through
+// the links of the map, which are kept apart from the cells (see LayerLinkTable). Positions are localised by their
+// height band: a layer holds the heights from a bit below its floor up to a bit below the next one.
+class LayeredNavGrid : public SearchSpace
+{
+	// cell size
+	float cellSize{ 1.0f };
+
+	// total cells (per layer)
+	size_t totalCellsX{ 0 };
+	size_t totalCellsZ{ 0 };
+
+	// layers
+	size_t layerCount{ 0 };
+	size_t layerNodeCount{ 0 };
+	float layerHeight{ DEFAULT_GRID_LAYER_HEIGHT };
+
+	// walkable cells (layer-major)
+	NodeBitset walkable;
+
+	// links between layers
+	LayerLinkTable layerLinks;
+
+	// links of the map that were added (to render them)
+	std::vector<GridLayerLink> links;
+
+	// connected components of the walkable cells, across layers
+	ComponentTable components;
+
+	// cell costs (layer-major, like the cells)
+	CellCostTable cellCosts;
+
+public:
+
+	// Constructors
+	LayeredNavGrid() = default;
+	LayeredNavGrid(const SearchSpaceData& data)
+		: SearchSpace(data)
+		, cellSize(data.gridCellSize)
+	{
+	}
+
+	// Build (from the layered grid map, or one layer from the grid map or the test layout if it is not set)
+	void Build() override
+	{
+		auto& worldSize = searchSpaceData.worldSize;
+		auto& layeredGridMap = searchSpaceData.layeredGridMap;
+		auto& gridMap = searchSpaceData.gridMap;
+
+		if (layeredGridMap && !layeredGridMap->layers.empty())
+		{
+			totalCellsX = layeredGridMap->layers[0].width;
+			totalCellsZ = layeredGridMap->layers[0].height;
+			layerCount = layeredGridMap->layers.size();
+			layerHeight = layeredGridMap->layerHeight;
+		}
+		else if (gridMap)
+		{
+			totalCellsX = gridMap->width;
+			totalCellsZ = gridMap->height;
+			layerCount = 1;
+		}
+		else
+		{
+			totalCellsX = int(worldSize.x / cellSize);
+			totalCellsZ = int(worldSize.z / cellSize);
+			layerCount = 1;
+		}
+
+		assert(layerHeight > 0.0f);
+
+		worldSize.x = totalCellsX * cellSize;
+		worldSize.z = totalCellsZ * cellSize;
+		worldSize.y = layerCount * layerHeight;
+
+		// node ids of every layer must fit in a PathNodeId
+		layerNodeCount = totalCellsX * totalCellsZ;
+		assert(uint64_t(layerNodeCount) * layerCount < INVALID_PATH_NODE_ID);
+
+		// cells and their costs
+		walkable.Init(GetNodeCount(), false);
+		cellCosts.Clear();
+		for (size_t layer = 0; layer < layerCount; layer++)
+		{
+			const GridMap* layerMap = layeredGridMap && !layeredGridMap->layers.empty() ? &layeredGridMap->layers[layer] : gridMap.get();
+			assert(!layerMap || (layerMap->width == totalCellsX && layerMap->height == totalCellsZ));
+
+			for (int z = 0; z < int(totalCellsZ); z++)
+			{
+				for (int x = 0; x < int(totalCellsX); x++)
+				{
+					if (layerMap ? layerMap->IsWalkable(x, z) : IsTestLayoutWalkable(x, z))
+					{
+						walkable.Set(GetNodeId(x, z, int(layer)), true);
+					}
+
+					if (layerMap && !layerMap->costs.empty())
+					{
+						cellCosts.SetCost(GetNodeId(x, z, int(layer)), layerMap->GetCost(x, z), GetNodeCount());
+					}
+				}
+			}
+		}
+
+		// links (links outside the grid, inside one layer or past the links a node can have are left out)
+		layerLinks.Init(layerCount, layerNodeCount);
+		links.clear();
+		if (layeredGridMap)
+		{
+			for (auto& link : layeredGridMap->links)
+			{
+				PathNodeId from = GetNodeId(link.x, link.z, link.layer);
+				PathNodeId to = GetNodeId(link.toX, link.toZ, link.toLayer);
+				bool added = from != INVALID_PATH_NODE_ID && to != INVALID_PATH_NODE_ID && link.layer != link.toLayer
+					&& layerLinks.Add({ from, to, GetNodePosition(from), GetNodePosition(to) });
+
+				assert(added);
+				if (added)
+				{
+					links.push_back(link);
+				}
+			}
+		}
+
+		components.Build(*this);
+
+		version++;
+	}
+
+	// Set node walkable (not to be called while a search is running)
+	bool SetNodeWalkable(PathNodeId node, bool isWalkable) override
+	{
+		assert(node < GetNodeCount());
+
+		if (walkable.Get(node) != isWalkable)
+		{
+			walkable.Set(node, isWalkable);
+			components.Update(*this, node);
+
+			version++;
+		}
+
+		return true;
+	}
+
+	// Set node costs (see SearchSpace::SetNodeCosts, nothing else depends on the costs)
+	bool SetNodeCosts(const std::vector<PathNodeId>& nodes, uint8_t cost) override
+	{
+		bool changed = false;
+		for (PathNodeId node : nodes)
+		{
+			assert(node < GetNodeCount());
+			changed |= cellCosts.SetCost(node, cost, GetNodeCount());
+		}
+
+		if (changed)
+		{
+			version++;
+		}
+
+		return true;
+	}
+
+	// Get cell costs
+	const CellCostTable* GetCellCosts() const override { return &cellCosts; }
+
+	// Localise (the layer is found from the height band of the position)
+	PathNodeId Localise(const MathGeom::Vector3& position) override
+	{
+		MathGeom::Vector3 anchorToPos = position - searchSpaceData.anchorPosition;
+		if (	anchorToPos.x >= 0 && anchorToPos.x <= searchSpaceData.worldSize.x
+			&&	anchorToPos.z >= 0 && anchorToPos.z <= searchSpaceData.worldSize.z)
+		{
+			int layer = int(floorf(anchorToPos.y / layerHeight + GRID_LAYER_BAND_BELOW));
+
+			anchorToPos /= cellSize;
+			return GetNodeId(int(anchorToPos.x), int(anchorToPos.z), layer);
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get node count (cells of every layer)
+	size_t GetNodeCount() const override { return layerNodeCount * layerCount; }
+
+	// Get node position (on the floor of its layer)
+	MathGeom::Vector3 GetNodePosition(PathNodeId node) const override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		auto& anchorPos = searchSpaceData.anchorPosition;
+		float halfCellSize = cellSize * 0.5f;
+
+		return MathGeom::Vector3(
+			anchorPos.x + GetCellX(node) * cellSize + halfCellSize,
+			anchorPos.y + GetLayer(node) * layerHeight,
+			anchorPos.z + GetCellZ(node) * cellSize + halfCellSize);
+	}
+
+	// Is walkable
+	bool IsWalkable(PathNodeId node) const override final
+	{
+		return node != INVALID_PATH_NODE_ID && walkable.Get(node);
+	}
+
+	// Is reachable (from the components, linked parts of a component split by a blocked cell may keep one label)
+	bool IsReachable(PathNodeId from, PathNodeId to) const override
+	{
+		return components.AreConnected(from, to);
+	}
+
+	// Get neighbour (in the layer of the node)
+	PathNodeId GetNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		return GetNodeId(
+			int(GetCellX(node)) + GRID_ADJACENCY_OFFSET_X[(int)adjacency],
+			int(GetCellZ(node)) + GRID_ADJACENCY_OFFSET_Z[(int)adjacency],
+			int(GetLayer(node)));
+	}
+
+	// Is valid adjacency (cells around the node in its layer, or the cells it is linked to)
+	bool IsValidAdjacency(PathNodeId node, PathNodeId neighbour) override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		if (!IsWalkable(neighbour))
+			return false;
+
+		int layer = int(GetLayer(node));
+		if (int(GetLayer(neighbour)) != layer)
+			return layerLinks.IsLinked(node, neighbour);
+
+		int x = int(GetCellX(node));
+		int z = int(GetCellZ(node));
+		int dx = int(GetCellX(neighbour)) - x;
+		int dz = int(GetCellZ(neighbour)) - z;
+
+		assert(dx >= -1 && dx <= 1 && dz >= -1 && dz <= 1);
+
+		// a diagonal move is only blocked when both straight cells next to it are blocked
+		if (dx != 0 && dz != 0)
+		{
+			if (!IsCellWalkable(x, z + dz, layer) && !IsCellWalkable(x + dx, z, layer))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Get validated PathNode
+	PathNodeId GetValidatedPathNode(PathNodeId nodeA, PathNodeId nodeB) override
+	{
+		int layer = int(GetLayer(nodeA));
+		if (int(GetLayer(nodeB)) != layer)
+		{
+			return nodeB;
+		}
+
+		int x = int(GetCellX(nodeA));
+		int z = int(GetCellZ(nodeA));
+		int dx = int(GetCellX(nodeB)) - x;
+		int dz = int(GetCellZ(nodeB)) - z;
+
+		// a diagonal move cutting a blocked corner goes through the walkable straight cell instead
+		if ((dx == 1 || dx == -1) && (dz == 1 || dz == -1))
+		{
+			if (!IsCellWalkable(x, z + dz, layer))
+			{
+				return GetNodeId(x + dx, z, layer);
+			}
+
+			if (!IsCellWalkable(x + dx, z, layer))
+			{
+				return GetNodeId(x, z + dz, layer);
+			}
+		}
+
+		return nodeB;
+	}
+
+	// Get valid neighbours (cells around the node in its layer, then the walkable cells it is linked to)
+	size_t GetValidNeighbours(PathNodeId node, PathNodeNeighbours& neighbours) override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		int x = int(GetCellX(node));
+		int z = int(GetCellZ(node));
+		int layer = int(GetLayer(node));
+
+		std::array<bool, (int)PathNodeAdjacency::MAX_ADJACENCY> isWalkable;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			isWalkable[adjacency] = IsCellWalkable(x + GRID_ADJACENCY_OFFSET_X[adjacency], z + GRID_ADJACENCY_OFFSET_Z[adjacency], layer);
+		}
+
+		size_t count = 0;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			if (!isWalkable[adjacency])
+			{
+				continue;
+			}
+
+			// PathNodeAdjacency alternates diagonal and straight directions, starting with TOP_LEFT
+			if ((adjacency & 1) == 0)
+			{
+				// diagonal: a diagonal move is only blocked when both straight cells next to it are blocked
+				int previous = (adjacency + 7) % (int)PathNodeAdjacency::MAX_ADJACENCY;
+				int next = adjacency + 1;
+				if (!isWalkable[previous] && !isWalkable[next])
+				{
+					continue;
+				}
+			}
+
+			// cells outside the grid are not walkable, so the neighbour is inside
+			neighbours[count++] = PathNodeId(node + GRID_ADJACENCY_OFFSET_Z[adjacency] * int(totalCellsX) + GRID_ADJACENCY_OFFSET_X[adjacency]);
+		}
+
+		if (layerLinks.HasLinks(node))
+		{
+			PathNodeId links[MAX_PATH_NODE_LINKS];
+			size_t linkCount = layerLinks.GetLinks(node, links);
+			for (size_t i = 0; i < linkCount; i++)
+			{
+				if (walkable.Get(links[i]))
+				{
+					neighbours[count++] = links[i];
+				}
+			}
+		}
+
+		return count;
+	}
+
+	// Is cell walkable (false outside the grid)
+	bool IsCellWalkable(int x, int z, int layer) const
+	{
+		PathNodeId node = GetNodeId(x, z, layer);
+		return node != INVALID_PATH_NODE_ID && walkable.Get(node);
+	}
+
+	// Get node id (INVALID_PATH_NODE_ID outside the grid)
+	PathNodeId GetNodeId(int x, int z, int layer) const
+	{
+		if (x >= 0 && x < int(totalCellsX) && z >= 0 && z < int(totalCellsZ) && layer >= 0 && layer < int(layerCount))
+		{
+			return PathNodeId((layer * totalCellsZ + z) * totalCellsX + x);
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get cell coordinates
+	size_t GetCellX(PathNodeId node) const { return node % totalCellsX; }
+	size_t GetCellZ(PathNodeId node) const { return (node % layerNodeCount) / totalCellsX; }
+	size_t GetLayer(PathNodeId node) const { return node / layerNodeCount; }
+
+	// Get total cells (per layer)
+	size_t GetTotalCellsX() const { return totalCellsX; }
+	size_t GetTotalCellsZ() const { return totalCellsZ; }
+
+	// Get layers
+	size_t GetLayerCount() const { return layerCount; }
+	float GetLayerHeight() const { return layerHeight; }
+
+	// Get layer links
+	const LayerLinkTable& GetLayerLinks() const { return layerLinks; }
+
+	// Get components
+	const ComponentTable& GetComponents() const { return components; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const
+	{
+		return walkable.GetMemoryUsage() + layerLinks.GetMemoryUsage() + links.size() * sizeof(GridLayerLink) + components.GetMemoryUsage()
+			+ cellCosts.GetMemoryUsage();
+	}
+
+	// Debug render (cells, then both ends of the links between layers)
+	void DebugRender(const MathGeom::Matrix4& viewProjection) override
+	{
+		SearchSpace::DebugRender(viewProjection);
+
+		for (auto& link : links)
+		{
+			unsigned color = link.type == GridLayerLinkType::LADDER ? 0xFF8000 : 0xFFFF00;
+
+			Transform transform;
+			transform.position = GetNodePosition(GetNodeId(link.x, link.z, link.layer));
+			RenderUtils::RenderCube(viewProjection, transform, color);
+
+			transform.position = GetNodePosition(GetNodeId(link.toX, link.toZ, link.toLayer));
+			RenderUtils::RenderCube(viewProjection, transform, color);
+		}
+	}
+
+private:
+
+	// Is test layout walkable (2x2 blocks every 3 cells, as the test layout of grids without its random cells)
+	static bool IsTestLayoutWalkable(int x, int z)
+	{
+		return x % 3 == 0 || z % 3 == 0;
+	}
+};
+
+#endif // !LAYERED_NAVGRID_H
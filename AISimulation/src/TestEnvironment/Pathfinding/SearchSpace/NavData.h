@@ -0,0 +1,349 @@
+#ifndef NAV_DATA_H
+#define NAV_DATA_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// nav data file identifier ("NAVD")
+static const uint32_t NAV_DATA_MAGIC = 0x4456414E;
+
+// nav data format version (files of another version are not loaded, grids are built from their map instead)
+static const uint32_t NAV_DATA_VERSION = 2;
+
+// written as is, so files written with the other byte order do not match it
+static const uint32_t NAV_DATA_BYTE_ORDER = 0x01020304;
+
+// alignment of the sections in the file (and so in memory, mappings start at a page)
+static const size_t NAV_DATA_ALIGNMENT = 64;
+
+// Nav data section type
+enum class NavDataSectionType : uint32_t
+{
+	WALKABLE_NODES,			// uint64_t words, one bit per node (NodeBitset layout)
+	WALKABLE_ROWS,			// uint64_t words (GridBitmap layout, padding included)
+	WALKABLE_COLUMNS,		// uint64_t words (GridBitmap layout, padding included)
+	JUMP_DISTANCES,			// JumpDistance per cell and PathNodeAdjacency (optional)
+	LANDMARKS,				// PathNodeId per landmark (optional)
+	LANDMARK_DISTANCES,		// uint16_t per node and landmark (optional)
+	COMPONENTS,				// uint32_t per node
+	COMPONENT_SIZES,		// uint64_t per component label
+	CELL_COSTS,				// uint8_t per node (optional, CellCostTable layout)
+
+	MAX_SECTION_TYPE
+};
+
+// Nav data section (bytes from the start of the file, size 0 if the section is not in the file)
+struct NavDataSection
+{
+	uint64_t offset;
+	uint64_t size;
+};
+
+// Nav data header
+struct NavDataHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t headerSize;
+
+	// file size and checksum of everything after the header
+	uint64_t fileSize;
+	uint64_t checksum;
+
+	// grid
+	uint32_t totalCellsX;
+	uint32_t totalCellsZ;
+	float cellSize;
+	float anchorPosition[3];
+
+	// distance of one quantised landmark unit
+	float landmarkUnit;
+	uint32_t reserved;
+
+	// sections
+	NavDataSection sections[(int)NavDataSectionType::MAX_SECTION_TYPE];
+};
+
+static_assert(sizeof(NavDataHeader) % sizeof(uint64_t) == 0, "sections must be 8-byte aligned after the header");
+
+// Nav data.
+// Prebuilt tables of a grid (walkable cells, walkable bitmaps, jump distances, landmarks and components) baked
+// offline in a single file. The file is mapped and the tables are used in place, so nothing is parsed or copied
+// at startup and processes mapping the same file share its pages until they write to them (copy-on-write, cell
+// changes never reach the file).
+class NavData
+{
+	// mapping
+	uint8_t* bytes{ nullptr };
+	size_t size{ 0 };
+
+#ifdef _WIN32
+	HANDLE file{ INVALID_HANDLE_VALUE };
+	HANDLE mapping{ nullptr };
+#endif
+
+public:
+
+	// Constructors
+	NavData() = default;
+	NavData(const NavData&) = delete;
+	NavData& operator=(const NavData&) = delete;
+
+	// Destructor
+	~NavData()
+	{
+		Close();
+	}
+
+	// Load (maps the file, false if it can not be mapped or it is not a valid nav data file of this version)
+	bool Load(const std::string& fileName, bool verifyChecksum)
+	{
+		Close();
+
+		if (!Map(fileName))
+		{
+			return false;
+		}
+
+		if (!Validate(verifyChecksum))
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Is loaded
+	bool IsLoaded() const { return bytes != nullptr; }
+
+	// Get header
+	const NavDataHeader& GetHeader() const { return *reinterpret_cast<const NavDataHeader*>(bytes); }
+
+	// Get section (elements of type T in place, nullptr and a count of 0 if the section is not in the file)
+	template<typename T>
+	T* GetSection(NavDataSectionType type, size_t& count)
+	{
+		const NavDataSection& section = GetHeader().sections[(int)type];
+		count = size_t(section.size / sizeof(T));
+		return count > 0 ? reinterpret_cast<T*>(bytes + section.offset) : nullptr;
+	}
+
+	// Get size (bytes)
+	size_t GetSize() const { return size; }
+
+	// Get body offset (first byte after the header, where the sections start)
+	static size_t GetBodyOffset() { return Align(sizeof(NavDataHeader)); }
+
+	// Align (to NAV_DATA_ALIGNMENT)
+	static size_t Align(size_t offset) { return (offset + NAV_DATA_ALIGNMENT - 1) / NAV_DATA_ALIGNMENT * NAV_DATA_ALIGNMENT; }
+
+	// Compute checksum (FNV-1a over 64-bit words, size must be a multiple of 8)
+	static uint64_t ComputeChecksum(const uint8_t* data, size_t byteCount)
+	{
+		uint64_t checksum = 0xCBF29CE484222325ULL;
+		for (size_t offset = 0; offset < byteCount; offset += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, data + offset, sizeof(uint64_t));
+			checksum = (checksum ^ word) * 0x100000001B3ULL;
+		}
+
+		return checksum;
+	}
+
+private:
+
+	// Validate (header, sections inside the file and checksum)
+	bool Validate(bool verifyChecksum) const
+	{
+		if (size < GetBodyOffset())
+		{
+			return false;
+		}
+
+		const NavDataHeader& header = GetHeader();
+		if (header.magic != NAV_DATA_MAGIC || header.version != NAV_DATA_VERSION || header.byteOrder != NAV_DATA_BYTE_ORDER
+			|| header.headerSize != sizeof(NavDataHeader) || header.fileSize != size || size % sizeof(uint64_t) != 0)
+		{
+			return false;
+		}
+
+		for (const NavDataSection& section : header.sections)
+		{
+			if (section.size > 0 && (section.offset < GetBodyOffset() || section.offset % NAV_DATA_ALIGNMENT != 0
+				|| section.offset > size || section.size > size - section.offset))
+			{
+				return false;
+			}
+		}
+
+		return !verifyChecksum || header.checksum == ComputeChecksum(bytes + GetBodyOffset(), size - GetBodyOffset());
+	}
+
+	// Map (copy-on-write)
+	bool Map(const std::string& fileName)
+	{
+#ifdef _WIN32
+		file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		bytes = mapping ? static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+		if (!bytes)
+		{
+			Close();
+			return false;
+		}
+
+		size = size_t(fileSize.QuadPart);
+#else
+		int file = open(fileName.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		// the mapping keeps the file open
+		void* mapped = mmap(nullptr, size_t(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		close(file);
+
+		if (mapped == MAP_FAILED)
+		{
+			return false;
+		}
+
+		bytes = static_cast<uint8_t*>(mapped);
+		size = size_t(fileStat.st_size);
+#endif
+		return true;
+	}
+
+	// Close
+	void Close()
+	{
+#ifdef _WIN32
+		if (bytes)
+		{
+			UnmapViewOfFile(bytes);
+		}
+
+		if (mapping)
+		{
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (bytes)
+		{
+			munmap(bytes, size);
+		}
+#endif
+		bytes = nullptr;
+		size = 0;
+	}
+};
+
+// Nav data writer (header and sections, to be written by offline tools)
+class NavDataWriter
+{
+	// header
+	NavDataHeader header;
+
+	// sections (from the body offset)
+	std::vector<uint8_t> body;
+
+public:
+
+	// Constructor
+	NavDataWriter()
+	{
+		memset(&header, 0, sizeof(NavDataHeader));
+		header.magic = NAV_DATA_MAGIC;
+		header.version = NAV_DATA_VERSION;
+		header.byteOrder = NAV_DATA_BYTE_ORDER;
+		header.headerSize = sizeof(NavDataHeader);
+	}
+
+	// Get header (grid fields are set by the caller)
+	NavDataHeader& GetHeader() { return header; }
+
+	// Add section
+	void AddSection(NavDataSectionType type, const void* data, size_t byteCount)
+	{
+		size_t offset = NavData::Align(body.size());
+		body.resize(NavData::Align(offset + byteCount), 0);
+		if (byteCount > 0)
+		{
+			memcpy(body.data() + offset, data, byteCount);
+		}
+
+		header.sections[(int)type] = { uint64_t(NavData::GetBodyOffset() + offset), uint64_t(byteCount) };
+	}
+
+	// Write
+	bool Write(const std::string& fileName)
+	{
+		header.fileSize = NavData::GetBodyOffset() + body.size();
+		header.checksum = NavData::ComputeChecksum(body.data(), body.size());
+
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> headerBytes(NavData::GetBodyOffset(), 0);
+		memcpy(headerBytes.data(), &header, sizeof(NavDataHeader));
+
+		file.write(reinterpret_cast<const char*>(headerBytes.data()), std::streamsize(headerBytes.size()));
+		file.write(reinterpret_cast<const char*>(body.data()), std::streamsize(body.size()));
+		file.close();
+
+		return !file.fail();
+	}
+};
+
+#endif // !NAV_DATA_H
@@ -0,0 +1,79 @@
+#ifndef NAV_DATA_ARRAY_H
+#define NAV_DATA_ARRAY_H
+
+#include <vector>
+#include <cassert>
+
+// Array of a table of a search space.
+// Elements are either owned (built at runtime) or used in place from a mapped nav data file (see NavData), which keeps
+// them alive. Mapped files are copy-on-write, so tables can still be updated as cells change.
+template<typename T>
+class NavDataArray
+{
+	// owned elements
+	std::vector<T> owned;
+
+	// elements (owned or mapped)
+	T* elements{ nullptr };
+	size_t count{ 0 };
+
+public:
+
+	// Constructors (copies own their elements)
+	NavDataArray() = default;
+	NavDataArray(const NavDataArray& other) { *this = other; }
+	NavDataArray& operator=(const NavDataArray& other)
+	{
+		if (this != &other)
+		{
+			owned.assign(other.elements, other.elements + other.count);
+			elements = owned.data();
+			count = other.count;
+		}
+
+		return *this;
+	}
+
+	// Assign (owned elements)
+	void assign(size_t size, const T& value)
+	{
+		owned.assign(size, value);
+		elements = owned.data();
+		count = size;
+	}
+
+	// Attach (elements of a mapped file, not owned)
+	void Attach(T* mapped, size_t size)
+	{
+		owned.clear();
+		owned.shrink_to_fit();
+		elements = mapped;
+		count = size;
+	}
+
+	// Clear
+	void clear()
+	{
+		owned.clear();
+		elements = nullptr;
+		count = 0;
+	}
+
+	// Is mapped
+	bool IsMapped() const { return count > 0 && elements != owned.data(); }
+
+	// Access
+	T& operator[](size_t index) { assert(index < count); return elements[index]; }
+	const T& operator[](size_t index) const { assert(index < count); return elements[index]; }
+	T& back() { assert(count > 0); return elements[count - 1]; }
+
+	// Data
+	T* data() { return elements; }
+	const T* data() const { return elements; }
+
+	// Size
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+};
+
+#endif // !NAV_DATA_ARRAY_H
@@ -1,251 +1,67 @@
 #ifndef NAVGRID_H
 #define NAVGRID_H
 
-#include "SearchSpace.h"
+#include "GridSearchSpace.h"
 
-class NavGrid : public SearchSpace
+// Grid that keeps an explicit PathNode (position, type and neighbours) per cell
+class NavGrid final : public GridSearchSpace
 {
-	// cell size
-	float cellSize { 1.0f };
-
-	// total cells
-	size_t totalCellsX { 0 };
-	size_t totalCellsY { 0 };
-	size_t totalCellsZ { 0 };
+	// nodes
+	std::vector<PathNode> nodes;
 
 public:
 	
 	// Constructors
 	NavGrid() = default;
 	NavGrid(const SearchSpaceData& data)
-		: SearchSpace(data)
-		, cellSize(data.gridCellSize)
+		: GridSearchSpace(data)
 	{ 
 	}
 
-	// Build
-	void Build() override
-	{
-		// Create grid
-		CreateGrid();
-
-		// Note: To be removed when create the grid from static world
-		CreateTestLayout();
+	// Get node position
+	MathGeom::Vector3 GetNodePosition(PathNodeId node) const override { return nodes[node].position; }
 
-		// Compute adjacency
-		ComputeAdjacency();
-	}
+	// Is walkable
+	bool IsWalkable(PathNodeId node) const override final { return node != INVALID_PATH_NODE_ID && nodes[node].type != PathNodeType::BLOCKED; }
 
-	// Localise
-	PathNode* Localise(const MathGeom::Vector3& position) override
+	// Get neighbour
+	PathNodeId GetNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const override
 	{
-		MathGeom::Vector3 anchorToPos = position - searchSpaceData.anchorPosition;
-		if (	anchorToPos.x >= 0 && anchorToPos.x <= searchSpaceData.worldSize.x 
-			&&	anchorToPos.z >= 0 && anchorToPos.z <= searchSpaceData.worldSize.z)
-		{
-			anchorToPos /= cellSize;
-			return GetNode(int(anchorToPos.x), int(anchorToPos.z));
-		}
-
-		return nullptr;
+		const PathNode* neighbour = nodes[node].neighbours[(int)adjacency];
+		return neighbour ? PathNodeId(neighbour - nodes.data()) : INVALID_PATH_NODE_ID;
 	}
 
-	// Is valid adjacency
-	bool IsValidAdjacency(PathNode* node, PathNode* neighbour) override
-	{
-		assert(node);
-		
-		if (!IsWalkable(neighbour))
-			return false;
-
-		assert(IsAdjacent(node, neighbour));
+	// Get valid neighbours
+	size_t GetValidNeighbours(PathNodeId node, PathNodeNeighbours& neighbours) override { return GetValidCellNeighbours(*this, node, neighbours); }
 
-		if (neighbour == node->neighbours[(int)PathNodeAdjacency::TOP_LEFT])
-		{
-			if (!IsWalkable(node->neighbours[(int)PathNodeAdjacency::TOP])
-				&& !IsWalkable(node->neighbours[(int)PathNodeAdjacency::LEFT]))
-				return false;
-		}
+protected:
 
-		if (neighbour == node->neighbours[(int)PathNodeAdjacency::TOP_RIGHT])
-		{
-			if (!IsWalkable(node->neighbours[(int)PathNodeAdjacency::TOP])
-				&& !IsWalkable(node->neighbours[(int)PathNodeAdjacency::RIGHT]))
-				return false;
-		}
-
-		if (neighbour == node->neighbours[(int)PathNodeAdjacency::BOTTOM_RIGHT])
-		{
-			if (!IsWalkable(node->neighbours[(int)PathNodeAdjacency::BOTTOM])
-				&& !IsWalkable(node->neighbours[(int)PathNodeAdjacency::RIGHT]))
-				return false;
-		}
-
-		if (neighbour == node->neighbours[(int)PathNodeAdjacency::BOTTOM_LEFT])
-		{
-			if (!IsWalkable(node->neighbours[(int)PathNodeAdjacency::BOTTOM])
-				&& !IsWalkable(node->neighbours[(int)PathNodeAdjacency::LEFT]))
-				return false;
-		}
-
-		return true;
-	}
-
-	// Get validated PathNode
-	PathNode* GetValidatedPathNode(PathNode* nodeA, PathNode* nodeB) override
-	{
-		if (nodeB == nodeA->neighbours[(int)PathNodeAdjacency::TOP_LEFT])
-		{
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::TOP]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::LEFT]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::LEFT];
-			}
-
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::LEFT]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::TOP]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::TOP];
-			}
-		}
-
-		if (nodeB == nodeA->neighbours[(int)PathNodeAdjacency::TOP_RIGHT])
-		{
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::TOP]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::RIGHT]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::RIGHT];
-			}
-
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::RIGHT]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::TOP]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::TOP];
-			}
-		}
-
-		if (nodeB == nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM_RIGHT])
-		{
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::RIGHT]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::RIGHT];
-			}
-
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::RIGHT]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM];
-			}
-		}
-
-		if (nodeB == nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM_LEFT])
-		{
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::LEFT]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::LEFT];
-			}
-
-			if (!IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::LEFT]))
-			{
-				assert(IsWalkable(nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM]));
-				return nodeA->neighbours[(int)PathNodeAdjacency::BOTTOM];
-			}
-		}
-
-		return nodeB;
-	}
-
-private:
-
-	// Create Grid
-	void CreateGrid()
+	// Create cells
+	void CreateCells() override
 	{
 		// clear current nodes
 		nodes.clear();
 
-		// calculate total cells
-		auto& anchorPos = searchSpaceData.anchorPosition;
-		auto& worldSize = searchSpaceData.worldSize;
-
-		totalCellsX = int(worldSize.x / cellSize);
-		totalCellsY = 1;
-		totalCellsZ = int(worldSize.z / cellSize);
-		size_t totalCells = totalCellsX * totalCellsY * totalCellsZ;
-
 		// create the nodes
-		nodes.reserve(totalCells);
+		nodes.reserve(GetNodeCount());
 
-		float halfCellSize = cellSize * 0.5f;
-		MathGeom::Vector3 nodePos;
 		for (size_t cellZ = 0; cellZ < totalCellsZ; cellZ++)
 		{
-			nodePos.z = anchorPos.z + cellZ * cellSize + halfCellSize;
-
 			for (size_t cellX = 0; cellX < totalCellsX; cellX++)
 			{
-				nodePos.x = anchorPos.x + cellX * cellSize + halfCellSize;
-				nodes.emplace_back(PathNode(nodePos));
+				nodes.emplace_back(PathNode(GetCellPosition(cellX, cellZ)));
 			}
 		}
 	}
 
-	// Create test layout
-	void CreateTestLayout()
+	// Set walkable
+	void SetWalkable(PathNodeId node, bool walkable) override
 	{
-		for (size_t x = 1; x < totalCellsX; x += 3)
-		{
-			for (size_t z = 1; z < totalCellsZ; z += 3)
-			{
-				// 2x2 block
-				size_t startX = x;
-				size_t startZ = z;
-				for (size_t blockX = startX; blockX < startX + 2; blockX++)
-				{
-					for (size_t blockZ = startZ; blockZ < startZ + 2; blockZ++)
-					{
-						PathNode* node = GetNode(blockX, blockZ);
-						if (!node)
-						{
-							// early exit
-							break;
-						}
-
-						node->type = PathNodeType::BLOCKED;
-					}
-				}
-			}
-		}
-
-		std::srand((unsigned)std::chrono::system_clock::now().time_since_epoch().count());
-		int count = 3;
-		while (count > 0)
-		{
-			int n = std::rand() % nodes.size();
-			if (nodes[n].type == PathNodeType::UNBLOCKED)
-			{
-				printf("Navgrid random blocked cell index: %d\n", n);
-				nodes[n].type = PathNodeType::BLOCKED;
-				count--;
-			}
-		}
-	}
-
-	// Get node
-	PathNode* GetNode(int x, int z)
-	{
-		if (x >= 0 && x < int(totalCellsX) && z >= 0 && z < int(totalCellsZ))
-		{
-			size_t nodeIndex = z * totalCellsX + x;
-			return &nodes[nodeIndex];
-		}
-
-		return nullptr;
+		nodes[node].type = walkable ? PathNodeType::UNBLOCKED : PathNodeType::BLOCKED;
 	}
 
 	// Compute adjacency
-	void ComputeAdjacency()
+	void ComputeAdjacency() override
 	{
 		for (size_t i = 0; i < nodes.size(); i++)
 		{
@@ -265,6 +81,15 @@ private:
 		}
 	}
 
+private:
+
+	// Get node
+	PathNode* GetNode(int x, int z)
+	{
+		PathNodeId node = GetNodeId(x, z);
+		return node != INVALID_PATH_NODE_ID ? &nodes[node] : nullptr;
+	}
+
 	// Set Adjacency
 	void SetAdjacency(PathNode& nodeA, PathNode* nodeB, PathNodeAdjacency adjacency)
 	{
@@ -326,23 +151,6 @@ private:
 			break;
 		}
 	}
-
-	// Is walkable
-	bool IsWalkable(PathNode* node) { return node && node->type != PathNodeType::BLOCKED; }
-
-	// Is adjacent
-	bool IsAdjacent(PathNode* node, PathNode* neighbour)
-	{
-		for (auto n : node->neighbours)
-		{
-			if (n == neighbour)
-			{
-				return true;
-			}
-		}
-
-		return false;
-	}
 };
 
 #endif // !NAVGRID_H
@@ -0,0 +1,80 @@
+#ifndef NODE_BITSET_H
+#define NODE_BITSET_H
+
+#include <vector>
+#include <cstdint>
+
+#include "NavDataArray.h"
+#include "../PathNode.h"
+
+// Packed bitset with one bit per PathNodeId
+class NodeBitset
+{
+	// bit count
+	size_t size{ 0 };
+
+	// words
+	NavDataArray<uint64_t> words;
+
+public:
+
+	// Init
+	void Init(size_t count, bool value)
+	{
+		size = count;
+		words.assign((count + 63) / 64, value ? ~uint64_t(0) : uint64_t(0));
+
+		// keep the bits past the end cleared
+		if (value && (count % 64) != 0)
+		{
+			words.back() = (uint64_t(1) << (count % 64)) - 1;
+		}
+	}
+
+	// Attach (words of a mapped nav data file, laid out as Init does for the count; false if the word count does not match)
+	bool Attach(size_t count, uint64_t* mappedWords, size_t wordCount)
+	{
+		if (wordCount != (count + 63) / 64)
+		{
+			return false;
+		}
+
+		size = count;
+		words.Attach(mappedWords, wordCount);
+		return true;
+	}
+
+	// Get words (to write them to nav data files)
+	const uint64_t* GetWords() const { return words.data(); }
+	size_t GetWordCount() const { return words.size(); }
+
+	// Size
+	size_t Size() const { return size; }
+
+	// Get
+	bool Get(PathNodeId node) const
+	{
+		assert(node < size);
+		return (words[node >> 6] >> (node & 63)) & 1;
+	}
+
+	// Set
+	void Set(PathNodeId node, bool value)
+	{
+		assert(node < size);
+		uint64_t mask = uint64_t(1) << (node & 63);
+		if (value)
+		{
+			words[node >> 6] |= mask;
+		}
+		else
+		{
+			words[node >> 6] &= ~mask;
+		}
+	}
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const { return words.size() * sizeof(uint64_t); }
+};
+
+#endif // !NODE_BITSET_H
@@ -2,11 +2,34 @@
 #define SEARCH_SPACE_H
 
 #include <vector>
+#include <memory>
+#include <string>
 
-#include "../../Render/RenderUtils.h"
+#include "../PathfinderRenderUtils.h"
 
 #include "../PathNode.h"
 
+// cells per side of the clusters of hierarchical grids
+static const int DEFAULT_HIERARCHICAL_CLUSTER_SIZE = 16;
+
+// cells per side of the tiles of tiled grids
+static const int DEFAULT_GRID_TILE_SIZE = 64;
+
+// tiles loaded at the same time by tiled grids
+static const size_t DEFAULT_MAX_LOADED_TILES = 256;
+
+// Grid map
+struct GridMap;
+
+// Grid tile source
+class GridTileSource;
+
+// Layered grid map
+struct LayeredGridMap;
+
+// Cell cost table
+class CellCostTable;
+
 // Search space data
 struct SearchSpaceData
 {
@@ -15,21 +38,54 @@ struct SearchSpaceData
 	MathGeom::Vector3 worldSize;
 
 	float gridCellSize{ 1.0f };
+
+	// precompute jump distances on grids (needed by JPS+)
+	bool precomputeJumpDistances{ false };
+
+	// landmarks of grids for the ALT heuristic (0 for none)
+	size_t landmarkCount{ 0 };
+
+	// cluster size of hierarchical grids (in cells)
+	int hierarchicalClusterSize{ DEFAULT_HIERARCHICAL_CLUSTER_SIZE };
+
+	// cells of grids (the grid takes its size from the map and ignores worldSize.x/z), the test layout is used if not set
+	std::shared_ptr<const GridMap> gridMap;
+
+	// prebuilt nav data of grids (see NavData), used in place of the map when it can be loaded
+	std::string navDataFile;
+
+	// verify the checksum of the nav data when it is loaded (reads the whole file)
+	bool verifyNavData{ true };
+
+	// cells per side of the tiles of tiled grids (rounded up to a power of two)
+	int gridTileSize{ DEFAULT_GRID_TILE_SIZE };
+
+	// tile budget of tiled grids (tiles loaded at the same time)
+	size_t maxLoadedTiles{ DEFAULT_MAX_LOADED_TILES };
+
+	// tiles kept loaded around every streamed position by tiled grids (in tiles, 1 for the 3x3 tiles around it)
+	int tileStreamingRadius{ 1 };
+
+	// cells of tiled grids, read as tiles are loaded (the grid map or the test layout is used if not set)
+	std::shared_ptr<const GridTileSource> gridTileSource;
+
+	// floors and links of layered grids (the grid takes its size from the map and ignores worldSize), a single layer
+	// from the grid map or the test layout is used if not set
+	std::shared_ptr<const LayeredGridMap> layeredGridMap;
 };
 
-// Search space
+// Search space.
+// Nodes are identified by PathNodeId (0 to GetNodeCount() - 1), so a search space is free to keep
+// explicit PathNodes or to derive everything from the node id.
 class SearchSpace
 {
 protected:
 
-	// nodes
-	std::vector<PathNode> nodes;
-
 	// search space data
 	SearchSpaceData searchSpaceData;
 
-	// node renderable
-	Renderable nodeRenderable;
+	// version (bumped whenever nodes change, so results found on an older version can be discarded)
+	size_t version{ 0 };
 
 public:
 
@@ -41,20 +97,73 @@ public:
 		Validate(); 
 	}
 
+	// Destructor
+	virtual ~SearchSpace() = default;
+
 	// Build
 	virtual void Build() = 0;
 
-	// Localise
-	virtual PathNode* Localise(const MathGeom::Vector3& position) = 0;
+	// Localise (INVALID_PATH_NODE_ID if the position is outside the search space)
+	virtual PathNodeId Localise(const MathGeom::Vector3& position) = 0;
+
+	// Get node count
+	virtual size_t GetNodeCount() const = 0;
+
+	// Get version
+	size_t GetVersion() const { return version; }
+
+	// Get node position
+	virtual MathGeom::Vector3 GetNodePosition(PathNodeId node) const = 0;
+
+	// Is walkable (false for INVALID_PATH_NODE_ID)
+	virtual bool IsWalkable(PathNodeId node) const = 0;
+
+	// Is reachable (false when no path can join the nodes, known without searching; true if it is not known)
+	virtual bool IsReachable(PathNodeId from, PathNodeId to) const { return true; }
+
+	// Set node walkable (not to be called while a search is running; false if the search space can not change)
+	virtual bool SetNodeWalkable(PathNodeId node, bool walkable) { return false; }
+
+	// Get cell costs (traversal costs of the nodes, nullptr if every move costs its length)
+	virtual const CellCostTable* GetCellCosts() const { return nullptr; }
+
+	// Set node costs (a batch of nodes given the same cost, see CellCostTable, the version is bumped once for the batch;
+	// not to be called while a search is running; false if the search space has no costs)
+	virtual bool SetNodeCosts(const std::vector<PathNodeId>& nodes, uint8_t cost) { return false; }
+
+	// Is loaded on demand (nodes are loaded by the searches that reach them, so searches can not run in parallel)
+	virtual bool IsLoadedOnDemand() const { return false; }
+
+	// Stream around (keep the nodes around the positions loaded, e.g. agents and requests; not while a search is running)
+	virtual void StreamAround(const std::vector<MathGeom::Vector3>& positions) {}
+
+	// Get neighbour (INVALID_PATH_NODE_ID if there is no neighbour in that direction)
+	virtual PathNodeId GetNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const = 0;
 
 	// Is valid adjacency
-	virtual bool IsValidAdjacency(PathNode* node, PathNode* neighbour) = 0;
+	virtual bool IsValidAdjacency(PathNodeId node, PathNodeId neighbour) = 0;
 
 	// Get validated PathNode
-	virtual PathNode* GetValidatedPathNode(PathNode* nodeA, PathNode* nodeB) = 0;
+	virtual PathNodeId GetValidatedPathNode(PathNodeId nodeA, PathNodeId nodeB) = 0;
+
+	// Get valid neighbours (neighbours with a valid adjacency, returns how many were written)
+	virtual size_t GetValidNeighbours(PathNodeId node, PathNodeNeighbours& neighbours)
+	{
+		size_t count = 0;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			PathNodeId neighbour = GetNeighbour(node, PathNodeAdjacency(adjacency));
+			if (IsValidAdjacency(node, neighbour))
+			{
+				neighbours[count++] = neighbour;
+			}
+		}
+
+		return count;
+	}
 
 	// Debug render
-	void DebugRender(const MathGeom::Matrix4& viewProjection)
+	virtual void DebugRender(const MathGeom::Matrix4& viewProjection)
 	{
 		DebugRenderNodes(viewProjection);
 	}
@@ -72,15 +181,15 @@ private:
 	// Debug render nodes
 	void DebugRenderNodes(const MathGeom::Matrix4& viewProjection)
 	{
-		for (auto& node : nodes)
+		for (PathNodeId node = 0; node < GetNodeCount(); node++)
 		{
 			Transform transform;
-			transform.position = node.position;
+			transform.position = GetNodePosition(node);
 
-			RenderUtils::RenderCube(viewProjection, transform, static_cast<unsigned>(node.type));
+			PathNodeType type = IsWalkable(node) ? PathNodeType::UNBLOCKED : PathNodeType::BLOCKED;
+			RenderUtils::RenderCube(viewProjection, transform, static_cast<unsigned>(type));
 		}
 	}
 };
 
 #endif // !SEARCH_SPACE_H
-
@@ -4,12 +4,20 @@
 // Search space type
 enum class SearchSpaceType
 {
-	OCTILE_GRID
+	OCTILE_GRID,
+	COMPACT_OCTILE_GRID,
+	HIERARCHICAL_OCTILE_GRID,
+	TILED_OCTILE_GRID,
+	LAYERED_OCTILE_GRID
 };
 
 #include "SearchSpace.h"
 
 #include "NavGrid.h"
+#include "CompactNavGrid.h"
+#include "HierarchicalNavGrid.h"
+#include "TiledNavGrid.h"
+#include "LayeredNavGrid.h"
 
 #endif // !SEARCH_SPACE_TYPES_H
 
@@ -0,0 +1,590 @@
+#ifndef TILED_NAVGRID_H
+#define TILED_NAVGRID_H
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "SearchSpace.h"
+#include "GridMap.h"
+
+// slot of the tiles that are not loaded
+static const uint32_t NO_TILE_SLOT = UINT32_MAX;
+
+// Grid tile source (cells of the world of a tiled grid, read when one of its tiles is loaded)
+class GridTileSource
+{
+public:
+
+	// Destructor
+	virtual ~GridTileSource() = default;
+
+	// Is walkable (only asked for cells inside the world)
+	virtual bool IsWalkable(int x, int z) const = 0;
+};
+
+// Tiled grid (for worlds too large to keep every cell in memory).
+// The world is split in square tiles that are loaded when they are first read and evicted when the tile budget is
+// used up (least recently read first, tiles streamed around agents and requests last), so memory follows the area
+// in use rather than the world: one bit per cell of the loaded tiles, and a tile table of 4 bytes per tile.
+// Node ids are those of a whole grid (z * totalCellsX + x), so they stay valid as tiles come and go, and
+// neighbours are found from the node id, so moves across tile borders just read the next tile.
+// Tiles are loaded by the searches that reach them, so the grid is written while searching and can not be searched
+// by worker threads. Cells changed at runtime are kept apart and applied again when their tile is loaded.
+class TiledNavGrid : public SearchSpace
+{
+	// Tile slot (cells of a loaded tile, one bit per cell by rows of the tile)
+	struct TileSlot
+	{
+		// tile (index in the world, NO_TILE_SLOT if the slot is free)
+		uint32_t tile{ NO_TILE_SLOT };
+
+		// cells
+		std::vector<uint64_t> words;
+
+		// read since the clock hand last went past it
+		bool referenced{ false };
+
+		// around a streamed position
+		bool streamed{ false };
+
+		// Get (cell of the tile)
+		bool Get(size_t index) const { return (words[index >> 6] & (uint64_t(1) << (index & 63))) != 0; }
+
+		// Set (cell of the tile)
+		void Set(size_t index, bool walkable)
+		{
+			uint64_t bit = uint64_t(1) << (index & 63);
+			words[index >> 6] = walkable ? (words[index >> 6] | bit) : (words[index >> 6] & ~bit);
+		}
+	};
+
+	// cell size
+	float cellSize{ 1.0f };
+
+	// total cells
+	size_t totalCellsX{ 0 };
+	size_t totalCellsZ{ 0 };
+
+	// tiles (tileSize = 1 << tileBits cells per side)
+	int tileBits{ 0 };
+	int tileMask{ 0 };
+	size_t tilesX{ 0 };
+	size_t tilesZ{ 0 };
+
+	// slot of every tile of the world (NO_TILE_SLOT if it is not loaded)
+	mutable std::vector<uint32_t> tileSlots;
+
+	// loaded tiles (up to the tile budget)
+	mutable std::vector<TileSlot> slots;
+
+	// clock hand (next slot to be considered for eviction)
+	mutable size_t clockHand{ 0 };
+
+	// cells changed at runtime by tile (applied in order when the tile is loaded)
+	std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, bool>>> tileEdits;
+
+	// stats
+	mutable size_t tileLoads{ 0 };
+	mutable size_t tileEvictions{ 0 };
+
+public:
+
+	// Constructors
+	TiledNavGrid() = default;
+	TiledNavGrid(const SearchSpaceData& data)
+		: SearchSpace(data)
+		, cellSize(data.gridCellSize)
+	{
+	}
+
+	// Build (no tile is loaded until it is read or streamed)
+	void Build() override
+	{
+		auto& worldSize = searchSpaceData.worldSize;
+		auto& gridMap = searchSpaceData.gridMap;
+
+		if (gridMap && !searchSpaceData.gridTileSource)
+		{
+			totalCellsX = gridMap->width;
+			totalCellsZ = gridMap->height;
+
+			worldSize.x = totalCellsX * cellSize;
+			worldSize.z = totalCellsZ * cellSize;
+		}
+		else
+		{
+			totalCellsX = int(worldSize.x / cellSize);
+			totalCellsZ = int(worldSize.z / cellSize);
+		}
+
+		// node ids of the whole world must fit in a PathNodeId
+		assert(uint64_t(totalCellsX) * totalCellsZ < INVALID_PATH_NODE_ID);
+
+		// tiles (at least 8 cells per side, so a tile is a whole number of words)
+		tileBits = 3;
+		while ((1 << tileBits) < searchSpaceData.gridTileSize)
+		{
+			tileBits++;
+		}
+
+		tileMask = (1 << tileBits) - 1;
+		tilesX = (totalCellsX + tileMask) >> tileBits;
+		tilesZ = (totalCellsZ + tileMask) >> tileBits;
+
+		tileSlots.assign(tilesX * tilesZ, NO_TILE_SLOT);
+
+		// slots are read by reference, so they never move
+		slots.clear();
+		slots.reserve(GetMaxLoadedTiles());
+		clockHand = 0;
+
+		tileEdits.clear();
+		tileLoads = 0;
+		tileEvictions = 0;
+
+		version++;
+	}
+
+	// Set cell walkable (not to be called while a search is running)
+	void SetCellWalkable(int x, int z, bool walkable)
+	{
+		assert(GetNodeId(x, z) != INVALID_PATH_NODE_ID);
+
+		if (IsCellWalkable(x, z) == walkable)
+		{
+			return;
+		}
+
+		// the tile was just read, so it is loaded
+		uint32_t tile = GetTile(x, z);
+		uint32_t index = GetTileCellIndex(x, z);
+		slots[tileSlots[tile]].Set(index, walkable);
+
+		// kept to be applied again when the tile is loaded after being evicted
+		auto& edits = tileEdits[tile];
+		auto edit = std::find_if(edits.begin(), edits.end(), [index](const std::pair<uint32_t, bool>& entry) { return entry.first == index; });
+		if (edit != edits.end())
+		{
+			edit->second = walkable;
+		}
+		else
+		{
+			edits.emplace_back(index, walkable);
+		}
+
+		version++;
+	}
+
+	// Set node walkable (see SetCellWalkable)
+	bool SetNodeWalkable(PathNodeId node, bool walkable) override
+	{
+		SetCellWalkable(int(GetCellX(node)), int(GetCellZ(node)), walkable);
+		return true;
+	}
+
+	// Is loaded on demand
+	bool IsLoadedOnDemand() const override { return true; }
+
+	// Stream around (the tiles around the positions are loaded and evicted last, up to half the tile budget,
+	// the other half is left to the tiles the searches reach)
+	void StreamAround(const std::vector<MathGeom::Vector3>& positions) override
+	{
+		for (auto& slot : slots)
+		{
+			slot.streamed = false;
+		}
+
+		size_t maxStreamedTiles = std::max(GetMaxLoadedTiles() / 2, size_t(1));
+		size_t streamedTiles = 0;
+
+		int radius = std::max(searchSpaceData.tileStreamingRadius, 0);
+		for (auto& position : positions)
+		{
+			PathNodeId node = Localise(position);
+			if (node == INVALID_PATH_NODE_ID)
+			{
+				continue;
+			}
+
+			int tileX = int(GetCellX(node)) >> tileBits;
+			int tileZ = int(GetCellZ(node)) >> tileBits;
+			for (int z = std::max(tileZ - radius, 0); z <= std::min(tileZ + radius, int(tilesZ) - 1); z++)
+			{
+				for (int x = std::max(tileX - radius, 0); x <= std::min(tileX + radius, int(tilesX) - 1); x++)
+				{
+					if (streamedTiles >= maxStreamedTiles)
+					{
+						return;
+					}
+
+					TileSlot& slot = GetTileSlot(uint32_t(z * tilesX + x));
+					if (!slot.streamed)
+					{
+						slot.streamed = true;
+						streamedTiles++;
+					}
+				}
+			}
+		}
+	}
+
+	// Localise
+	PathNodeId Localise(const MathGeom::Vector3& position) override
+	{
+		MathGeom::Vector3 anchorToPos = position - searchSpaceData.anchorPosition;
+		if (	anchorToPos.x >= 0 && anchorToPos.x <= searchSpaceData.worldSize.x
+			&&	anchorToPos.z >= 0 && anchorToPos.z <= searchSpaceData.worldSize.z)
+		{
+			anchorToPos /= cellSize;
+			return GetNodeId(int(anchorToPos.x), int(anchorToPos.z));
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get node count (cells of the whole world, loaded or not)
+	size_t GetNodeCount() const override { return totalCellsX * totalCellsZ; }
+
+	// Get node position
+	MathGeom::Vector3 GetNodePosition(PathNodeId node) const override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		auto& anchorPos = searchSpaceData.anchorPosition;
+		float halfCellSize = cellSize * 0.5f;
+
+		return MathGeom::Vector3(anchorPos.x + GetCellX(node) * cellSize + halfCellSize, anchorPos.y, anchorPos.z + GetCellZ(node) * cellSize + halfCellSize);
+	}
+
+	// Is walkable (the tile of the node is loaded if it is not)
+	bool IsWalkable(PathNodeId node) const override final
+	{
+		return node != INVALID_PATH_NODE_ID && IsCellWalkable(int(GetCellX(node)), int(GetCellZ(node)));
+	}
+
+	// Get neighbour
+	PathNodeId GetNeighbour(PathNodeId node, PathNodeAdjacency adjacency) const override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		return GetNodeId(
+			int(GetCellX(node)) + GRID_ADJACENCY_OFFSET_X[(int)adjacency],
+			int(GetCellZ(node)) + GRID_ADJACENCY_OFFSET_Z[(int)adjacency]);
+	}
+
+	// Is valid adjacency
+	bool IsValidAdjacency(PathNodeId node, PathNodeId neighbour) override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		if (!IsWalkable(neighbour))
+			return false;
+
+		int x = int(GetCellX(node));
+		int z = int(GetCellZ(node));
+		int dx = int(GetCellX(neighbour)) - x;
+		int dz = int(GetCellZ(neighbour)) - z;
+
+		assert(dx >= -1 && dx <= 1 && dz >= -1 && dz <= 1);
+
+		// a diagonal move is only blocked when both straight cells next to it are blocked
+		if (dx != 0 && dz != 0)
+		{
+			if (!IsCellWalkable(x, z + dz) && !IsCellWalkable(x + dx, z))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Get validated PathNode
+	PathNodeId GetValidatedPathNode(PathNodeId nodeA, PathNodeId nodeB) override
+	{
+		int x = int(GetCellX(nodeA));
+		int z = int(GetCellZ(nodeA));
+		int dx = int(GetCellX(nodeB)) - x;
+		int dz = int(GetCellZ(nodeB)) - z;
+
+		// a diagonal move cutting a blocked corner goes through the walkable straight cell instead
+		if ((dx == 1 || dx == -1) && (dz == 1 || dz == -1))
+		{
+			if (!IsCellWalkable(x, z + dz))
+			{
+				return GetNodeId(x + dx, z);
+			}
+
+			if (!IsCellWalkable(x + dx, z))
+			{
+				return GetNodeId(x, z + dz);
+			}
+		}
+
+		return nodeB;
+	}
+
+	// Get valid neighbours (the cells around a node inside its tile are read from the tile, others go through their own tile)
+	size_t GetValidNeighbours(PathNodeId node, PathNodeNeighbours& neighbours) override
+	{
+		assert(node != INVALID_PATH_NODE_ID);
+
+		int x = int(GetCellX(node));
+		int z = int(GetCellZ(node));
+		int localX = x & tileMask;
+		int localZ = z & tileMask;
+
+		std::array<bool, (int)PathNodeAdjacency::MAX_ADJACENCY> walkable;
+		if (localX > 0 && localX < tileMask && localZ > 0 && localZ < tileMask)
+		{
+			const TileSlot& slot = GetTileSlot(GetTile(x, z));
+			for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+			{
+				int neighbourX = localX + GRID_ADJACENCY_OFFSET_X[adjacency];
+				int neighbourZ = localZ + GRID_ADJACENCY_OFFSET_Z[adjacency];
+				walkable[adjacency] = slot.Get((size_t(neighbourZ) << tileBits) + neighbourX);
+			}
+		}
+		else
+		{
+			for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+			{
+				walkable[adjacency] = IsCellWalkable(x + GRID_ADJACENCY_OFFSET_X[adjacency], z + GRID_ADJACENCY_OFFSET_Z[adjacency]);
+			}
+		}
+
+		size_t count = 0;
+		for (int adjacency = 0; adjacency < (int)PathNodeAdjacency::MAX_ADJACENCY; adjacency++)
+		{
+			if (!walkable[adjacency])
+			{
+				continue;
+			}
+
+			// PathNodeAdjacency alternates diagonal and straight directions, starting with TOP_LEFT
+			if ((adjacency & 1) == 0)
+			{
+				// diagonal: a diagonal move is only blocked when both straight cells next to it are blocked
+				int previous = (adjacency + 7) % (int)PathNodeAdjacency::MAX_ADJACENCY;
+				int next = adjacency + 1;
+				if (!walkable[previous] && !walkable[next])
+				{
+					continue;
+				}
+			}
+
+			// cells outside the world are not walkable, so the neighbour is inside
+			neighbours[count++] = PathNodeId((z + GRID_ADJACENCY_OFFSET_Z[adjacency]) * totalCellsX + x + GRID_ADJACENCY_OFFSET_X[adjacency]);
+		}
+
+		return count;
+	}
+
+	// Is cell walkable (false outside the world, the tile of the cell is loaded if it is not)
+	bool IsCellWalkable(int x, int z) const
+	{
+		if (x < 0 || x >= int(totalCellsX) || z < 0 || z >= int(totalCellsZ))
+		{
+			return false;
+		}
+
+		return GetTileSlot(GetTile(x, z)).Get(GetTileCellIndex(x, z));
+	}
+
+	// Get node id (INVALID_PATH_NODE_ID outside the world)
+	PathNodeId GetNodeId(int x, int z) const
+	{
+		if (x >= 0 && x < int(totalCellsX) && z >= 0 && z < int(totalCellsZ))
+		{
+			return PathNodeId(z * totalCellsX + x);
+		}
+
+		return INVALID_PATH_NODE_ID;
+	}
+
+	// Get cell coordinates
+	size_t GetCellX(PathNodeId node) const { return node % totalCellsX; }
+	size_t GetCellZ(PathNodeId node) const { return node / totalCellsX; }
+
+	// Get total cells
+	size_t GetTotalCellsX() const { return totalCellsX; }
+	size_t GetTotalCellsZ() const { return totalCellsZ; }
+
+	// Get tile size (cells per side)
+	int GetTileSize() const { return 1 << tileBits; }
+
+	// Get tile budget (no more than the tiles of the world)
+	size_t GetMaxLoadedTiles() const { return std::min(std::max(searchSpaceData.maxLoadedTiles, size_t(1)), tileSlots.size()); }
+
+	// Get loaded tile count
+	size_t GetLoadedTileCount() const { return slots.size(); }
+
+	// Get tile loads/evictions (since the grid was built)
+	size_t GetTileLoadCount() const { return tileLoads; }
+	size_t GetTileEvictionCount() const { return tileEvictions; }
+
+	// Is tile loaded (tile of the cell)
+	bool IsTileLoaded(int x, int z) const { return GetNodeId(x, z) != INVALID_PATH_NODE_ID && tileSlots[GetTile(x, z)] != NO_TILE_SLOT; }
+
+	// Get memory usage (bytes)
+	size_t GetMemoryUsage() const
+	{
+		size_t memoryUsage = tileSlots.size() * sizeof(uint32_t) + slots.size() * sizeof(TileSlot);
+		for (auto& slot : slots)
+		{
+			memoryUsage += slot.words.size() * sizeof(uint64_t);
+		}
+
+		for (auto& edits : tileEdits)
+		{
+			memoryUsage += edits.second.size() * sizeof(std::pair<uint32_t, bool>);
+		}
+
+		return memoryUsage;
+	}
+
+	// Debug render (cells of the loaded tiles)
+	void DebugRender(const MathGeom::Matrix4& viewProjection) override
+	{
+		for (auto& slot : slots)
+		{
+			int originX = int(slot.tile % tilesX) << tileBits;
+			int originZ = int(slot.tile / tilesX) << tileBits;
+			for (int z = originZ; z < std::min(originZ + GetTileSize(), int(totalCellsZ)); z++)
+			{
+				for (int x = originX; x < std::min(originX + GetTileSize(), int(totalCellsX)); x++)
+				{
+					PathNodeId node = GetNodeId(x, z);
+
+					Transform transform;
+					transform.position = GetNodePosition(node);
+
+					PathNodeType type = slot.Get(GetTileCellIndex(x, z)) ? PathNodeType::UNBLOCKED : PathNodeType::BLOCKED;
+					RenderUtils::RenderCube(viewProjection, transform, static_cast<unsigned>(type));
+				}
+			}
+		}
+	}
+
+private:
+
+	// Get tile (of a cell inside the world)
+	uint32_t GetTile(int x, int z) const { return uint32_t((size_t(z) >> tileBits) * tilesX + (size_t(x) >> tileBits)); }
+
+	// Get tile cell index (of a cell in its tile)
+	uint32_t GetTileCellIndex(int x, int z) const { return uint32_t(((z & tileMask) << tileBits) + (x & tileMask)); }
+
+	// Get tile slot (the tile is loaded if it is not)
+	TileSlot& GetTileSlot(uint32_t tile) const
+	{
+		uint32_t slot = tileSlots[tile];
+		if (slot == NO_TILE_SLOT)
+		{
+			slot = LoadTile(tile);
+		}
+
+		TileSlot& tileSlot = slots[slot];
+		tileSlot.referenced = true;
+		return tileSlot;
+	}
+
+	// Load tile (into a free slot, or the slot of the tile evicted to make room for it)
+	uint32_t LoadTile(uint32_t tile) const
+	{
+		uint32_t slot = uint32_t(slots.size());
+		if (slots.size() < GetMaxLoadedTiles())
+		{
+			slots.emplace_back();
+		}
+		else
+		{
+			slot = FindEvictedSlot();
+
+			tileSlots[slots[slot].tile] = NO_TILE_SLOT;
+			tileEvictions++;
+		}
+
+		TileSlot& tileSlot = slots[slot];
+		tileSlot.tile = tile;
+		tileSlot.referenced = false;
+		tileSlot.streamed = false;
+		BakeTile(tileSlot);
+
+		tileSlots[tile] = slot;
+		tileLoads++;
+
+		return slot;
+	}
+
+	// Find evicted slot (clock: slots read since the hand last went past them get another chance,
+	// and streamed ones are only evicted when every slot is streamed)
+	uint32_t FindEvictedSlot() const
+	{
+		for (size_t step = 0; step < 2 * slots.size(); step++)
+		{
+			TileSlot& tileSlot = slots[clockHand];
+			uint32_t slot = uint32_t(clockHand);
+			clockHand = (clockHand + 1) % slots.size();
+
+			if (tileSlot.streamed)
+			{
+				continue;
+			}
+
+			if (!tileSlot.referenced)
+			{
+				return slot;
+			}
+
+			tileSlot.referenced = false;
+		}
+
+		uint32_t slot = uint32_t(clockHand);
+		clockHand = (clockHand + 1) % slots.size();
+		return slot;
+	}
+
+	// Bake tile (cells from the tile source, the grid map or the test layout, then the cells changed at runtime)
+	void BakeTile(TileSlot& tileSlot) const
+	{
+		int tileSize = GetTileSize();
+		tileSlot.words.assign((size_t(tileSize) * tileSize + 63) / 64, 0);
+
+		int originX = int(tileSlot.tile % tilesX) << tileBits;
+		int originZ = int(tileSlot.tile / tilesX) << tileBits;
+		int endX = std::min(originX + tileSize, int(totalCellsX));
+		int endZ = std::min(originZ + tileSize, int(totalCellsZ));
+
+		auto& tileSource = searchSpaceData.gridTileSource;
+		auto& gridMap = searchSpaceData.gridMap;
+		for (int z = originZ; z < endZ; z++)
+		{
+			for (int x = originX; x < endX; x++)
+			{
+				bool walkable = tileSource ? tileSource->IsWalkable(x, z) : gridMap ? gridMap->IsWalkable(x, z) : IsTestLayoutWalkable(x, z);
+				if (walkable)
+				{
+					tileSlot.Set(GetTileCellIndex(x, z), true);
+				}
+			}
+		}
+
+		auto edits = tileEdits.find(tileSlot.tile);
+		if (edits != tileEdits.end())
+		{
+			for (auto& edit : edits->second)
+			{
+				tileSlot.Set(edit.first, edit.second);
+			}
+		}
+	}
+
+	// Is test layout walkable (2x2 blocks every 3 cells, as the test layout of grids without its random cells)
+	static bool IsTestLayoutWalkable(int x, int z)
+	{
+		return x % 3 == 0 || z % 3 == 0;
+	}
+};
+
+#endif // !TILED_NAVGRID_H
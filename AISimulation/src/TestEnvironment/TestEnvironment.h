@@ -110,11 +110,12 @@ public:
 
 		case GLFW_KEY_J:
 		{
-			static bool jps = false;
-			jps = !jps;
+			// cycle through all planner types (in PathPlannerType order)
+			static int plannerType = (int)PathPlannerType::A_STAR;
+			plannerType = (plannerType + 1) % ((int)PathPlannerType::LAZY_THETA_STAR + 1);
 
 			PathPlannerData plannerData;
-			plannerData.type = jps ? PathPlannerType::JUMP_POINT_SEARCH : PathPlannerType::A_STAR;
+			plannerData.type = PathPlannerType(plannerType);
 			pathfinder.SetPathPlanner(plannerData);
 		}
 
@@ -134,6 +135,25 @@ public:
 
 			break;
 		}
+
+		case GLFW_KEY_F:
+		{
+			FlowFieldRequestData flowFieldRequestData;
+			flowFieldRequestData.goal = MathGeom::Vector3(-46, 0.0f, 22);
+
+			flowFieldRequestData.onFlowFieldRequestResult = [flowFieldRequestData, this](PathRequestId id, PathRequestResultStatus resultStatus, std::shared_ptr<const FlowField> flowField)
+			{
+				printf("FlowFieldRequest %d ([%d, %d]) result: %d\n", id, (int)flowFieldRequestData.goal.x, (int)flowFieldRequestData.goal.z, resultStatus);
+				if (flowField)
+				{
+					this->aiEntity.SetFlowField(flowField, flowFieldRequestData.goal);
+				}
+			};
+
+			pathfinder.RequestFlowField(flowFieldRequestData);
+
+			break;
+		}
 			
 		}
 	}
@@ -345,10 +365,13 @@ protected:
 	{
 		PathfinderData pathfinderData;
 		pathfinderData.pathPlannerData.type = PathPlannerType::A_STAR;
-		pathfinderData.searchSpaceData.searchSpaceType = SearchSpaceType::OCTILE_GRID;
+		pathfinderData.searchSpaceData.searchSpaceType = SearchSpaceType::HIERARCHICAL_OCTILE_GRID;
 		pathfinderData.searchSpaceData.anchorPosition = MathGeom::Vector3(-50.0f, 0.0f, -50.0f);
 		pathfinderData.searchSpaceData.worldSize = MathGeom::Vector3(100.0f, 100.0f, 100.0f);
 		pathfinderData.searchSpaceData.gridCellSize = 10.0f;
+		pathfinderData.searchSpaceData.precomputeJumpDistances = true;
+		pathfinderData.searchSpaceData.hierarchicalClusterSize = 4;
+		pathfinderData.pathRequestSchedulerData.pathSmoothing = PathSmoothing::STRING_PULLING;
 		pathfinder.Init(pathfinderData);
 	}
 
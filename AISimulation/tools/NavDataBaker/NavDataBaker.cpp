@@ -0,0 +1,191 @@
+// Nav data baker.
+// Builds a grid from a Moving AI .map file and writes its cells and tables to a nav data file (see NavData), which
+// grids load in place through SearchSpaceData::navDataFile instead of building them at startup. The file is loaded
+// back and compared with the built grid, and one JSON object is written to stdout with the build and load times.
+//
+// Build (from the AISimulation directory, no OpenGL needed):
+//   g++ -std=c++17 -O2 -DNDEBUG -Icommon/includes -Isrc tools/NavDataBaker/NavDataBaker.cpp -o NavDataBaker -pthread
+//
+// Usage:
+//   NavDataBaker --map <file.map> --out <file> [options]
+//     --cell-size <size>          cell size of the grid (default 1)
+//     --jump-distances <0|1>      bake the jump distances of JPS+ (default 1)
+//     --landmarks <count>         bake the distances of that many landmarks for the landmark heuristic (default 0)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+
+#define PATHFINDER_HEADLESS
+
+#include "TestEnvironment/MathGeom.h"
+#include "TestEnvironment/Pathfinding/Pathfinder.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Baker options
+struct BakerOptions
+{
+	std::string mapFile;
+	std::string outFile;
+	float cellSize{ 1.0f };
+	bool jumpDistances{ true };
+	size_t landmarkCount{ 0 };
+};
+
+// Parse options
+static bool ParseOptions(int argc, char** argv, BakerOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "missing value for %s\n", option.c_str());
+			return false;
+		}
+
+		std::string value = argv[++i];
+		if (option == "--map")
+		{
+			options.mapFile = value;
+		}
+		else if (option == "--out")
+		{
+			options.outFile = value;
+		}
+		else if (option == "--cell-size")
+		{
+			options.cellSize = float(atof(value.c_str()));
+		}
+		else if (option == "--jump-distances")
+		{
+			options.jumpDistances = atoi(value.c_str()) != 0;
+		}
+		else if (option == "--landmarks")
+		{
+			options.landmarkCount = size_t(std::max(atoi(value.c_str()), 0));
+		}
+		else
+		{
+			fprintf(stderr, "unknown option: %s\n", option.c_str());
+			return false;
+		}
+	}
+
+	if (options.mapFile.empty() || options.outFile.empty() || !(options.cellSize > 0.0f))
+	{
+		fprintf(stderr, "usage: NavDataBaker --map <file.map> --out <file> [--cell-size <size>] [--jump-distances <0|1>] [--landmarks <count>]\n");
+		return false;
+	}
+
+	return true;
+}
+
+// Is same table
+template<typename T>
+static bool IsSameTable(const T* a, size_t countA, const T* b, size_t countB)
+{
+	return countA == countB && (countA == 0 || memcmp(a, b, countA * sizeof(T)) == 0);
+}
+
+// Is same grid (cells and tables)
+static bool IsSameGrid(const GridSearchSpace& built, const GridSearchSpace& loaded)
+{
+	if (built.GetTotalCellsX() != loaded.GetTotalCellsX() || built.GetTotalCellsZ() != loaded.GetTotalCellsZ())
+	{
+		return false;
+	}
+
+	for (PathNodeId node = 0; node < built.GetNodeCount(); node++)
+	{
+		if (built.IsWalkable(node) != loaded.IsWalkable(node))
+		{
+			return false;
+		}
+	}
+
+	auto& builtComponents = built.GetComponents();
+	auto& loadedComponents = loaded.GetComponents();
+	auto& builtJumpDistances = built.GetJumpDistances();
+	auto& loadedJumpDistances = loaded.GetJumpDistances();
+	auto& builtLandmarks = built.GetLandmarks();
+	auto& loadedLandmarks = loaded.GetLandmarks();
+
+	return IsSameTable(built.GetWalkableRows().GetWords(), built.GetWalkableRows().GetWordCount(), loaded.GetWalkableRows().GetWords(), loaded.GetWalkableRows().GetWordCount())
+		&& IsSameTable(built.GetWalkableColumns().GetWords(), built.GetWalkableColumns().GetWordCount(), loaded.GetWalkableColumns().GetWords(), loaded.GetWalkableColumns().GetWordCount())
+		&& IsSameTable(builtComponents.GetComponents(), builtComponents.GetNodeCount(), loadedComponents.GetComponents(), loadedComponents.GetNodeCount())
+		&& builtComponents.GetComponentCount() == loadedComponents.GetComponentCount()
+		&& IsSameTable(builtJumpDistances.GetDistances(), builtJumpDistances.GetDistanceCount(), loadedJumpDistances.GetDistances(), loadedJumpDistances.GetDistanceCount())
+		&& builtLandmarks.GetLandmarks() == loadedLandmarks.GetLandmarks()
+		&& IsSameTable(builtLandmarks.GetDistances(), builtLandmarks.GetDistanceCount(), loadedLandmarks.GetDistances(), loadedLandmarks.GetDistanceCount());
+}
+
+int main(int argc, char** argv)
+{
+	BakerOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	auto gridMap = std::make_shared<GridMap>();
+
+	std::ifstream file(options.mapFile);
+	if (!file || !gridMap->LoadMovingAIMap(file))
+	{
+		fprintf(stderr, "could not load map: %s\n", options.mapFile.c_str());
+		return 1;
+	}
+
+	// nav data does not depend on how the grid stores its cells, the compact grid is the cheapest one to build
+	SearchSpaceData searchSpaceData;
+	searchSpaceData.searchSpaceType = SearchSpaceType::COMPACT_OCTILE_GRID;
+	searchSpaceData.anchorPosition = MathGeom::Vector3(0.0f, 0.0f, 0.0f);
+	searchSpaceData.gridCellSize = options.cellSize;
+	searchSpaceData.precomputeJumpDistances = options.jumpDistances;
+	searchSpaceData.landmarkCount = options.landmarkCount;
+	searchSpaceData.gridMap = gridMap;
+
+	auto buildStart = Clock::now();
+	auto built = std::dynamic_pointer_cast<GridSearchSpace>(Pathfinder::CreateSearchSpace(searchSpaceData));
+	double buildTime = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+	if (!built->SaveNavData(options.outFile))
+	{
+		fprintf(stderr, "could not write nav data: %s\n", options.outFile.c_str());
+		return 1;
+	}
+
+	// load it back (without its map, so nothing can be built from it)
+	SearchSpaceData loadData = searchSpaceData;
+	loadData.gridMap = nullptr;
+	loadData.navDataFile = options.outFile;
+
+	auto loadStart = Clock::now();
+	auto loaded = std::dynamic_pointer_cast<GridSearchSpace>(Pathfinder::CreateSearchSpace(loadData));
+	double loadTime = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+
+	if (!loaded->IsNavDataLoaded() || !IsSameGrid(*built, *loaded))
+	{
+		fprintf(stderr, "nav data does not match the grid: %s\n", options.outFile.c_str());
+		return 1;
+	}
+
+	std::ifstream written(options.outFile, std::ios::binary | std::ios::ate);
+	long long bytes = (long long)written.tellg();
+
+	printf("{\"map\":\"%s\",\"out\":\"%s\",\"width\":%zu,\"height\":%zu,\"components\":%zu,\"jump_distances\":%s,\"landmarks\":%zu,"
+		"\"bytes\":%lld,\"build_ms\":%.3f,\"load_ms\":%.3f}\n",
+		options.mapFile.c_str(), options.outFile.c_str(), built->GetTotalCellsX(), built->GetTotalCellsZ(),
+		built->GetComponents().GetComponentCount(), built->GetJumpDistances().IsBuilt() ? "true" : "false",
+		built->GetLandmarks().GetLandmarks().size(), bytes, buildTime, loadTime);
+
+	return 0;
+}
@@ -0,0 +1,1391 @@
+// Pathfinding benchmark.
+// Headless and deterministic: maps come from seeded generators or Moving AI .map files, queries from seeded
+// generators or Moving AI .scen files, and every planner runs the same queries on the same search space.
+// One JSON object per line is written to stdout (a "map" record per map, a "scenario" record per map and planner,
+// a "workers" record per map, planner and worker count with --workers, and a "tiles" record per map on the tiled grid),
+// progress goes to stderr.
+//
+// Build (from the AISimulation directory, no OpenGL needed):
+//   g++ -std=c++17 -O2 -DNDEBUG -Icommon/includes -Isrc tools/PathfindingBenchmark/PathfindingBenchmark.cpp -o PathfindingBenchmark -pthread
+//
+// Usage:
+//   PathfindingBenchmark [options]
+//     --generate random:<size>[:<blocked ratio>]   random blocked cells (default ratio 0.2)
+//     --generate rooms:<size>[:<room size>]        rooms joined by doors (default room size 16)
+//     --generate maze:<size>                       maze with one cell wide corridors
+//     --map <file.map>                             Moving AI map
+//     --scen <file.map.scen>                       Moving AI scenarios of the previous map (random queries otherwise)
+//     --queries <count>                            random queries per map (default 1000)
+//     --seed <seed>                                seed of the generators (default 1)
+//     --planner <name>                             planner to run, astar|jps|bitjps|jpsplus|hpa|dstar|biastar|anytime|theta (repeatable, default all of them)
+//     --search-space <octile|compact|hierarchical|tiled|layered> search space (default hierarchical, the only one hpa
+//                                                  runs on; jps, bitjps, jpsplus and theta do not run on tiled or layered)
+//     --max-revolutions <count>                    revolutions per search slice (default DEFAULT_MAX_REVOLUTIONS)
+//     --heuristic <name>                           heuristic of astar and the jps planners, octile|euclidean|manhattan|landmark|layer (default octile)
+//                                                  (manhattan overestimates diagonal moves, the jps planners use octile instead)
+//     --heuristic-weight <weight>                  weight of the heuristic (default 1, above 1 trades path length for speed)
+//     --anytime-weight <weight>                    heuristic weight of the first search of anytime (default DEFAULT_ANYTIME_INITIAL_WEIGHT)
+//     --smoothing <none|los|funnel>                post-processing of the paths found, timed apart from the search (default none)
+//     --cluster-size <cells>                       cluster size of the hierarchical grid
+//     --landmarks <count>                          landmarks of the grid for the landmark heuristic (default 0, 8 with --heuristic landmark)
+//     --tile-size <cells>                          tile size of the tiled grid (default DEFAULT_GRID_TILE_SIZE)
+//     --tile-budget <tiles>                        tiles the tiled grid keeps loaded (default DEFAULT_MAX_LOADED_TILES)
+//     --layers <count>                             floors of the layered grid, copies of the map joined by ladders, queries
+//                                                  end on every floor in turn (default 1)
+//     --layer-links <count>                        ladders between two floors of the layered grid, on seeded cells (default 4)
+//     --mud <ratio>[:<cost>]                       seeded square patches of costly cells over this ratio of the walkable cells
+//                                                  (cell cost, see CellCostTable, default 32: three times the default cost)
+//     --workers <count>                            also run the queries of every planner on worker pools of 1 to count workers,
+//                                                  a "workers" record per pool (not on search spaces loaded on demand)
+//     --check-equivalence                          (no value) instead of timing the planners, check that jps, bitjps and jpsplus
+//                                                  find paths of the same cost as astar for every query (octile heuristic),
+//                                                  an "equivalence" record per map and planner, exit code 1 on any mismatch
+//     --check-scheduler                            (no value) instead of timing the planners, run regression checks of the path
+//                                                  request scheduler on their own maps, a "check" record per check, exit code 1
+//                                                  on any failure (build with -fsanitize=address to catch use after free)
+//   Without --generate or --map it runs random:256, rooms:256 and maze:255.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+#define PATHFINDER_HEADLESS
+
+#include "TestEnvironment/MathGeom.h"
+#include "TestEnvironment/Pathfinding/Pathfinder.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Benchmark planner
+struct BenchmarkPlanner
+{
+	const char* name;
+	PathPlannerType type;
+};
+
+// planners (new planners are added here)
+static const BenchmarkPlanner BENCHMARK_PLANNERS[] =
+{
+	{ "astar", PathPlannerType::A_STAR },
+	{ "jps", PathPlannerType::JUMP_POINT_SEARCH },
+	{ "bitjps", PathPlannerType::BIT_JUMP_POINT_SEARCH },
+	{ "jpsplus", PathPlannerType::JUMP_POINT_SEARCH_PLUS },
+	{ "hpa", PathPlannerType::HIERARCHICAL_A_STAR },
+	{ "dstar", PathPlannerType::D_STAR_LITE },
+	{ "biastar", PathPlannerType::BIDIRECTIONAL_A_STAR },
+	{ "anytime", PathPlannerType::ANYTIME_A_STAR },
+	{ "theta", PathPlannerType::LAZY_THETA_STAR },
+};
+
+// Benchmark heuristic
+struct BenchmarkHeuristic
+{
+	const char* name;
+	PathPlannerHeuristic heuristic;
+};
+
+// heuristics
+static const BenchmarkHeuristic BENCHMARK_HEURISTICS[] =
+{
+	{ "octile", PathPlannerHeuristic::OCTILE },
+	{ "euclidean", PathPlannerHeuristic::EUCLIDEAN },
+	{ "manhattan", PathPlannerHeuristic::MANHATTAN },
+	{ "landmark", PathPlannerHeuristic::LANDMARK },
+	{ "layer", PathPlannerHeuristic::LAYER },
+};
+
+// Benchmark smoothing
+struct BenchmarkSmoothing
+{
+	const char* name;
+	PathSmoothing type;
+};
+
+// smoothings
+static const BenchmarkSmoothing BENCHMARK_SMOOTHINGS[] =
+{
+	{ "none", PathSmoothing::NONE },
+	{ "los", PathSmoothing::LINE_OF_SIGHT },
+	{ "funnel", PathSmoothing::STRING_PULLING },
+};
+
+// Benchmark search space
+struct BenchmarkSearchSpace
+{
+	const char* name;
+	SearchSpaceType type;
+};
+
+// search spaces
+static const BenchmarkSearchSpace BENCHMARK_SEARCH_SPACES[] =
+{
+	{ "octile", SearchSpaceType::OCTILE_GRID },
+	{ "compact", SearchSpaceType::COMPACT_OCTILE_GRID },
+	{ "hierarchical", SearchSpaceType::HIERARCHICAL_OCTILE_GRID },
+	{ "tiled", SearchSpaceType::TILED_OCTILE_GRID },
+	{ "layered", SearchSpaceType::LAYERED_OCTILE_GRID },
+};
+
+// Benchmark query
+struct BenchmarkQuery
+{
+	int startX;
+	int startZ;
+	int goalX;
+	int goalZ;
+
+	// optimal length from the scenario file (negative if unknown)
+	double optimalLength;
+};
+
+// Benchmark map
+struct BenchmarkMap
+{
+	std::string name;
+	std::shared_ptr<GridMap> gridMap;
+	std::vector<BenchmarkQuery> queries;
+};
+
+// Benchmark options
+struct BenchmarkOptions
+{
+	std::vector<std::string> generators;
+	std::vector<std::pair<std::string, std::string>> mapFiles;
+	std::vector<PathPlannerType> planners;
+	SearchSpaceType searchSpaceType{ SearchSpaceType::HIERARCHICAL_OCTILE_GRID };
+	size_t queryCount{ 1000 };
+	uint32_t seed{ 1 };
+	int maxRevolutions{ DEFAULT_MAX_REVOLUTIONS };
+	PathPlannerHeuristic heuristic{ PathPlannerHeuristic::OCTILE };
+	float heuristicWeight{ 1.0f };
+	float anytimeWeight{ DEFAULT_ANYTIME_INITIAL_WEIGHT };
+	PathSmoothing smoothing{ PathSmoothing::NONE };
+	int landmarkCount{ -1 };
+	int clusterSize{ DEFAULT_HIERARCHICAL_CLUSTER_SIZE };
+	int tileSize{ DEFAULT_GRID_TILE_SIZE };
+	size_t tileBudget{ DEFAULT_MAX_LOADED_TILES };
+	int layerCount{ 1 };
+	int layerLinkCount{ 4 };
+	double mudRatio{ 0.0 };
+	uint8_t mudCost{ 32 };
+	int workerCount{ 0 };
+	bool checkEquivalence{ false };
+	bool checkScheduler{ false };
+};
+
+// Random.
+// std::mt19937 gives the same numbers everywhere but the standard distributions do not,
+// so numbers are mapped here to get the same maps and queries on every platform.
+class Random
+{
+	std::mt19937 engine;
+
+public:
+
+	// Constructor
+	explicit Random(uint32_t seed)
+		: engine(seed)
+	{
+	}
+
+	// Next (in [0, count))
+	uint32_t Next(uint32_t count) { return uint32_t((uint64_t(engine()) * count) >> 32); }
+
+	// Chance (true with the given probability)
+	bool Chance(double probability) { return engine() < probability * 4294967296.0; }
+};
+
+// Generate random map
+static void GenerateRandomMap(GridMap& gridMap, size_t size, double blockedRatio, Random& random)
+{
+	gridMap.Init(size, size, true);
+	for (size_t cell = 0; cell < gridMap.walkable.size(); cell++)
+	{
+		gridMap.walkable[cell] = !random.Chance(blockedRatio);
+	}
+}
+
+// Generate rooms map (walls every roomSize cells, with a door of 1 to 3 cells on every wall between two rooms)
+static void GenerateRoomsMap(GridMap& gridMap, size_t size, int roomSize, Random& random)
+{
+	assert(roomSize > 1);
+
+	gridMap.Init(size, size, true);
+	for (int wall = roomSize; wall < int(size); wall += roomSize)
+	{
+		for (int i = 0; i < int(size); i++)
+		{
+			gridMap.SetWalkable(wall, i, false);
+			gridMap.SetWalkable(i, wall, false);
+		}
+	}
+
+	for (int wall = roomSize; wall < int(size); wall += roomSize)
+	{
+		for (int roomStart = 0; roomStart < int(size); roomStart += roomSize)
+		{
+			// room cells along the wall (the first one is a wall cell, except for the first room)
+			int first = roomStart == 0 ? 0 : roomStart + 1;
+			int last = std::min(roomStart + roomSize, int(size)) - 1;
+			if (last < first)
+			{
+				continue;
+			}
+
+			int doorWidth = int(random.Next(3)) + 1;
+			int door = first + int(random.Next(uint32_t(last - first + 1)));
+			for (int i = door; i < door + doorWidth && i <= last; i++)
+			{
+				gridMap.SetWalkable(wall, i, true);
+			}
+
+			doorWidth = int(random.Next(3)) + 1;
+			door = first + int(random.Next(uint32_t(last - first + 1)));
+			for (int i = door; i < door + doorWidth && i <= last; i++)
+			{
+				gridMap.SetWalkable(i, wall, true);
+			}
+		}
+	}
+}
+
+// Generate maze map (corridors carved between the odd cells with a depth first search)
+static void GenerateMazeMap(GridMap& gridMap, size_t size, Random& random)
+{
+	gridMap.Init(size, size, false);
+	if (size < 2)
+	{
+		return;
+	}
+
+	static const int DIRECTION_X[] = { 0, 1, 0, -1 };
+	static const int DIRECTION_Z[] = { -1, 0, 1, 0 };
+
+	std::vector<std::pair<int, int>> stack;
+	stack.emplace_back(1, 1);
+	gridMap.SetWalkable(1, 1, true);
+
+	while (!stack.empty())
+	{
+		int x = stack.back().first;
+		int z = stack.back().second;
+
+		// unvisited cells two steps away
+		int candidates[4];
+		int candidateCount = 0;
+		for (int direction = 0; direction < 4; direction++)
+		{
+			int nextX = x + DIRECTION_X[direction] * 2;
+			int nextZ = z + DIRECTION_Z[direction] * 2;
+			if (nextX > 0 && nextX < int(size) - 1 && nextZ > 0 && nextZ < int(size) - 1 && !gridMap.IsWalkable(nextX, nextZ))
+			{
+				candidates[candidateCount++] = direction;
+			}
+		}
+
+		if (candidateCount == 0)
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		int direction = candidates[random.Next(uint32_t(candidateCount))];
+		gridMap.SetWalkable(x + DIRECTION_X[direction], z + DIRECTION_Z[direction], true);
+		gridMap.SetWalkable(x + DIRECTION_X[direction] * 2, z + DIRECTION_Z[direction] * 2, true);
+		stack.emplace_back(x + DIRECTION_X[direction] * 2, z + DIRECTION_Z[direction] * 2);
+	}
+}
+
+// Generate mud (square patches of costly cells until the ratio of the walkable cells is covered)
+static void GenerateMud(GridMap& gridMap, double ratio, uint8_t cost, Random& random)
+{
+	size_t walkableCount = gridMap.GetWalkableCount();
+	size_t mudTarget = size_t(ratio * walkableCount);
+	size_t mudCount = 0;
+
+	// patches may cover blocked cells and each other, so their count is bound
+	for (size_t patch = 0; mudCount < mudTarget && patch < walkableCount; patch++)
+	{
+		int patchSize = 4 + int(random.Next(13));
+		int minX = int(random.Next(uint32_t(gridMap.width)));
+		int minZ = int(random.Next(uint32_t(gridMap.height)));
+		for (int z = minZ; z < std::min(minZ + patchSize, int(gridMap.height)); z++)
+		{
+			for (int x = minX; x < std::min(minX + patchSize, int(gridMap.width)); x++)
+			{
+				if (gridMap.IsWalkable(x, z) && gridMap.GetCost(x, z) != cost && mudCount < mudTarget)
+				{
+					gridMap.SetCost(x, z, cost);
+					mudCount++;
+				}
+			}
+		}
+	}
+}
+
+// Generate queries (start and goal in the same connected area, so every query has a path)
+static void GenerateQueries(BenchmarkMap& map, size_t queryCount, Random& random)
+{
+	const GridMap& gridMap = *map.gridMap;
+	int width = int(gridMap.width);
+	int height = int(gridMap.height);
+
+	// label connected areas (a diagonal move always has a walkable straight cell next to it, so straight moves are enough)
+	std::vector<int> areas(gridMap.walkable.size(), -1);
+	std::vector<int> areaSizes;
+	std::vector<int> open;
+	for (int cell = 0; cell < int(areas.size()); cell++)
+	{
+		if (!gridMap.walkable[cell] || areas[cell] >= 0)
+		{
+			continue;
+		}
+
+		int area = int(areaSizes.size());
+		areaSizes.push_back(0);
+		areas[cell] = area;
+		open.push_back(cell);
+		while (!open.empty())
+		{
+			int current = open.back();
+			open.pop_back();
+			areaSizes[area]++;
+
+			int x = current % width;
+			int z = current / width;
+			const int neighbours[4][2] = { { x - 1, z }, { x + 1, z }, { x, z - 1 }, { x, z + 1 } };
+			for (auto& neighbour : neighbours)
+			{
+				if (gridMap.IsWalkable(neighbour[0], neighbour[1]) && areas[neighbour[1] * width + neighbour[0]] < 0)
+				{
+					areas[neighbour[1] * width + neighbour[0]] = area;
+					open.push_back(neighbour[1] * width + neighbour[0]);
+				}
+			}
+		}
+	}
+
+	if (std::none_of(areaSizes.begin(), areaSizes.end(), [](int areaSize) { return areaSize > 1; }))
+	{
+		return;
+	}
+
+	while (map.queries.size() < queryCount)
+	{
+		int start = int(random.Next(uint32_t(width * height)));
+		if (areas[start] < 0 || areaSizes[areas[start]] < 2)
+		{
+			continue;
+		}
+
+		int goal = int(random.Next(uint32_t(width * height)));
+		if (goal == start || areas[goal] != areas[start])
+		{
+			continue;
+		}
+
+		map.queries.push_back({ start % width, start / width, goal % width, goal / width, -1.0 });
+	}
+}
+
+// Load Moving AI scenarios (columns: bucket, map, width, height, start x, start y, goal x, goal y, optimal length)
+static bool LoadScenarios(const std::string& fileName, BenchmarkMap& map)
+{
+	std::ifstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream columns(line);
+		int bucket;
+		std::string mapName;
+		int width, height;
+		BenchmarkQuery query;
+		if (columns >> bucket >> mapName >> width >> height >> query.startX >> query.startZ >> query.goalX >> query.goalZ >> query.optimalLength)
+		{
+			map.queries.push_back(query);
+		}
+	}
+
+	return true;
+}
+
+// Create maps
+static bool CreateMaps(const BenchmarkOptions& options, std::vector<BenchmarkMap>& maps)
+{
+	// every map gets its own generator, so adding a map does not change the others
+	uint32_t mapSeed = options.seed;
+
+	for (auto& generator : options.generators)
+	{
+		Random random(mapSeed++);
+
+		std::vector<std::string> parameters;
+		std::istringstream stream(generator);
+		for (std::string parameter; std::getline(stream, parameter, ':');)
+		{
+			parameters.push_back(parameter);
+		}
+
+		size_t size = parameters.size() > 1 ? size_t(atoi(parameters[1].c_str())) : 0;
+		if (size == 0)
+		{
+			fprintf(stderr, "invalid generator: %s\n", generator.c_str());
+			return false;
+		}
+
+		BenchmarkMap map;
+		map.gridMap = std::make_shared<GridMap>();
+		if (parameters[0] == "random")
+		{
+			double blockedRatio = parameters.size() > 2 ? atof(parameters[2].c_str()) : 0.2;
+			GenerateRandomMap(*map.gridMap, size, blockedRatio, random);
+		}
+		else if (parameters[0] == "rooms")
+		{
+			int roomSize = parameters.size() > 2 ? atoi(parameters[2].c_str()) : 16;
+			GenerateRoomsMap(*map.gridMap, size, std::max(roomSize, 2), random);
+		}
+		else if (parameters[0] == "maze")
+		{
+			GenerateMazeMap(*map.gridMap, size, random);
+		}
+		else
+		{
+			fprintf(stderr, "unknown generator: %s\n", generator.c_str());
+			return false;
+		}
+
+		map.name = generator;
+		GenerateQueries(map, options.queryCount, random);
+		maps.push_back(map);
+	}
+
+	for (auto& mapFile : options.mapFiles)
+	{
+		Random random(mapSeed++);
+
+		BenchmarkMap map;
+		map.name = mapFile.first;
+		map.gridMap = std::make_shared<GridMap>();
+
+		std::ifstream file(mapFile.first);
+		if (!file || !map.gridMap->LoadMovingAIMap(file))
+		{
+			fprintf(stderr, "could not load map: %s\n", mapFile.first.c_str());
+			return false;
+		}
+
+		if (mapFile.second.empty())
+		{
+			GenerateQueries(map, options.queryCount, random);
+		}
+		else if (!LoadScenarios(mapFile.second, map))
+		{
+			fprintf(stderr, "could not load scenarios: %s\n", mapFile.second.c_str());
+			return false;
+		}
+
+		maps.push_back(map);
+	}
+
+	return true;
+}
+
+// Escape (JSON string)
+static std::string Escape(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+
+	return escaped;
+}
+
+// Get percentile (nearest rank, values sorted)
+static double GetPercentile(const std::vector<double>& values, double percentile)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+
+	size_t rank = size_t(std::ceil(percentile * values.size()));
+	return values[std::min(std::max(rank, size_t(1)), values.size()) - 1];
+}
+
+// Get name
+template<typename Entry, size_t Count, typename Type>
+static const char* GetName(const Entry(&entries)[Count], Type type)
+{
+	for (auto& entry : entries)
+	{
+		if (entry.type == type)
+		{
+			return entry.name;
+		}
+	}
+
+	return "unknown";
+}
+
+// Create layered grid map (copies of the map, with ladders between every two floors on seeded walkable cells)
+static std::shared_ptr<LayeredGridMap> CreateLayeredGridMap(const BenchmarkOptions& options, const GridMap& gridMap)
+{
+	auto layeredGridMap = std::make_shared<LayeredGridMap>();
+	layeredGridMap->layers.assign(size_t(options.layerCount), gridMap);
+
+	Random random(options.seed);
+	size_t walkableCount = gridMap.GetWalkableCount();
+	for (int layer = 0; layer + 1 < options.layerCount; layer++)
+	{
+		// a cell has one ladder to the floor above at most, so no node has more than MAX_PATH_NODE_LINKS links
+		size_t firstLink = layeredGridMap->links.size();
+		for (int link = 0; link < options.layerLinkCount && size_t(link) < walkableCount; link++)
+		{
+			int x;
+			int z;
+			do
+			{
+				x = int(random.Next(uint32_t(gridMap.width)));
+				z = int(random.Next(uint32_t(gridMap.height)));
+			} while (!gridMap.IsWalkable(x, z) || std::any_of(layeredGridMap->links.begin() + firstLink, layeredGridMap->links.end(),
+				[x, z](const GridLayerLink& other) { return other.x == x && other.z == z; }));
+
+			layeredGridMap->links.push_back({ x, z, layer, x, z, layer + 1, GridLayerLinkType::LADDER });
+		}
+	}
+
+	return layeredGridMap;
+}
+
+// Get search space data (of the map, with the options of the benchmark)
+static SearchSpaceData GetSearchSpaceData(const BenchmarkOptions& options, const BenchmarkMap& map)
+{
+	SearchSpaceData searchSpaceData;
+	searchSpaceData.searchSpaceType = options.searchSpaceType;
+	searchSpaceData.anchorPosition = MathGeom::Vector3(0.0f, 0.0f, 0.0f);
+	searchSpaceData.worldSize = MathGeom::Vector3(float(map.gridMap->width), 1.0f, float(map.gridMap->height));
+	searchSpaceData.gridCellSize = 1.0f;
+	searchSpaceData.precomputeJumpDistances = true;
+	searchSpaceData.hierarchicalClusterSize = options.clusterSize;
+	searchSpaceData.landmarkCount = size_t(options.landmarkCount);
+	searchSpaceData.gridTileSize = options.tileSize;
+	searchSpaceData.maxLoadedTiles = options.tileBudget;
+	searchSpaceData.gridMap = map.gridMap;
+
+	if (options.searchSpaceType == SearchSpaceType::LAYERED_OCTILE_GRID)
+	{
+		searchSpaceData.layeredGridMap = CreateLayeredGridMap(options, *map.gridMap);
+	}
+
+	return searchSpaceData;
+}
+
+// Get planner path cost (octile moves between the nodes found by the planner, scaled by the cell costs)
+static double GetPlannerPathCost(const SearchSpace& searchSpace, const PathPlanner& planner)
+{
+	OctileEdgeCost edgeCost(searchSpace.GetCellCosts());
+
+	double cost = 0.0;
+	const std::vector<PathNodeId>& plannerPath = planner.GetPlannerPath();
+	for (size_t i = 1; i < plannerPath.size(); i++)
+	{
+		cost += edgeCost.Cost(plannerPath[i - 1], searchSpace.GetNodePosition(plannerPath[i - 1]), plannerPath[i], searchSpace.GetNodePosition(plannerPath[i]));
+	}
+
+	return cost;
+}
+
+// Find path (searches until completed, returns the cost of the path or -1 if there is none)
+static double FindPath(const SearchSpace& searchSpace, PathPlanner& planner, PathNodeId start, PathNodeId goal)
+{
+	bool searchCompleted = planner.StartSearch(start, goal);
+	while (!searchCompleted)
+	{
+		searchCompleted = planner.ResumeSearch();
+	}
+
+	Path path;
+	planner.GetPath(path);
+
+	return path.empty() ? -1.0 : GetPlannerPathCost(searchSpace, planner);
+}
+
+// Check equivalence (jps, bitjps and jpsplus find paths of the same cost as astar, false on any mismatch)
+static bool CheckEquivalence(const BenchmarkOptions& options, const BenchmarkMap& map)
+{
+	bool needsWholeGrid = options.searchSpaceType == SearchSpaceType::TILED_OCTILE_GRID || options.searchSpaceType == SearchSpaceType::LAYERED_OCTILE_GRID;
+	if (needsWholeGrid)
+	{
+		fprintf(stderr, "%s: the jps planners need the tables of a whole grid\n", map.name.c_str());
+		return false;
+	}
+
+	const char* searchSpaceName = GetName(BENCHMARK_SEARCH_SPACES, options.searchSpaceType);
+	auto searchSpace = Pathfinder::CreateSearchSpace(GetSearchSpaceData(options, map));
+
+	// octile heuristic without weight, so every planner finds shortest paths
+	PathPlannerData plannerData;
+	plannerData.maxRevolutions = options.maxRevolutions;
+
+	plannerData.type = PathPlannerType::A_STAR;
+	auto reference = Pathfinder::CreatePathPlanner(plannerData, searchSpace);
+
+	std::vector<std::pair<PathNodeId, PathNodeId>> queries;
+	std::vector<const BenchmarkQuery*> mapQueries;
+	std::vector<double> referenceCosts;
+	for (auto& mapQuery : map.queries)
+	{
+		PathNodeId start = searchSpace->Localise(MathGeom::Vector3(mapQuery.startX + 0.5f, 0.0f, mapQuery.startZ + 0.5f));
+		PathNodeId goal = searchSpace->Localise(MathGeom::Vector3(mapQuery.goalX + 0.5f, 0.0f, mapQuery.goalZ + 0.5f));
+		if (searchSpace->IsWalkable(start) && searchSpace->IsWalkable(goal))
+		{
+			queries.emplace_back(start, goal);
+			mapQueries.push_back(&mapQuery);
+			referenceCosts.push_back(FindPath(*searchSpace, *reference, start, goal));
+		}
+	}
+
+	bool equivalent = true;
+	for (PathPlannerType plannerType : { PathPlannerType::JUMP_POINT_SEARCH, PathPlannerType::BIT_JUMP_POINT_SEARCH, PathPlannerType::JUMP_POINT_SEARCH_PLUS })
+	{
+		const char* plannerName = GetName(BENCHMARK_PLANNERS, plannerType);
+		fprintf(stderr, "%s: checking %s\n", map.name.c_str(), plannerName);
+
+		plannerData.type = plannerType;
+		auto planner = Pathfinder::CreatePathPlanner(plannerData, searchSpace);
+
+		size_t mismatches = 0;
+		for (size_t query = 0; query < queries.size(); query++)
+		{
+			double cost = FindPath(*searchSpace, *planner, queries[query].first, queries[query].second);
+			double referenceCost = referenceCosts[query];
+
+			// paths of the same cost only differ by the rounding of their moves
+			bool sameReachability = (cost < 0.0) == (referenceCost < 0.0);
+			if (!sameReachability || std::abs(cost - referenceCost) > 1e-3 * std::max(referenceCost, 1.0))
+			{
+				if (mismatches++ < 10)
+				{
+					auto& mapQuery = *mapQueries[query];
+					fprintf(stderr, "%s: %s mismatch from (%d, %d) to (%d, %d): cost %.4f, astar %.4f\n", map.name.c_str(), plannerName,
+						mapQuery.startX, mapQuery.startZ, mapQuery.goalX, mapQuery.goalZ, cost, referenceCost);
+				}
+			}
+		}
+
+		printf("{\"record\":\"equivalence\",\"map\":\"%s\",\"planner\":\"%s\",\"reference\":\"astar\",\"search_space\":\"%s\",\"queries\":%zu,\"mismatches\":%zu}\n",
+			Escape(map.name).c_str(), plannerName, searchSpaceName, queries.size(), mismatches);
+		fflush(stdout);
+
+		equivalent &= mismatches == 0;
+	}
+
+	return equivalent;
+}
+
+// Get check search space data (octile grid of the map)
+static SearchSpaceData GetCheckSearchSpaceData(const std::shared_ptr<GridMap>& gridMap)
+{
+	SearchSpaceData searchSpaceData;
+	searchSpaceData.searchSpaceType = SearchSpaceType::OCTILE_GRID;
+	searchSpaceData.anchorPosition = MathGeom::Vector3(0.0f, 0.0f, 0.0f);
+	searchSpaceData.worldSize = MathGeom::Vector3(float(gridMap->width), 1.0f, float(gridMap->height));
+	searchSpaceData.gridCellSize = 1.0f;
+	searchSpaceData.gridMap = gridMap;
+
+	return searchSpaceData;
+}
+
+// Get cell position
+static MathGeom::Vector3 GetCellPosition(int x, int z)
+{
+	return MathGeom::Vector3(x + 0.5f, 0.0f, z + 0.5f);
+}
+
+// Request path and wait (updates until the result of the request, PathNotFound if it never comes)
+static PathRequestResultStatus RequestPathAndWait(Pathfinder& pathfinder, const MathGeom::Vector3& start, const MathGeom::Vector3& goal)
+{
+	bool completed = false;
+	PathRequestResultStatus status = PathRequestResultStatus::PathNotFound;
+
+	PathRequestData requestData;
+	requestData.start = start;
+	requestData.goal = goal;
+	requestData.onPathRequestResult = [&](PathRequestId, PathRequestResultStatus resultStatus, Path&)
+	{
+		completed = resultStatus != PathRequestResultStatus::PathFound_Provisional;
+		status = resultStatus;
+	};
+
+	pathfinder.RequestPath(requestData);
+	for (int update = 0; update < 100000 && !completed; update++)
+	{
+		pathfinder.Update();
+	}
+
+	return status;
+}
+
+// Check cache after search space switch (the cache keeps working on a new grid with a lower version than the previous one)
+static bool CheckCacheAfterSearchSpaceSwitch()
+{
+	auto gridMap = std::make_shared<GridMap>();
+	gridMap->Init(64, 64, true);
+
+	PathfinderData data;
+	data.searchSpaceData = GetCheckSearchSpaceData(gridMap);
+	data.pathPlannerData.type = PathPlannerType::A_STAR;
+
+	Pathfinder pathfinder;
+	pathfinder.Init(data);
+
+	// cell changes raise the version of the first grid
+	for (int change = 0; change < 8; change++)
+	{
+		pathfinder.SetCellsWalkable({ GetCellPosition(32, 32) }, change % 2 == 1);
+	}
+
+	MathGeom::Vector3 start = GetCellPosition(1, 1);
+	MathGeom::Vector3 goal = GetCellPosition(60, 50);
+	RequestPathAndWait(pathfinder, start, goal);
+
+	pathfinder.SetSearchSpace(GetCheckSearchSpaceData(std::make_shared<GridMap>(*gridMap)));
+
+	PathRequestResultStatus firstStatus = RequestPathAndWait(pathfinder, start, goal);
+	size_t hits = pathfinder.GetPathCacheStats().hits;
+	PathRequestResultStatus secondStatus = RequestPathAndWait(pathfinder, start, goal);
+
+	return firstStatus == PathRequestResultStatus::PathFound && secondStatus == PathRequestResultStatus::PathFound
+		&& pathfinder.GetPathCacheStats().hits == hits + 1;
+}
+
+// Check callback cancels own request (the scheduler does not use a request, or its callback, once a callback cancelled it)
+static bool CheckCallbackCancelsOwnRequest()
+{
+	// Case
+	struct Case
+	{
+		PathPlannerType plannerType;
+		size_t workerCount;
+		bool keepUpdated;
+
+		// cancel on a provisional path (the final result otherwise)
+		bool cancelOnProvisional;
+	};
+
+	static const Case CASES[] =
+	{
+		{ PathPlannerType::A_STAR, 0, false, false },
+		{ PathPlannerType::A_STAR, 0, true, false },
+		{ PathPlannerType::ANYTIME_A_STAR, 0, false, true },
+		{ PathPlannerType::ANYTIME_A_STAR, 2, false, true },
+	};
+
+	auto gridMap = std::make_shared<GridMap>();
+	Random random(1);
+	GenerateRandomMap(*gridMap, 128, 0.2, random);
+	gridMap->SetWalkable(0, 0, true);
+	gridMap->SetWalkable(127, 127, true);
+
+	bool passed = true;
+	for (auto& checkCase : CASES)
+	{
+		PathfinderData data;
+		data.searchSpaceData = GetCheckSearchSpaceData(gridMap);
+		data.pathPlannerData.type = checkCase.plannerType;
+		data.pathPlannerData.maxRevolutions = 16;
+		data.pathRequestSchedulerData.workerCount = checkCase.workerCount;
+
+		Pathfinder pathfinder;
+		pathfinder.Init(data);
+
+		size_t results = 0;
+		bool cancelled = false;
+
+		PathRequestData requestData;
+		requestData.start = GetCellPosition(0, 0);
+		requestData.goal = GetCellPosition(127, 127);
+		requestData.keepUpdated = checkCase.keepUpdated;
+		requestData.onPathRequestResult = [&](PathRequestId requestId, PathRequestResultStatus resultStatus, Path&)
+		{
+			results++;
+			if (!checkCase.cancelOnProvisional || resultStatus == PathRequestResultStatus::PathFound_Provisional)
+			{
+				pathfinder.CancelRequest(requestId);
+				cancelled = true;
+			}
+		};
+
+		pathfinder.RequestPath(requestData);
+
+		// a few more updates once cancelled, no result may follow
+		for (int update = 0, updatesAfterCancel = 0; update < 100000 && updatesAfterCancel < 100; update++)
+		{
+			pathfinder.Update();
+			updatesAfterCancel += cancelled ? 1 : 0;
+
+			if (checkCase.workerCount > 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		passed &= cancelled && results == 1;
+	}
+
+	return passed;
+}
+
+// Check scheduler (regression checks of the path request scheduler, false on any failure)
+static bool CheckScheduler()
+{
+	// Check
+	struct Check
+	{
+		const char* name;
+		bool (*run)();
+	};
+
+	static const Check CHECKS[] =
+	{
+		{ "cache_after_search_space_switch", CheckCacheAfterSearchSpaceSwitch },
+		{ "callback_cancels_own_request", CheckCallbackCancelsOwnRequest },
+	};
+
+	bool passed = true;
+	for (auto& check : CHECKS)
+	{
+		fprintf(stderr, "checking %s\n", check.name);
+
+		bool checkPassed = check.run();
+		printf("{\"record\":\"check\",\"check\":\"%s\",\"passed\":%s}\n", check.name, checkPassed ? "true" : "false");
+		fflush(stdout);
+
+		passed &= checkPassed;
+	}
+
+	return passed;
+}
+
+// Run workers (the queries on worker pools of 1 to workerCount workers, throughput and speedup over one worker)
+static void RunWorkers(const BenchmarkOptions& options, const BenchmarkMap& map, const std::shared_ptr<SearchSpace>& searchSpace,
+	const PathPlannerData& plannerData, const std::vector<std::pair<PathNodeId, PathNodeId>>& queries)
+{
+	const char* plannerName = GetName(BENCHMARK_PLANNERS, plannerData.type);
+	const char* searchSpaceName = GetName(BENCHMARK_SEARCH_SPACES, options.searchSpaceType);
+
+	double singleWorkerTime = 0.0;
+	for (int workerCount = 1; workerCount <= options.workerCount; workerCount++)
+	{
+		std::vector<std::shared_ptr<PathPlanner>> planners;
+		for (int worker = 0; worker < workerCount; worker++)
+		{
+			planners.push_back(Pathfinder::CreatePathPlanner(plannerData, searchSpace));
+		}
+
+		PathPlannerWorkerPool workerPool;
+		workerPool.Start(planners);
+
+		auto runStart = Clock::now();
+		for (size_t query = 0; query < queries.size(); query++)
+		{
+			MathGeom::Vector3 start = searchSpace->GetNodePosition(queries[query].first);
+			MathGeom::Vector3 goal = searchSpace->GetNodePosition(queries[query].second);
+			workerPool.PushJob({ PathRequestId(query), queries[query].first, queries[query].second, start, goal });
+		}
+
+		// provisional results of anytime planners are not counted
+		size_t completed = 0;
+		size_t found = 0;
+		std::vector<PathPlannerWorkerPool::Result> results;
+		while (completed < queries.size())
+		{
+			workerPool.PopResults(results);
+			for (auto& result : results)
+			{
+				if (result.resultStatus != PathRequestResultStatus::PathFound_Provisional)
+				{
+					completed++;
+					found += result.resultStatus == PathRequestResultStatus::PathFound ? 1 : 0;
+				}
+			}
+
+			if (results.empty())
+			{
+				std::this_thread::yield();
+			}
+		}
+		double runTime = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+		workerPool.Stop();
+
+		if (workerCount == 1)
+		{
+			singleWorkerTime = runTime;
+		}
+
+		printf("{\"record\":\"workers\",\"map\":\"%s\",\"planner\":\"%s\",\"search_space\":\"%s\",\"workers\":%d,\"queries\":%zu,\"found\":%zu,"
+			"\"wall_ms\":%.3f,\"paths_per_s\":%.1f,\"speedup\":%.3f}\n",
+			Escape(map.name).c_str(), plannerName, searchSpaceName, workerCount, queries.size(), found,
+			runTime, runTime > 0.0 ? queries.size() * 1000.0 / runTime : 0.0, runTime > 0.0 ? singleWorkerTime / runTime : 0.0);
+		fflush(stdout);
+	}
+}
+
+// Run map
+static void RunMap(const BenchmarkOptions& options, const BenchmarkMap& map)
+{
+	const char* searchSpaceName = GetName(BENCHMARK_SEARCH_SPACES, options.searchSpaceType);
+
+	SearchSpaceData searchSpaceData = GetSearchSpaceData(options, map);
+	bool isLayered = options.searchSpaceType == SearchSpaceType::LAYERED_OCTILE_GRID;
+
+	auto buildStart = Clock::now();
+	auto searchSpace = Pathfinder::CreateSearchSpace(searchSpaceData);
+	double buildTime = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+	// tables of whole grids (the tiled grid has none)
+	auto grid = std::dynamic_pointer_cast<GridSearchSpace>(searchSpace);
+	auto tiledGrid = std::dynamic_pointer_cast<TiledNavGrid>(searchSpace);
+
+	// cell costs (the optimal lengths of the scenarios are not the shortest paths any more)
+	const CellCostTable* cellCosts = searchSpace->GetCellCosts();
+	bool hasCosts = cellCosts && cellCosts->HasCosts();
+
+	// queries on blocked cells (scenarios made for another map) are skipped, and queries of the layered grid end on
+	// every floor in turn (the optimal length of the map is only known on the first one)
+	std::vector<std::pair<PathNodeId, PathNodeId>> queries;
+	std::vector<double> optimalLengths;
+	for (size_t query = 0; query < map.queries.size(); query++)
+	{
+		auto& mapQuery = map.queries[query];
+		int goalLayer = isLayered ? int(query % size_t(options.layerCount)) : 0;
+		float goalHeight = isLayered ? goalLayer * searchSpaceData.layeredGridMap->layerHeight : 0.0f;
+
+		PathNodeId start = searchSpace->Localise(MathGeom::Vector3(mapQuery.startX + 0.5f, 0.0f, mapQuery.startZ + 0.5f));
+		PathNodeId goal = searchSpace->Localise(MathGeom::Vector3(mapQuery.goalX + 0.5f, goalHeight, mapQuery.goalZ + 0.5f));
+		if (searchSpace->IsWalkable(start) && searchSpace->IsWalkable(goal))
+		{
+			queries.emplace_back(start, goal);
+			optimalLengths.push_back(goalLayer == 0 && !hasCosts ? mapQuery.optimalLength : -1.0);
+		}
+	}
+
+	printf("{\"record\":\"map\",\"map\":\"%s\",\"width\":%zu,\"height\":%zu,\"walkable\":%zu,\"search_space\":\"%s\",\"build_ms\":%.3f,"
+		"\"components\":%zu,\"landmarks\":%zu,\"landmark_bytes\":%zu,\"costly_cells\":%zu,\"queries\":%zu,\"skipped_queries\":%zu}\n",
+		Escape(map.name).c_str(), map.gridMap->width, map.gridMap->height, map.gridMap->GetWalkableCount(), searchSpaceName, buildTime,
+		grid ? grid->GetComponents().GetComponentCount() : 0, grid ? grid->GetLandmarks().GetLandmarks().size() : 0,
+		grid ? grid->GetLandmarks().GetMemoryUsage() : 0, cellCosts ? cellCosts->GetCostlyCellCount() : 0,
+		queries.size(), map.queries.size() - queries.size());
+	fflush(stdout);
+
+	for (PathPlannerType plannerType : options.planners)
+	{
+		const char* plannerName = GetName(BENCHMARK_PLANNERS, plannerType);
+		if (plannerType == PathPlannerType::HIERARCHICAL_A_STAR && !std::dynamic_pointer_cast<HierarchicalNavGrid>(searchSpace))
+		{
+			fprintf(stderr, "%s: skipping %s, it needs the hierarchical search space\n", map.name.c_str(), plannerName);
+			continue;
+		}
+
+		bool needsGrid = plannerType == PathPlannerType::JUMP_POINT_SEARCH || plannerType == PathPlannerType::BIT_JUMP_POINT_SEARCH
+			|| plannerType == PathPlannerType::JUMP_POINT_SEARCH_PLUS || plannerType == PathPlannerType::LAZY_THETA_STAR;
+		if (needsGrid && !grid)
+		{
+			fprintf(stderr, "%s: skipping %s, it needs the tables of a whole grid\n", map.name.c_str(), plannerName);
+			continue;
+		}
+
+		fprintf(stderr, "%s: %s\n", map.name.c_str(), plannerName);
+
+		PathPlannerData plannerData;
+		plannerData.type = plannerType;
+		plannerData.maxRevolutions = options.maxRevolutions;
+		plannerData.heuristic = options.heuristic;
+		plannerData.heuristicWeight = options.heuristicWeight;
+		plannerData.anytimeInitialWeight = options.anytimeWeight;
+		auto planner = Pathfinder::CreatePathPlanner(plannerData, searchSpace);
+
+		std::vector<double> latencies;
+		std::vector<double> firstPathLatencies;
+		size_t found = 0;
+		size_t expansions = 0;
+		size_t revolutions = 0;
+		size_t slices = 0;
+		double pathLength = 0.0;
+		double pathCost = 0.0;
+		double optimalRatio = 0.0;
+		size_t optimalCount = 0;
+		size_t waypoints = 0;
+		double smoothedPathLength = 0.0;
+		double smoothingTime = 0.0;
+		PathSmoother pathSmoother;
+
+		auto runStart = Clock::now();
+		for (size_t query = 0; query < queries.size(); query++)
+		{
+			auto queryStart = Clock::now();
+
+			// time to the first path (a provisional one of an anytime planner, the final one of the others)
+			double firstPathLatency = -1.0;
+			Path improvedPath;
+
+			bool searchCompleted = planner->StartSearch(queries[query].first, queries[query].second);
+			slices++;
+			while (!searchCompleted)
+			{
+				if (firstPathLatency < 0.0 && planner->GetImprovedPath(improvedPath))
+				{
+					firstPathLatency = std::chrono::duration<double, std::micro>(Clock::now() - queryStart).count();
+				}
+
+				searchCompleted = planner->ResumeSearch();
+				slices++;
+			}
+
+			Path path;
+			planner->GetPath(path);
+
+			latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - queryStart).count());
+			firstPathLatencies.push_back(firstPathLatency < 0.0 ? latencies.back() : firstPathLatency);
+			expansions += planner->GetExpansions();
+			revolutions += planner->GetRevolutions();
+
+			if (!path.empty())
+			{
+				found++;
+
+				double length = 0.0;
+				for (size_t i = 1; i < path.size(); i++)
+				{
+					length += MathGeom::Distance(path[i - 1], path[i]);
+				}
+				pathLength += length;
+
+				// cost (the length of the moves scaled by the cell costs at their ends, any-angle segments included)
+				double cost = length;
+				if (hasCosts)
+				{
+					cost = 0.0;
+					for (size_t i = 1; i < path.size(); i++)
+					{
+						PathNodeId from = searchSpace->Localise(path[i - 1]);
+						PathNodeId to = searchSpace->Localise(path[i]);
+						cost += MathGeom::Distance(path[i - 1], path[i]) * cellCosts->GetMoveMultiplier(from, to);
+					}
+				}
+				pathCost += cost;
+
+				if (optimalLengths[query] > 0.0)
+				{
+					optimalRatio += length / optimalLengths[query];
+					optimalCount++;
+				}
+
+				auto smoothingStart = Clock::now();
+				if (grid)
+				{
+					pathSmoother.Smooth(*grid, options.smoothing, path);
+				}
+				smoothingTime += std::chrono::duration<double, std::micro>(Clock::now() - smoothingStart).count();
+
+				waypoints += path.size();
+				for (size_t i = 1; i < path.size(); i++)
+				{
+					smoothedPathLength += MathGeom::Distance(path[i - 1], path[i]);
+				}
+			}
+		}
+		double runTime = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+		double latencyTotal = 0.0;
+		for (double latency : latencies)
+		{
+			latencyTotal += latency;
+		}
+		std::sort(latencies.begin(), latencies.end());
+
+		double firstPathLatencyTotal = 0.0;
+		for (double latency : firstPathLatencies)
+		{
+			firstPathLatencyTotal += latency;
+		}
+		std::sort(firstPathLatencies.begin(), firstPathLatencies.end());
+
+		double count = double(std::max(queries.size(), size_t(1)));
+		char optimalRatioText[32] = "null";
+		if (optimalCount > 0)
+		{
+			snprintf(optimalRatioText, sizeof(optimalRatioText), "%.4f", optimalRatio / optimalCount);
+		}
+
+		printf("{\"record\":\"scenario\",\"map\":\"%s\",\"planner\":\"%s\",\"search_space\":\"%s\",\"max_revolutions\":%d,\"queries\":%zu,\"found\":%zu,"
+			"\"wall_ms\":%.3f,\"latency_us\":{\"mean\":%.2f,\"p50\":%.2f,\"p99\":%.2f,\"max\":%.2f},"
+			"\"first_path_us\":{\"mean\":%.2f,\"p50\":%.2f,\"p99\":%.2f},"
+			"\"expansions\":{\"total\":%zu,\"mean\":%.1f},\"revolutions\":{\"total\":%zu,\"mean\":%.1f},\"slices_mean\":%.2f,"
+			"\"path_length_mean\":%.3f,\"path_cost_mean\":%.3f,\"optimal_ratio_mean\":%s,"
+			"\"smoothing\":\"%s\",\"waypoints_mean\":%.2f,\"smoothed_length_mean\":%.3f,\"smoothing_us_mean\":%.2f}\n",
+			Escape(map.name).c_str(), plannerName, searchSpaceName, options.maxRevolutions, queries.size(), found,
+			runTime, latencyTotal / count, GetPercentile(latencies, 0.5), GetPercentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back(),
+			firstPathLatencyTotal / count, GetPercentile(firstPathLatencies, 0.5), GetPercentile(firstPathLatencies, 0.99),
+			expansions, expansions / count, revolutions, revolutions / count, slices / count,
+			found > 0 ? pathLength / found : 0.0, found > 0 ? pathCost / found : 0.0, optimalRatioText,
+			GetName(BENCHMARK_SMOOTHINGS, options.smoothing), found > 0 ? double(waypoints) / found : 0.0,
+			found > 0 ? smoothedPathLength / found : 0.0, found > 0 ? smoothingTime / found : 0.0);
+		fflush(stdout);
+
+		// searches load the nodes of search spaces loaded on demand, so they do not run on workers
+		if (options.workerCount > 0 && !searchSpace->IsLoadedOnDemand())
+		{
+			RunWorkers(options, map, searchSpace, plannerData, queries);
+		}
+	}
+
+	// tiles loaded by all the planners of the map
+	if (tiledGrid)
+	{
+		printf("{\"record\":\"tiles\",\"map\":\"%s\",\"tile_size\":%d,\"tile_budget\":%zu,\"loaded\":%zu,\"loads\":%zu,\"evictions\":%zu,\"memory_bytes\":%zu}\n",
+			Escape(map.name).c_str(), tiledGrid->GetTileSize(), tiledGrid->GetMaxLoadedTiles(), tiledGrid->GetLoadedTileCount(),
+			tiledGrid->GetTileLoadCount(), tiledGrid->GetTileEvictionCount(), tiledGrid->GetMemoryUsage());
+		fflush(stdout);
+	}
+}
+
+// Parse options
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		// the only options without a value
+		if (option == "--check-equivalence")
+		{
+			options.checkEquivalence = true;
+			continue;
+		}
+
+		if (option == "--check-scheduler")
+		{
+			options.checkScheduler = true;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "missing value for %s\n", option.c_str());
+			return false;
+		}
+
+		std::string value = argv[++i];
+		if (option == "--generate")
+		{
+			options.generators.push_back(value);
+		}
+		else if (option == "--map")
+		{
+			options.mapFiles.emplace_back(value, "");
+		}
+		else if (option == "--scen")
+		{
+			if (options.mapFiles.empty())
+			{
+				fprintf(stderr, "--scen needs a --map before it\n");
+				return false;
+			}
+			options.mapFiles.back().second = value;
+		}
+		else if (option == "--queries")
+		{
+			options.queryCount = size_t(atoi(value.c_str()));
+		}
+		else if (option == "--seed")
+		{
+			options.seed = uint32_t(strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (option == "--planner")
+		{
+			auto planner = std::find_if(std::begin(BENCHMARK_PLANNERS), std::end(BENCHMARK_PLANNERS), [&](const BenchmarkPlanner& entry) { return value == entry.name; });
+			if (planner == std::end(BENCHMARK_PLANNERS))
+			{
+				fprintf(stderr, "unknown planner: %s\n", value.c_str());
+				return false;
+			}
+			options.planners.push_back(planner->type);
+		}
+		else if (option == "--search-space")
+		{
+			auto searchSpace = std::find_if(std::begin(BENCHMARK_SEARCH_SPACES), std::end(BENCHMARK_SEARCH_SPACES), [&](const BenchmarkSearchSpace& entry) { return value == entry.name; });
+			if (searchSpace == std::end(BENCHMARK_SEARCH_SPACES))
+			{
+				fprintf(stderr, "unknown search space: %s\n", value.c_str());
+				return false;
+			}
+			options.searchSpaceType = searchSpace->type;
+		}
+		else if (option == "--max-revolutions")
+		{
+			options.maxRevolutions = std::max(atoi(value.c_str()), 1);
+		}
+		else if (option == "--heuristic")
+		{
+			auto heuristic = std::find_if(std::begin(BENCHMARK_HEURISTICS), std::end(BENCHMARK_HEURISTICS), [&](const BenchmarkHeuristic& entry) { return value == entry.name; });
+			if (heuristic == std::end(BENCHMARK_HEURISTICS))
+			{
+				fprintf(stderr, "unknown heuristic: %s\n", value.c_str());
+				return false;
+			}
+			options.heuristic = heuristic->heuristic;
+		}
+		else if (option == "--heuristic-weight")
+		{
+			options.heuristicWeight = std::max(float(atof(value.c_str())), 1.0f);
+		}
+		else if (option == "--anytime-weight")
+		{
+			options.anytimeWeight = std::max(float(atof(value.c_str())), 1.0f);
+		}
+		else if (option == "--smoothing")
+		{
+			auto smoothing = std::find_if(std::begin(BENCHMARK_SMOOTHINGS), std::end(BENCHMARK_SMOOTHINGS), [&](const BenchmarkSmoothing& entry) { return value == entry.name; });
+			if (smoothing == std::end(BENCHMARK_SMOOTHINGS))
+			{
+				fprintf(stderr, "unknown smoothing: %s\n", value.c_str());
+				return false;
+			}
+			options.smoothing = smoothing->type;
+		}
+		else if (option == "--landmarks")
+		{
+			options.landmarkCount = std::max(atoi(value.c_str()), 0);
+		}
+		else if (option == "--cluster-size")
+		{
+			options.clusterSize = std::max(atoi(value.c_str()), 1);
+		}
+		else if (option == "--tile-size")
+		{
+			options.tileSize = std::max(atoi(value.c_str()), 1);
+		}
+		else if (option == "--tile-budget")
+		{
+			options.tileBudget = size_t(std::max(atoi(value.c_str()), 1));
+		}
+		else if (option == "--layers")
+		{
+			options.layerCount = std::max(atoi(value.c_str()), 1);
+		}
+		else if (option == "--layer-links")
+		{
+			options.layerLinkCount = std::max(atoi(value.c_str()), 1);
+		}
+		else if (option == "--mud")
+		{
+			size_t separator = value.find(':');
+			options.mudRatio = std::min(std::max(atof(value.substr(0, separator).c_str()), 0.0), 1.0);
+			if (separator != std::string::npos)
+			{
+				options.mudCost = uint8_t(std::min(std::max(atoi(value.substr(separator + 1).c_str()), 0), 255));
+			}
+		}
+		else if (option == "--workers")
+		{
+			options.workerCount = std::max(atoi(value.c_str()), 0);
+		}
+		else
+		{
+			fprintf(stderr, "unknown option: %s\n", option.c_str());
+			return false;
+		}
+	}
+
+	if (options.generators.empty() && options.mapFiles.empty())
+	{
+		options.generators = { "random:256", "rooms:256", "maze:255" };
+	}
+
+	if (options.landmarkCount < 0)
+	{
+		options.landmarkCount = options.heuristic == PathPlannerHeuristic::LANDMARK ? 8 : 0;
+	}
+
+	if (options.planners.empty())
+	{
+		for (auto& planner : BENCHMARK_PLANNERS)
+		{
+			options.planners.push_back(planner.type);
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	if (options.checkScheduler)
+	{
+		return CheckScheduler() ? 0 : 1;
+	}
+
+	std::vector<BenchmarkMap> maps;
+	if (!CreateMaps(options, maps))
+	{
+		return 1;
+	}
+
+	// mud has its own generator, so the maps and their queries do not change with it
+	if (options.mudRatio > 0.0)
+	{
+		Random random(options.seed);
+		for (auto& map : maps)
+		{
+			GenerateMud(*map.gridMap, options.mudRatio, options.mudCost, random);
+		}
+	}
+
+	if (options.checkEquivalence)
+	{
+		bool equivalent = true;
+		for (auto& map : maps)
+		{
+			equivalent &= CheckEquivalence(options, map);
+		}
+
+		return equivalent ? 0 : 1;
+	}
+
+	for (auto& map : maps)
+	{
+		RunMap(options, map);
+	}
+
+	return 0;
+}